@@ -0,0 +1,165 @@
+#include "baudrate.h"
+
+#include <stddef.h>
+
+
+/* The frequency of all UART cores is 100MHz. */
+#define BAUDRATE_DEVICE_FREQUENCY 100000000ULL
+
+/* Get the baud rate divider.
+ *
+ * From the regdef:
+ *   ( (Baud Rate * 16) / System Frequency ) * 2^16
+ *
+ * = BaudRate * 16 * 65536 / SystemFrequency
+ *
+ * The division is rounded to the next integer.
+ */
+#define BAUDRATE_DIVIDER(rate) ((((unsigned long long)(rate) * 16ULL * 65536ULL) + (BAUDRATE_DEVICE_FREQUENCY / 2ULL)) / BAUDRATE_DEVICE_FREQUENCY)
+
+/* The real baud rate of a divider. The division by 16 * 2^16 is a shift. */
+#define BAUDRATE_ACHIEVED(div) ((unsigned long)((((unsigned long long)(div) * BAUDRATE_DEVICE_FREQUENCY) + (1ULL << 19U)) >> 20U))
+
+/* The deviation of the real baud rate in ppm. The real baud rate is
+ * calculated with 6 more decimal places to get the full resolution.
+ */
+#define BAUDRATE_ERROR_PPM(rate, div) ((long)(((long long)(((unsigned long long)(div) * BAUDRATE_DEVICE_FREQUENCY * 1000000ULL) >> 20U) - ((long long)(rate) * 1000000LL)) / (long long)(rate)))
+
+#define BAUDRATE_ENTRY(rate) { (rate), { (unsigned long)BAUDRATE_DIVIDER(rate), BAUDRATE_ACHIEVED(BAUDRATE_DIVIDER(rate)), BAUDRATE_ERROR_PPM(rate, BAUDRATE_DIVIDER(rate)) } }
+
+
+/* The UART module has only 16bits for the divider. */
+#define BAUDRATE_DIVIDER_MAX 0xffffU
+
+
+typedef struct BAUDRATE_TABLE_ENTRY_STRUCT
+{
+	unsigned long ulBaudRate;
+	BAUDRATE_SETTING_T tSetting;
+} BAUDRATE_TABLE_ENTRY_T;
+
+
+/* The settings for the standard baud rates are calculated by the compiler.
+ * Only other baud rates need the 64 bit division at runtime.
+ */
+static const BAUDRATE_TABLE_ENTRY_T atBaudRateTable[] =
+{
+	BAUDRATE_ENTRY(1200),
+	BAUDRATE_ENTRY(2400),
+	BAUDRATE_ENTRY(4800),
+	BAUDRATE_ENTRY(9600),
+	BAUDRATE_ENTRY(14400),
+	BAUDRATE_ENTRY(19200),
+	BAUDRATE_ENTRY(28800),
+	BAUDRATE_ENTRY(38400),
+	BAUDRATE_ENTRY(57600),
+	BAUDRATE_ENTRY(76800),
+	BAUDRATE_ENTRY(115200),
+	BAUDRATE_ENTRY(230400),
+	BAUDRATE_ENTRY(250000),
+	BAUDRATE_ENTRY(460800),
+	BAUDRATE_ENTRY(500000),
+	BAUDRATE_ENTRY(921600),
+	BAUDRATE_ENTRY(1000000),
+	BAUDRATE_ENTRY(1500000),
+	BAUDRATE_ENTRY(2000000),
+	BAUDRATE_ENTRY(3000000),
+	BAUDRATE_ENTRY(4000000),
+	BAUDRATE_ENTRY(6000000)
+};
+
+
+
+int baudrate_get_setting(unsigned long ulBaudRate, BAUDRATE_SETTING_T *ptSetting)
+{
+	int iResult;
+	const BAUDRATE_TABLE_ENTRY_T *ptCnt;
+	const BAUDRATE_TABLE_ENTRY_T *ptEnd;
+	const BAUDRATE_TABLE_ENTRY_T *ptHit;
+	unsigned long long ullDiv;
+
+
+	/* Look for the baud rate in the table. */
+	ptHit = NULL;
+	ptCnt = atBaudRateTable;
+	ptEnd = atBaudRateTable + (sizeof(atBaudRateTable)/sizeof(atBaudRateTable[0]));
+	while( ptHit==NULL && ptCnt<ptEnd )
+	{
+		if( ptCnt->ulBaudRate==ulBaudRate )
+		{
+			ptHit = ptCnt;
+		}
+		++ptCnt;
+	}
+
+	if( ptHit!=NULL )
+	{
+		*ptSetting = ptHit->tSetting;
+		iResult = 0;
+	}
+	else
+	{
+		/* A divider of 0 stops the UART. */
+		ullDiv = BAUDRATE_DIVIDER(ulBaudRate);
+		if( ullDiv==0 || ullDiv>BAUDRATE_DIVIDER_MAX )
+		{
+			iResult = -1;
+		}
+		else
+		{
+			ptSetting->ulDivider = (unsigned long)ullDiv;
+			ptSetting->ulAchievedBaudRate = BAUDRATE_ACHIEVED(ullDiv);
+			ptSetting->lErrorPpm = BAUDRATE_ERROR_PPM(ulBaudRate, ullDiv);
+			iResult = 0;
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Find the standard baud rate which is closest to a measured baud rate.
+ * This returns 0 if no standard baud rate is within ulMaxDeviationPpm.
+ */
+unsigned long baudrate_get_standard(unsigned long ulBaudRate, unsigned long ulMaxDeviationPpm)
+{
+	const BAUDRATE_TABLE_ENTRY_T *ptCnt;
+	const BAUDRATE_TABLE_ENTRY_T *ptEnd;
+	unsigned long ulStandard;
+	unsigned long ulBest;
+	unsigned long ulBestDeviation;
+	unsigned long ulDeviation;
+
+
+	ulBest = 0;
+	ulBestDeviation = 0xffffffffU;
+	ptCnt = atBaudRateTable;
+	ptEnd = atBaudRateTable + (sizeof(atBaudRateTable)/sizeof(atBaudRateTable[0]));
+	while( ptCnt<ptEnd )
+	{
+		ulStandard = ptCnt->ulBaudRate;
+		if( ulStandard<ulBaudRate )
+		{
+			ulDeviation = ulBaudRate - ulStandard;
+		}
+		else
+		{
+			ulDeviation = ulStandard - ulBaudRate;
+		}
+		if( ulDeviation<ulBestDeviation )
+		{
+			ulBest = ulStandard;
+			ulBestDeviation = ulDeviation;
+		}
+		++ptCnt;
+	}
+
+	/* Compare the deviation in ppm without a division. */
+	if( ((unsigned long long)ulBestDeviation * 1000000ULL)>((unsigned long long)ulBest * ulMaxDeviationPpm) )
+	{
+		ulBest = 0;
+	}
+
+	return ulBest;
+}
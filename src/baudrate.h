@@ -0,0 +1,20 @@
+#ifndef __BAUDRATE_H__
+#define __BAUDRATE_H__
+
+
+/* The divider for a baud rate and the deviation of the real baud rate from
+ * the requested one.
+ */
+typedef struct BAUDRATE_SETTING_STRUCT
+{
+	unsigned long ulDivider;
+	unsigned long ulAchievedBaudRate;
+	long lErrorPpm;
+} BAUDRATE_SETTING_T;
+
+
+int baudrate_get_setting(unsigned long ulBaudRate, BAUDRATE_SETTING_T *ptSetting);
+unsigned long baudrate_get_standard(unsigned long ulBaudRate, unsigned long ulMaxDeviationPpm);
+
+
+#endif  /* __BAUDRATE_H__ */
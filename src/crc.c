@@ -0,0 +1,232 @@
+#include "crc.h"
+
+
+
+static const unsigned short ausCrcTableModbus[256] =
+{
+	0x0000U, 0xc0c1U, 0xc181U, 0x0140U, 0xc301U, 0x03c0U, 0x0280U, 0xc241U,
+	0xc601U, 0x06c0U, 0x0780U, 0xc741U, 0x0500U, 0xc5c1U, 0xc481U, 0x0440U,
+	0xcc01U, 0x0cc0U, 0x0d80U, 0xcd41U, 0x0f00U, 0xcfc1U, 0xce81U, 0x0e40U,
+	0x0a00U, 0xcac1U, 0xcb81U, 0x0b40U, 0xc901U, 0x09c0U, 0x0880U, 0xc841U,
+	0xd801U, 0x18c0U, 0x1980U, 0xd941U, 0x1b00U, 0xdbc1U, 0xda81U, 0x1a40U,
+	0x1e00U, 0xdec1U, 0xdf81U, 0x1f40U, 0xdd01U, 0x1dc0U, 0x1c80U, 0xdc41U,
+	0x1400U, 0xd4c1U, 0xd581U, 0x1540U, 0xd701U, 0x17c0U, 0x1680U, 0xd641U,
+	0xd201U, 0x12c0U, 0x1380U, 0xd341U, 0x1100U, 0xd1c1U, 0xd081U, 0x1040U,
+	0xf001U, 0x30c0U, 0x3180U, 0xf141U, 0x3300U, 0xf3c1U, 0xf281U, 0x3240U,
+	0x3600U, 0xf6c1U, 0xf781U, 0x3740U, 0xf501U, 0x35c0U, 0x3480U, 0xf441U,
+	0x3c00U, 0xfcc1U, 0xfd81U, 0x3d40U, 0xff01U, 0x3fc0U, 0x3e80U, 0xfe41U,
+	0xfa01U, 0x3ac0U, 0x3b80U, 0xfb41U, 0x3900U, 0xf9c1U, 0xf881U, 0x3840U,
+	0x2800U, 0xe8c1U, 0xe981U, 0x2940U, 0xeb01U, 0x2bc0U, 0x2a80U, 0xea41U,
+	0xee01U, 0x2ec0U, 0x2f80U, 0xef41U, 0x2d00U, 0xedc1U, 0xec81U, 0x2c40U,
+	0xe401U, 0x24c0U, 0x2580U, 0xe541U, 0x2700U, 0xe7c1U, 0xe681U, 0x2640U,
+	0x2200U, 0xe2c1U, 0xe381U, 0x2340U, 0xe101U, 0x21c0U, 0x2080U, 0xe041U,
+	0xa001U, 0x60c0U, 0x6180U, 0xa141U, 0x6300U, 0xa3c1U, 0xa281U, 0x6240U,
+	0x6600U, 0xa6c1U, 0xa781U, 0x6740U, 0xa501U, 0x65c0U, 0x6480U, 0xa441U,
+	0x6c00U, 0xacc1U, 0xad81U, 0x6d40U, 0xaf01U, 0x6fc0U, 0x6e80U, 0xae41U,
+	0xaa01U, 0x6ac0U, 0x6b80U, 0xab41U, 0x6900U, 0xa9c1U, 0xa881U, 0x6840U,
+	0x7800U, 0xb8c1U, 0xb981U, 0x7940U, 0xbb01U, 0x7bc0U, 0x7a80U, 0xba41U,
+	0xbe01U, 0x7ec0U, 0x7f80U, 0xbf41U, 0x7d00U, 0xbdc1U, 0xbc81U, 0x7c40U,
+	0xb401U, 0x74c0U, 0x7580U, 0xb541U, 0x7700U, 0xb7c1U, 0xb681U, 0x7640U,
+	0x7200U, 0xb2c1U, 0xb381U, 0x7340U, 0xb101U, 0x71c0U, 0x7080U, 0xb041U,
+	0x5000U, 0x90c1U, 0x9181U, 0x5140U, 0x9301U, 0x53c0U, 0x5280U, 0x9241U,
+	0x9601U, 0x56c0U, 0x5780U, 0x9741U, 0x5500U, 0x95c1U, 0x9481U, 0x5440U,
+	0x9c01U, 0x5cc0U, 0x5d80U, 0x9d41U, 0x5f00U, 0x9fc1U, 0x9e81U, 0x5e40U,
+	0x5a00U, 0x9ac1U, 0x9b81U, 0x5b40U, 0x9901U, 0x59c0U, 0x5880U, 0x9841U,
+	0x8801U, 0x48c0U, 0x4980U, 0x8941U, 0x4b00U, 0x8bc1U, 0x8a81U, 0x4a40U,
+	0x4e00U, 0x8ec1U, 0x8f81U, 0x4f40U, 0x8d01U, 0x4dc0U, 0x4c80U, 0x8c41U,
+	0x4400U, 0x84c1U, 0x8581U, 0x4540U, 0x8701U, 0x47c0U, 0x4680U, 0x8641U,
+	0x8201U, 0x42c0U, 0x4380U, 0x8341U, 0x4100U, 0x81c1U, 0x8081U, 0x4040U
+};
+
+
+
+static const unsigned short ausCrcTableCcitt[256] =
+{
+	0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50a5U, 0x60c6U, 0x70e7U,
+	0x8108U, 0x9129U, 0xa14aU, 0xb16bU, 0xc18cU, 0xd1adU, 0xe1ceU, 0xf1efU,
+	0x1231U, 0x0210U, 0x3273U, 0x2252U, 0x52b5U, 0x4294U, 0x72f7U, 0x62d6U,
+	0x9339U, 0x8318U, 0xb37bU, 0xa35aU, 0xd3bdU, 0xc39cU, 0xf3ffU, 0xe3deU,
+	0x2462U, 0x3443U, 0x0420U, 0x1401U, 0x64e6U, 0x74c7U, 0x44a4U, 0x5485U,
+	0xa56aU, 0xb54bU, 0x8528U, 0x9509U, 0xe5eeU, 0xf5cfU, 0xc5acU, 0xd58dU,
+	0x3653U, 0x2672U, 0x1611U, 0x0630U, 0x76d7U, 0x66f6U, 0x5695U, 0x46b4U,
+	0xb75bU, 0xa77aU, 0x9719U, 0x8738U, 0xf7dfU, 0xe7feU, 0xd79dU, 0xc7bcU,
+	0x48c4U, 0x58e5U, 0x6886U, 0x78a7U, 0x0840U, 0x1861U, 0x2802U, 0x3823U,
+	0xc9ccU, 0xd9edU, 0xe98eU, 0xf9afU, 0x8948U, 0x9969U, 0xa90aU, 0xb92bU,
+	0x5af5U, 0x4ad4U, 0x7ab7U, 0x6a96U, 0x1a71U, 0x0a50U, 0x3a33U, 0x2a12U,
+	0xdbfdU, 0xcbdcU, 0xfbbfU, 0xeb9eU, 0x9b79U, 0x8b58U, 0xbb3bU, 0xab1aU,
+	0x6ca6U, 0x7c87U, 0x4ce4U, 0x5cc5U, 0x2c22U, 0x3c03U, 0x0c60U, 0x1c41U,
+	0xedaeU, 0xfd8fU, 0xcdecU, 0xddcdU, 0xad2aU, 0xbd0bU, 0x8d68U, 0x9d49U,
+	0x7e97U, 0x6eb6U, 0x5ed5U, 0x4ef4U, 0x3e13U, 0x2e32U, 0x1e51U, 0x0e70U,
+	0xff9fU, 0xefbeU, 0xdfddU, 0xcffcU, 0xbf1bU, 0xaf3aU, 0x9f59U, 0x8f78U,
+	0x9188U, 0x81a9U, 0xb1caU, 0xa1ebU, 0xd10cU, 0xc12dU, 0xf14eU, 0xe16fU,
+	0x1080U, 0x00a1U, 0x30c2U, 0x20e3U, 0x5004U, 0x4025U, 0x7046U, 0x6067U,
+	0x83b9U, 0x9398U, 0xa3fbU, 0xb3daU, 0xc33dU, 0xd31cU, 0xe37fU, 0xf35eU,
+	0x02b1U, 0x1290U, 0x22f3U, 0x32d2U, 0x4235U, 0x5214U, 0x6277U, 0x7256U,
+	0xb5eaU, 0xa5cbU, 0x95a8U, 0x8589U, 0xf56eU, 0xe54fU, 0xd52cU, 0xc50dU,
+	0x34e2U, 0x24c3U, 0x14a0U, 0x0481U, 0x7466U, 0x6447U, 0x5424U, 0x4405U,
+	0xa7dbU, 0xb7faU, 0x8799U, 0x97b8U, 0xe75fU, 0xf77eU, 0xc71dU, 0xd73cU,
+	0x26d3U, 0x36f2U, 0x0691U, 0x16b0U, 0x6657U, 0x7676U, 0x4615U, 0x5634U,
+	0xd94cU, 0xc96dU, 0xf90eU, 0xe92fU, 0x99c8U, 0x89e9U, 0xb98aU, 0xa9abU,
+	0x5844U, 0x4865U, 0x7806U, 0x6827U, 0x18c0U, 0x08e1U, 0x3882U, 0x28a3U,
+	0xcb7dU, 0xdb5cU, 0xeb3fU, 0xfb1eU, 0x8bf9U, 0x9bd8U, 0xabbbU, 0xbb9aU,
+	0x4a75U, 0x5a54U, 0x6a37U, 0x7a16U, 0x0af1U, 0x1ad0U, 0x2ab3U, 0x3a92U,
+	0xfd2eU, 0xed0fU, 0xdd6cU, 0xcd4dU, 0xbdaaU, 0xad8bU, 0x9de8U, 0x8dc9U,
+	0x7c26U, 0x6c07U, 0x5c64U, 0x4c45U, 0x3ca2U, 0x2c83U, 0x1ce0U, 0x0cc1U,
+	0xef1fU, 0xff3eU, 0xcf5dU, 0xdf7cU, 0xaf9bU, 0xbfbaU, 0x8fd9U, 0x9ff8U,
+	0x6e17U, 0x7e36U, 0x4e55U, 0x5e74U, 0x2e93U, 0x3eb2U, 0x0ed1U, 0x1ef0U
+};
+
+
+
+static const unsigned long aulCrcTableCrc32[256] =
+{
+	0x00000000U, 0x77073096U, 0xee0e612cU, 0x990951baU, 0x076dc419U, 0x706af48fU, 0xe963a535U, 0x9e6495a3U,
+	0x0edb8832U, 0x79dcb8a4U, 0xe0d5e91eU, 0x97d2d988U, 0x09b64c2bU, 0x7eb17cbdU, 0xe7b82d07U, 0x90bf1d91U,
+	0x1db71064U, 0x6ab020f2U, 0xf3b97148U, 0x84be41deU, 0x1adad47dU, 0x6ddde4ebU, 0xf4d4b551U, 0x83d385c7U,
+	0x136c9856U, 0x646ba8c0U, 0xfd62f97aU, 0x8a65c9ecU, 0x14015c4fU, 0x63066cd9U, 0xfa0f3d63U, 0x8d080df5U,
+	0x3b6e20c8U, 0x4c69105eU, 0xd56041e4U, 0xa2677172U, 0x3c03e4d1U, 0x4b04d447U, 0xd20d85fdU, 0xa50ab56bU,
+	0x35b5a8faU, 0x42b2986cU, 0xdbbbc9d6U, 0xacbcf940U, 0x32d86ce3U, 0x45df5c75U, 0xdcd60dcfU, 0xabd13d59U,
+	0x26d930acU, 0x51de003aU, 0xc8d75180U, 0xbfd06116U, 0x21b4f4b5U, 0x56b3c423U, 0xcfba9599U, 0xb8bda50fU,
+	0x2802b89eU, 0x5f058808U, 0xc60cd9b2U, 0xb10be924U, 0x2f6f7c87U, 0x58684c11U, 0xc1611dabU, 0xb6662d3dU,
+	0x76dc4190U, 0x01db7106U, 0x98d220bcU, 0xefd5102aU, 0x71b18589U, 0x06b6b51fU, 0x9fbfe4a5U, 0xe8b8d433U,
+	0x7807c9a2U, 0x0f00f934U, 0x9609a88eU, 0xe10e9818U, 0x7f6a0dbbU, 0x086d3d2dU, 0x91646c97U, 0xe6635c01U,
+	0x6b6b51f4U, 0x1c6c6162U, 0x856530d8U, 0xf262004eU, 0x6c0695edU, 0x1b01a57bU, 0x8208f4c1U, 0xf50fc457U,
+	0x65b0d9c6U, 0x12b7e950U, 0x8bbeb8eaU, 0xfcb9887cU, 0x62dd1ddfU, 0x15da2d49U, 0x8cd37cf3U, 0xfbd44c65U,
+	0x4db26158U, 0x3ab551ceU, 0xa3bc0074U, 0xd4bb30e2U, 0x4adfa541U, 0x3dd895d7U, 0xa4d1c46dU, 0xd3d6f4fbU,
+	0x4369e96aU, 0x346ed9fcU, 0xad678846U, 0xda60b8d0U, 0x44042d73U, 0x33031de5U, 0xaa0a4c5fU, 0xdd0d7cc9U,
+	0x5005713cU, 0x270241aaU, 0xbe0b1010U, 0xc90c2086U, 0x5768b525U, 0x206f85b3U, 0xb966d409U, 0xce61e49fU,
+	0x5edef90eU, 0x29d9c998U, 0xb0d09822U, 0xc7d7a8b4U, 0x59b33d17U, 0x2eb40d81U, 0xb7bd5c3bU, 0xc0ba6cadU,
+	0xedb88320U, 0x9abfb3b6U, 0x03b6e20cU, 0x74b1d29aU, 0xead54739U, 0x9dd277afU, 0x04db2615U, 0x73dc1683U,
+	0xe3630b12U, 0x94643b84U, 0x0d6d6a3eU, 0x7a6a5aa8U, 0xe40ecf0bU, 0x9309ff9dU, 0x0a00ae27U, 0x7d079eb1U,
+	0xf00f9344U, 0x8708a3d2U, 0x1e01f268U, 0x6906c2feU, 0xf762575dU, 0x806567cbU, 0x196c3671U, 0x6e6b06e7U,
+	0xfed41b76U, 0x89d32be0U, 0x10da7a5aU, 0x67dd4accU, 0xf9b9df6fU, 0x8ebeeff9U, 0x17b7be43U, 0x60b08ed5U,
+	0xd6d6a3e8U, 0xa1d1937eU, 0x38d8c2c4U, 0x4fdff252U, 0xd1bb67f1U, 0xa6bc5767U, 0x3fb506ddU, 0x48b2364bU,
+	0xd80d2bdaU, 0xaf0a1b4cU, 0x36034af6U, 0x41047a60U, 0xdf60efc3U, 0xa867df55U, 0x316e8eefU, 0x4669be79U,
+	0xcb61b38cU, 0xbc66831aU, 0x256fd2a0U, 0x5268e236U, 0xcc0c7795U, 0xbb0b4703U, 0x220216b9U, 0x5505262fU,
+	0xc5ba3bbeU, 0xb2bd0b28U, 0x2bb45a92U, 0x5cb36a04U, 0xc2d7ffa7U, 0xb5d0cf31U, 0x2cd99e8bU, 0x5bdeae1dU,
+	0x9b64c2b0U, 0xec63f226U, 0x756aa39cU, 0x026d930aU, 0x9c0906a9U, 0xeb0e363fU, 0x72076785U, 0x05005713U,
+	0x95bf4a82U, 0xe2b87a14U, 0x7bb12baeU, 0x0cb61b38U, 0x92d28e9bU, 0xe5d5be0dU, 0x7cdcefb7U, 0x0bdbdf21U,
+	0x86d3d2d4U, 0xf1d4e242U, 0x68ddb3f8U, 0x1fda836eU, 0x81be16cdU, 0xf6b9265bU, 0x6fb077e1U, 0x18b74777U,
+	0x88085ae6U, 0xff0f6a70U, 0x66063bcaU, 0x11010b5cU, 0x8f659effU, 0xf862ae69U, 0x616bffd3U, 0x166ccf45U,
+	0xa00ae278U, 0xd70dd2eeU, 0x4e048354U, 0x3903b3c2U, 0xa7672661U, 0xd06016f7U, 0x4969474dU, 0x3e6e77dbU,
+	0xaed16a4aU, 0xd9d65adcU, 0x40df0b66U, 0x37d83bf0U, 0xa9bcae53U, 0xdebb9ec5U, 0x47b2cf7fU, 0x30b5ffe9U,
+	0xbdbdf21cU, 0xcabac28aU, 0x53b39330U, 0x24b4a3a6U, 0xbad03605U, 0xcdd70693U, 0x54de5729U, 0x23d967bfU,
+	0xb3667a2eU, 0xc4614ab8U, 0x5d681b02U, 0x2a6f2b94U, 0xb40bbe37U, 0xc30c8ea1U, 0x5a05df1bU, 0x2d02ef8dU
+};
+
+
+
+/* Get the number of bytes of a CRC. This is 0 for an unknown type. */
+unsigned int crc_get_size(UART_SEQ_CRC_T tType)
+{
+	unsigned int uiSize;
+
+
+	switch( tType )
+	{
+	case UART_SEQ_CRC_Modbus:
+	case UART_SEQ_CRC_Ccitt:
+		uiSize = 2;
+		break;
+
+	case UART_SEQ_CRC_Crc32:
+		uiSize = 4;
+		break;
+
+	default:
+		uiSize = 0;
+		break;
+	}
+
+	return uiSize;
+}
+
+
+
+unsigned long crc_init(UART_SEQ_CRC_T tType)
+{
+	unsigned long ulCrc;
+
+
+	if( tType==UART_SEQ_CRC_Crc32 )
+	{
+		ulCrc = 0xffffffffU;
+	}
+	else
+	{
+		ulCrc = 0xffffU;
+	}
+
+	return ulCrc;
+}
+
+
+
+/* Add data to a CRC. The type is only checked once and not for each byte. */
+unsigned long crc_update(UART_SEQ_CRC_T tType, unsigned long ulCrc, const unsigned char *pucData, unsigned long sizData)
+{
+	const unsigned char *pucEnd;
+
+
+	pucEnd = pucData + sizData;
+	switch( tType )
+	{
+	case UART_SEQ_CRC_Modbus:
+		while( pucData<pucEnd )
+		{
+			ulCrc = (ulCrc >> 8U) ^ ausCrcTableModbus[(ulCrc ^ *(pucData++)) & 0xffU];
+		}
+		break;
+
+	case UART_SEQ_CRC_Ccitt:
+		while( pucData<pucEnd )
+		{
+			ulCrc = ((ulCrc << 8U) & 0xff00U) ^ ausCrcTableCcitt[((ulCrc >> 8U) ^ *(pucData++)) & 0xffU];
+		}
+		break;
+
+	case UART_SEQ_CRC_Crc32:
+		while( pucData<pucEnd )
+		{
+			ulCrc = ((ulCrc >> 8U) & 0x00ffffffU) ^ aulCrcTableCrc32[(ulCrc ^ *(pucData++)) & 0xffU];
+		}
+		break;
+	}
+
+	return ulCrc;
+}
+
+
+
+unsigned long crc_finish(UART_SEQ_CRC_T tType, unsigned long ulCrc)
+{
+	if( tType==UART_SEQ_CRC_Crc32 )
+	{
+		ulCrc ^= 0xffffffffU;
+	}
+
+	return ulCrc;
+}
+
+
+
+/* Get the bytes of a CRC in the order on the line. */
+void crc_get_bytes(UART_SEQ_CRC_T tType, unsigned long ulCrc, unsigned char *pucData)
+{
+	unsigned int uiSize;
+	unsigned int uiCnt;
+
+
+	uiSize = crc_get_size(tType);
+	for(uiCnt=0; uiCnt<uiSize; ++uiCnt)
+	{
+		if( tType==UART_SEQ_CRC_Ccitt )
+		{
+			pucData[uiCnt] = (unsigned char)((ulCrc >> (8U * (uiSize - 1U - uiCnt))) & 0xffU);
+		}
+		else
+		{
+			pucData[uiCnt] = (unsigned char)((ulCrc >> (8U * uiCnt)) & 0xffU);
+		}
+	}
+}
@@ -0,0 +1,23 @@
+#include "interface.h"
+
+#ifndef __CRC_H__
+#define __CRC_H__
+
+
+/* The CRCs of the framed protocols. Each one uses a table with 256 entries
+ * and processes one byte per step:
+ *   Modbus: CRC-16/MODBUS, poly 0x8005 reflected, init 0xffff
+ *   CCITT:  CRC-16/CCITT-FALSE, poly 0x1021, init 0xffff
+ *   CRC32:  CRC-32 like Ethernet, poly 0x04c11db7 reflected, init and
+ *           final XOR 0xffffffff
+ * The reflected CRCs are sent with the LSB first, CCITT with the MSB first.
+ */
+
+unsigned int crc_get_size(UART_SEQ_CRC_T tType);
+unsigned long crc_init(UART_SEQ_CRC_T tType);
+unsigned long crc_update(UART_SEQ_CRC_T tType, unsigned long ulCrc, const unsigned char *pucData, unsigned long sizData);
+unsigned long crc_finish(UART_SEQ_CRC_T tType, unsigned long ulCrc);
+void crc_get_bytes(UART_SEQ_CRC_T tType, unsigned long ulCrc, unsigned char *pucData);
+
+
+#endif  /* __CRC_H__ */
@@ -0,0 +1,46 @@
+/***************************************************************************
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef __ASIC_TYPES_H__
+#define __ASIC_TYPES_H__
+
+
+/* These are the same values as in the platform library. */
+#define ASIC_TYP_NETX500          1
+#define ASIC_TYP_NETX50           2
+#define ASIC_TYP_NETX10           3
+#define ASIC_TYP_NETX56           4
+#define ASIC_TYP_NETX6            5
+#define ASIC_TYP_NETX4000_RELAXED 6
+#define ASIC_TYP_NETX90_MPW       7
+#define ASIC_TYP_NETX90_MPW_APP   8
+#define ASIC_TYP_NETX4000         9
+#define ASIC_TYP_NETX90           10
+#define ASIC_TYP_NETX90_APP       11
+#define ASIC_TYP_NETIOL           12
+
+/* The simulated UART on the build host. */
+#define ASIC_TYP_HOSTSIM          100
+
+
+#ifndef ASIC_TYP
+#       define ASIC_TYP ASIC_TYP_HOSTSIM
+#endif
+
+
+#endif  /* __ASIC_TYPES_H__ */
@@ -0,0 +1,428 @@
+/***************************************************************************
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+/* This is the benchmark driver for the host simulation. It runs a set of
+ * sequences through the unchanged interpreter in "main_test.c" and reports
+ * the throughput on the simulated line.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include "interface.h"
+#include "main_test.h"
+#include "uart_sim.h"
+#include "uprintf.h"
+
+
+/*-------------------------------------------------------------------------*/
+
+/* The handle is passed as a 32 bit value like on the netX. The benchmark
+ * must be linked without PIE to keep these buffers in the lower 4GB.
+ */
+static unsigned long s_aulHandle[64];
+static unsigned char s_aucSequence[0x20000];
+static unsigned char s_aucReceived[0x20000];
+
+/* All responses of the simulated DUT start after this time. */
+#define BENCHMARK_DUT_LATENCY (20ULL * UARTSIM_PS_PER_US)
+
+
+typedef enum BENCHMARK_TYPE_ENUM
+{
+	BENCHMARK_TYPE_Send = 0,
+	BENCHMARK_TYPE_Stream = 1,
+	BENCHMARK_TYPE_RequestResponse = 2,
+	BENCHMARK_TYPE_Echo = 3
+} BENCHMARK_TYPE_T;
+
+
+typedef struct BENCHMARK_SCENARIO_STRUCT
+{
+	const char *pcName;
+	BENCHMARK_TYPE_T tType;
+	unsigned long ulBaudRate;
+	unsigned long ulSize;
+	unsigned long ulRepeat;
+} BENCHMARK_SCENARIO_T;
+
+
+static const BENCHMARK_SCENARIO_T atScenarios[] =
+{
+	{ "send",    BENCHMARK_TYPE_Send,             115200, 4096,   1 },
+	{ "send",    BENCHMARK_TYPE_Send,             921600, 4096,   1 },
+	{ "send",    BENCHMARK_TYPE_Send,            3000000, 4096,   1 },
+	{ "stream",  BENCHMARK_TYPE_Stream,           115200, 4096,   1 },
+	{ "stream",  BENCHMARK_TYPE_Stream,           921600, 4096,   1 },
+	{ "stream",  BENCHMARK_TYPE_Stream,          3000000, 4096,   1 },
+	{ "reqresp", BENCHMARK_TYPE_RequestResponse,  115200,    8, 100 },
+	{ "reqresp", BENCHMARK_TYPE_RequestResponse,  921600,    8, 100 },
+	{ "reqresp", BENCHMARK_TYPE_RequestResponse, 3000000,    8, 100 },
+	{ "echo",    BENCHMARK_TYPE_Echo,             115200, 4096,   1 },
+	{ "echo",    BENCHMARK_TYPE_Echo,             921600, 4096,   1 },
+	{ "echo",    BENCHMARK_TYPE_Echo,            3000000, 4096,   1 }
+};
+
+
+/*-------------------------------------------------------------------------*/
+
+
+class SequenceBuilder
+{
+public:
+	SequenceBuilder(void)
+	 : uiCommands(0)
+	{
+	}
+
+	void clean(void)
+	{
+		atData.push_back(UART_SEQ_COMMAND_Clean);
+		++uiCommands;
+	}
+
+	void send(const unsigned char *pucData, unsigned int sizData)
+	{
+		atData.push_back(UART_SEQ_COMMAND_Send);
+		push16(sizData);
+		atData.insert(atData.end(), pucData, pucData + sizData);
+		++uiCommands;
+	}
+
+	void receive(unsigned int sizData, unsigned int uiTimeoutTotalMs, unsigned int uiTimeoutCharMs)
+	{
+		atData.push_back(UART_SEQ_COMMAND_Receive);
+		push16(sizData);
+		push16(uiTimeoutTotalMs);
+		push16(uiTimeoutCharMs);
+		++uiCommands;
+	}
+
+	void transceive(const unsigned char *pucData, unsigned int sizData, unsigned int sizReceive, unsigned int uiTimeoutTotalMs, unsigned int uiTimeoutCharMs)
+	{
+		atData.push_back(UART_SEQ_COMMAND_Transceive);
+		push16(sizData);
+		push16(sizReceive);
+		push16(uiTimeoutTotalMs);
+		push16(uiTimeoutCharMs);
+		atData.insert(atData.end(), pucData, pucData + sizData);
+		++uiCommands;
+	}
+
+	std::vector<unsigned char> atData;
+	unsigned int uiCommands;
+
+private:
+	void push16(unsigned int uiData)
+	{
+		atData.push_back((unsigned char)(uiData & 0xffU));
+		atData.push_back((unsigned char)((uiData >> 8U) & 0xffU));
+	}
+};
+
+
+static void get_pattern(unsigned char *pucData, size_t sizData, unsigned char ucSeed)
+{
+	size_t sizCnt;
+
+
+	for(sizCnt=0; sizCnt<sizData; ++sizCnt)
+	{
+		pucData[sizCnt] = (unsigned char)(ucSeed + sizCnt*7U);
+	}
+}
+
+
+static TEST_RESULT_T run_command(UART_PARAMETER_T *ptParameter)
+{
+	return test(ptParameter);
+}
+
+
+static TEST_RESULT_T open_uart(unsigned long ulBaudRate)
+{
+	UART_PARAMETER_T tParameter;
+	unsigned int uiCnt;
+
+
+	memset(&tParameter, 0, sizeof(tParameter));
+	tParameter.ulVerbose = 0;
+	tParameter.ulCommand = UART_CMD_Open;
+	tParameter.uParameter.tOpen.ptHandle = (uint32_t)((uintptr_t)s_aulHandle);
+	tParameter.uParameter.tOpen.ulUartCore = 0;
+	tParameter.uParameter.tOpen.ulBaudRate = ulBaudRate;
+	for(uiCnt=0; uiCnt<4; ++uiCnt)
+	{
+		tParameter.uParameter.tOpen.aucMMIO[uiCnt] = 0xffU;
+		tParameter.uParameter.tOpen.ausPortcontrol[uiCnt] = 0xffffU;
+	}
+
+	return run_command(&tParameter);
+}
+
+
+static TEST_RESULT_T close_uart(void)
+{
+	UART_PARAMETER_T tParameter;
+
+
+	memset(&tParameter, 0, sizeof(tParameter));
+	tParameter.ulVerbose = 0;
+	tParameter.ulCommand = UART_CMD_Close;
+	tParameter.uParameter.tClose.ptHandle = (uint32_t)((uintptr_t)s_aulHandle);
+
+	return run_command(&tParameter);
+}
+
+
+static TEST_RESULT_T run_sequence(const std::vector<unsigned char> &atSequence, unsigned long ulVerbose, uint32_t *psizReceived)
+{
+	UART_PARAMETER_T tParameter;
+	TEST_RESULT_T tResult;
+
+
+	memcpy(s_aucSequence, atSequence.data(), atSequence.size());
+
+	memset(&tParameter, 0, sizeof(tParameter));
+	tParameter.ulVerbose = ulVerbose;
+	tParameter.ulCommand = UART_CMD_RunSequence;
+	tParameter.uParameter.tRunSequence.ptHandle = (uint32_t)((uintptr_t)s_aulHandle);
+	tParameter.uParameter.tRunSequence.pucCommand = s_aucSequence;
+	tParameter.uParameter.tRunSequence.sizCommand = (uint32_t)atSequence.size();
+	tParameter.uParameter.tRunSequence.pucReceivedData = s_aucReceived;
+	tParameter.uParameter.tRunSequence.sizReceivedDataMax = sizeof(s_aucReceived);
+	tParameter.uParameter.tRunSequence.sizReceivedData = 0;
+
+	tResult = run_command(&tParameter);
+	*psizReceived = tParameter.uParameter.tRunSequence.sizReceivedData;
+
+	return tResult;
+}
+
+
+static int run_scenario(const BENCHMARK_SCENARIO_T *ptScenario, unsigned long ulVerbose)
+{
+	int iResult;
+	SequenceBuilder tSequence;
+	std::vector<unsigned char> atRequest;
+	std::vector<unsigned char> atExpected;
+	unsigned long ulCnt;
+	unsigned long ulPayload;
+	unsigned long ulStreamSize;
+	UARTSIM_TIME_T tCharTime;
+	UARTSIM_TIME_T tIdeal;
+	UARTSIM_TIME_T tStart;
+	UARTSIM_TIME_T tElapsed;
+	TEST_RESULT_T tResult;
+	uint32_t sizReceived;
+	std::chrono::steady_clock::time_point tHostStart;
+	double dHostNs;
+	double dBytesPerSecond;
+	double dPollsPerByte;
+	double dCyclesPerByte;
+	double dOverheadUs;
+	const UARTSIM_STATISTICS_T *ptStatistics;
+
+
+	tUartSim_uart0.reset();
+	tUartSim_uart1.reset();
+	tUartSim_uart2.reset();
+
+	iResult = -1;
+	ulPayload = 0;
+	tIdeal = 0;
+	tResult = open_uart(ptScenario->ulBaudRate);
+	if( tResult!=TEST_RESULT_OK )
+	{
+		printf("Failed to open the UART.\n");
+	}
+	else
+	{
+		tCharTime = tUartSim_uart0.get_char_time();
+
+		switch( ptScenario->tType )
+		{
+		case BENCHMARK_TYPE_Send:
+			atRequest.resize(ptScenario->ulSize);
+			get_pattern(atRequest.data(), atRequest.size(), 0x11);
+			tSequence.send(atRequest.data(), (unsigned int)atRequest.size());
+			ulPayload = ptScenario->ulSize;
+			tIdeal = ulPayload * tCharTime;
+			break;
+
+		case BENCHMARK_TYPE_Stream:
+			/* The DUT answers a single trigger byte with a block of data. */
+			atExpected.resize(ptScenario->ulSize);
+			get_pattern(atExpected.data(), atExpected.size(), 0x22);
+			ulStreamSize = ptScenario->ulSize;
+			tUartSim_uart0.set_peer([ulStreamSize](UartSim &tUart, unsigned char ucData, UARTSIM_TIME_T tTime)
+			{
+				std::vector<unsigned char> atData(ulStreamSize);
+
+				(void)ucData;
+				get_pattern(atData.data(), atData.size(), 0x22);
+				tUart.peer_send(atData.data(), atData.size(), tTime + BENCHMARK_DUT_LATENCY);
+			});
+			atRequest.push_back(0xa5U);
+			tSequence.send(atRequest.data(), 1);
+			tSequence.receive(ptScenario->ulSize, 10000, 100);
+			ulPayload = ptScenario->ulSize;
+			tIdeal = (ulPayload + 1U) * tCharTime + BENCHMARK_DUT_LATENCY;
+			break;
+
+		case BENCHMARK_TYPE_RequestResponse:
+			/* The DUT echoes every byte. */
+			tUartSim_uart0.set_peer_echo(BENCHMARK_DUT_LATENCY);
+			atRequest.resize(ptScenario->ulSize);
+			for(ulCnt=0; ulCnt<ptScenario->ulRepeat; ++ulCnt)
+			{
+				get_pattern(atRequest.data(), atRequest.size(), (unsigned char)ulCnt);
+				tSequence.send(atRequest.data(), (unsigned int)atRequest.size());
+				tSequence.receive(ptScenario->ulSize, 1000, 100);
+				atExpected.insert(atExpected.end(), atRequest.begin(), atRequest.end());
+			}
+			ulPayload = 2U * ptScenario->ulSize * ptScenario->ulRepeat;
+			tIdeal = ptScenario->ulRepeat * ((ptScenario->ulSize + 1U) * tCharTime + BENCHMARK_DUT_LATENCY);
+			break;
+
+		case BENCHMARK_TYPE_Echo:
+			/* The DUT echoes every byte while the request is still running. */
+			tUartSim_uart0.set_peer_echo(BENCHMARK_DUT_LATENCY);
+			atRequest.resize(ptScenario->ulSize);
+			get_pattern(atRequest.data(), atRequest.size(), 0x33);
+			tSequence.transceive(atRequest.data(), (unsigned int)atRequest.size(), (unsigned int)atRequest.size(), 10000, 100);
+			atExpected = atRequest;
+			ulPayload = 2U * ptScenario->ulSize;
+			tIdeal = (ptScenario->ulSize + 1U) * tCharTime + BENCHMARK_DUT_LATENCY;
+			break;
+		}
+
+		/* Only measure the sequence. */
+		tUartSim_uart0.clear_statistics();
+		tStart = uartsim_now();
+		tHostStart = std::chrono::steady_clock::now();
+
+		tResult = run_sequence(tSequence.atData, ulVerbose, &sizReceived);
+
+		dHostNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tHostStart).count();
+		tElapsed = uartsim_now() - tStart;
+		ptStatistics = &tUartSim_uart0.get_statistics();
+
+		close_uart();
+
+		if( tResult!=TEST_RESULT_OK )
+		{
+			printf("%-8s %8lu %6lu  FAILED: the sequence returned an error.\n", ptScenario->pcName, ptScenario->ulBaudRate, ptScenario->ulSize);
+		}
+		else if( sizReceived!=atExpected.size() || memcmp(s_aucReceived, atExpected.data(), atExpected.size())!=0 )
+		{
+			printf("%-8s %8lu %6lu  FAILED: the received data does not match.\n", ptScenario->pcName, ptScenario->ulBaudRate, ptScenario->ulSize);
+		}
+		else
+		{
+			dBytesPerSecond = (double)ulPayload * (double)UARTSIM_PS_PER_S / (double)tElapsed;
+			dPollsPerByte = (double)ptStatistics->ulReadsFr / (double)ulPayload;
+			/* Only count the accesses which moved data or checked it. Waiting for the line is not included. */
+			dCyclesPerByte = (double)(ptStatistics->ulReadsFrUsed + ptStatistics->ulReadsDr + ptStatistics->ulReadsRsr + ptStatistics->ulWritesDr);
+			dCyclesPerByte *= (double)uartsim_get_profile()->ulCyclesPerRegisterAccess;
+			dCyclesPerByte /= (double)(ptStatistics->ulTxBytes + ptStatistics->ulRxBytes);
+			dOverheadUs = ((double)tElapsed - (double)tIdeal) / (double)UARTSIM_PS_PER_US / (double)tSequence.uiCommands;
+			printf("%-8s %8lu %6lu %5lu %12.0f %9.1f%% %9.1f %8.1f %12.2f %12.0f\n",
+			       ptScenario->pcName,
+			       ptScenario->ulBaudRate,
+			       ptScenario->ulSize,
+			       ptScenario->ulRepeat,
+			       dBytesPerSecond,
+			       100.0 * (double)tIdeal / (double)tElapsed,
+			       dPollsPerByte,
+			       dCyclesPerByte,
+			       dOverheadUs,
+			       dHostNs / (double)tSequence.uiCommands
+			);
+			iResult = 0;
+		}
+	}
+
+	return iResult;
+}
+
+
+int main(int argc, char **argv)
+{
+	int iResult;
+	int iArg;
+	unsigned long ulVerbose;
+	unsigned int uiCnt;
+	std::vector<const UARTSIM_PROFILE_T*> atProfiles;
+
+
+	if( ((uintptr_t)s_aulHandle)>0xffffffffU )
+	{
+		fprintf(stderr, "The handle is not in the lower 4GB. Link the benchmark without PIE.\n");
+		return 2;
+	}
+
+	ulVerbose = 0;
+	for(iArg=1; iArg<argc; ++iArg)
+	{
+		if( strcmp(argv[iArg], "-v")==0 )
+		{
+			ulVerbose = 0xffffffffU;
+		}
+		else if( strcmp(argv[iArg], "netx4000")==0 )
+		{
+			atProfiles.push_back(&tUartSimProfile_netx4000);
+		}
+		else if( strcmp(argv[iArg], "netx90")==0 )
+		{
+			atProfiles.push_back(&tUartSimProfile_netx90);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [-v] [netx4000] [netx90]\n", argv[0]);
+			return 2;
+		}
+	}
+	if( atProfiles.empty()==true )
+	{
+		atProfiles.push_back(&tUartSimProfile_netx4000);
+		atProfiles.push_back(&tUartSimProfile_netx90);
+	}
+	uprintf_set_quiet((ulVerbose!=0) ? 0 : 1);
+
+	iResult = 0;
+	for(const UARTSIM_PROFILE_T *ptProfile : atProfiles)
+	{
+		uartsim_set_profile(ptProfile);
+
+		printf("\n%s: %lu MHz, %lu cycles per register access\n", ptProfile->pcName, ptProfile->ulCpuFrequency/1000000UL, ptProfile->ulCyclesPerRegisterAccess);
+		printf("%-8s %8s %6s %5s %12s %10s %9s %8s %12s %12s\n", "scenario", "baud", "size", "rep", "bytes/s", "line", "polls/B", "cyc/B", "ovh us/cmd", "host ns/cmd");
+		for(uiCnt=0; uiCnt<(sizeof(atScenarios)/sizeof(atScenarios[0])); ++uiCnt)
+		{
+			if( run_scenario(atScenarios + uiCnt, ulVerbose)!=0 )
+			{
+				iResult = 1;
+			}
+		}
+	}
+
+	return iResult;
+}
@@ -0,0 +1,29 @@
+/***************************************************************************
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+/* Build the unchanged test for the host. The register accesses in
+ * "main_test.c" are forwarded to the UART simulation, which needs a C++
+ * compiler. The helper modules of the test are built in the same unit.
+ */
+
+#include "baudrate.c"
+#include "crc.c"
+#include "main_test.c"
+#include "pattern_match.c"
+#include "prbs.c"
+#include "ticks.c"
+#include "trace.c"
@@ -0,0 +1,37 @@
+/***************************************************************************
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+/* This is a replacement for the "netx_io_areas.h" of the platform library.
+ * It maps the UART areas to the simulation in "uart_sim.h".
+ */
+
+#ifndef __NETX_IO_AREAS_H__
+#define __NETX_IO_AREAS_H__
+
+#include "asic_types.h"
+#include "uart_sim.h"
+
+
+#define HOSTNAME "HOSTSIM"
+
+#define HOSTADEF(name) UARTSIM_##name##_AREA_T
+#define HOSTADDR(name) (&(tUartSim_##name.tArea))
+#define HOSTMSK(name) MSK_UARTSIM_##name
+#define HOSTSRT(name) SRT_UARTSIM_##name
+
+
+#endif  /* __NETX_IO_AREAS_H__ */
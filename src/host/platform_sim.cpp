@@ -0,0 +1,196 @@
+/***************************************************************************
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+/* This file replaces the parts of the platform library which are used by
+ * the test. The time functions work on the virtual clock of the UART
+ * simulation.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "rdy_run.h"
+#include "systime.h"
+#include "ticks.h"
+#include "uart_sim.h"
+#include "uprintf.h"
+
+
+/*-------------------------------------------------------------------------*/
+
+
+void systime_init(void)
+{
+}
+
+
+unsigned long systime_get_ms(void)
+{
+	uartsim_consume_cycles(uartsim_get_profile()->ulCyclesPerSystimeCall);
+	return (unsigned long)(uartsim_now() / UARTSIM_PS_PER_MS);
+}
+
+
+int systime_elapsed(unsigned long ulStart, unsigned long ulDuration)
+{
+	unsigned long ulDiff;
+
+
+	ulDiff = systime_get_ms() - ulStart;
+	return (ulDiff>=ulDuration) ? 1 : 0;
+}
+
+
+void systime_delay_ms(unsigned long ulDuration)
+{
+	uartsim_advance(ulDuration * UARTSIM_PS_PER_MS);
+}
+
+
+unsigned long ticks_get(void)
+{
+	uartsim_consume_cycles(uartsim_get_profile()->ulCyclesPerTicksRead);
+	return (unsigned long)(uartsim_now() / (UARTSIM_PS_PER_US / TICKS_PER_US));
+}
+
+
+/*-------------------------------------------------------------------------*/
+
+
+static int s_iQuiet = 0;
+
+
+void uprintf_set_quiet(int iQuiet)
+{
+	s_iQuiet = iQuiet;
+}
+
+
+/* The firmware passes all numbers as 32 bit values. This is a small subset
+ * of the platform's uprintf which reads every number as a 32 bit value.
+ */
+void uprintf(const char *pcFmt, ...)
+{
+	va_list ptArgument;
+	const char *pcCnt;
+	char acFormat[16];
+	size_t sizFormat;
+	unsigned long ulValue;
+	const char *pcString;
+
+
+	if( s_iQuiet==0 )
+	{
+		va_start(ptArgument, pcFmt);
+
+		pcCnt = pcFmt;
+		while( *pcCnt!='\0' )
+		{
+			if( *pcCnt!='%' )
+			{
+				putchar(*(pcCnt++));
+			}
+			else
+			{
+				/* Copy the complete conversion. */
+				sizFormat = 0;
+				acFormat[sizFormat++] = *(pcCnt++);
+				while( *pcCnt!='\0' && sizFormat<(sizeof(acFormat)-3) && ((*pcCnt>='0' && *pcCnt<='9') || *pcCnt=='-') )
+				{
+					acFormat[sizFormat++] = *(pcCnt++);
+				}
+
+				switch( *pcCnt )
+				{
+				case 'd':
+				case 'u':
+				case 'x':
+				case 'X':
+				case 'c':
+					ulValue = va_arg(ptArgument, unsigned long) & 0xffffffffUL;
+					acFormat[sizFormat++] = 'l';
+					acFormat[sizFormat++] = *(pcCnt++);
+					acFormat[sizFormat] = '\0';
+					if( acFormat[sizFormat-1]=='d' )
+					{
+						printf(acFormat, (long)((int)ulValue));
+					}
+					else if( acFormat[sizFormat-1]=='c' )
+					{
+						putchar((int)(ulValue & 0xffU));
+					}
+					else
+					{
+						printf(acFormat, ulValue);
+					}
+					break;
+
+				case 's':
+					pcString = va_arg(ptArgument, const char*);
+					acFormat[sizFormat++] = *(pcCnt++);
+					acFormat[sizFormat] = '\0';
+					printf(acFormat, pcString);
+					break;
+
+				case '%':
+					putchar(*(pcCnt++));
+					break;
+
+				default:
+					/* Print unknown conversions as they are. */
+					acFormat[sizFormat] = '\0';
+					fputs(acFormat, stdout);
+					break;
+				}
+			}
+		}
+
+		va_end(ptArgument);
+	}
+}
+
+
+void hexdump(const unsigned char *pucData, unsigned long ulSize)
+{
+	unsigned long ulCnt;
+
+
+	if( s_iQuiet==0 )
+	{
+		for(ulCnt=0; ulCnt<ulSize; ++ulCnt)
+		{
+			if( (ulCnt & 15U)==0 )
+			{
+				printf("%08lx:", ulCnt);
+			}
+			printf(" %02x", pucData[ulCnt]);
+			if( (ulCnt & 15U)==15U || ulCnt+1U==ulSize )
+			{
+				putchar('\n');
+			}
+		}
+	}
+}
+
+
+/*-------------------------------------------------------------------------*/
+
+
+void rdy_run_setLEDs(RDYRUN_T tState)
+{
+	(void)tState;
+}
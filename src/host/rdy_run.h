@@ -0,0 +1,35 @@
+/***************************************************************************
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+/* This is a replacement for the "rdy_run.h" of the platform library. */
+
+#ifndef __RDY_RUN_H__
+#define __RDY_RUN_H__
+
+
+typedef enum RDYRUN_ENUM
+{
+	RDYRUN_OFF = 0,
+	RDYRUN_GREEN = 1,
+	RDYRUN_YELLOW = 2
+} RDYRUN_T;
+
+
+void rdy_run_setLEDs(RDYRUN_T tState);
+
+
+#endif  /* __RDY_RUN_H__ */
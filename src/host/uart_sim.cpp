@@ -0,0 +1,591 @@
+/***************************************************************************
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#include "uart_sim.h"
+
+
+/*-------------------------------------------------------------------------*/
+
+/* The cost of a register access is an estimate for the path from the CPU
+ * to the UART module. It includes the bus bridges, but not the code around
+ * the access.
+ */
+const UARTSIM_PROFILE_T tUartSimProfile_netx4000 =
+{
+	.pcName = "netX4000",
+	.ulCpuFrequency = 600000000UL,
+	.ulCyclesPerRegisterAccess = 40,
+	.ulCyclesPerSystimeCall = 120,
+	.ulCyclesPerTicksRead = 4
+};
+
+const UARTSIM_PROFILE_T tUartSimProfile_netx90 =
+{
+	.pcName = "netX90",
+	.ulCpuFrequency = 100000000UL,
+	.ulCyclesPerRegisterAccess = 6,
+	.ulCyclesPerSystimeCall = 60,
+	.ulCyclesPerTicksRead = 3
+};
+
+
+UartSim tUartSim_uart0;
+UartSim tUartSim_uart1;
+UartSim tUartSim_uart2;
+
+static UartSim * const s_aptUarts[] =
+{
+	&tUartSim_uart0,
+	&tUartSim_uart1,
+	&tUartSim_uart2
+};
+
+static const UARTSIM_PROFILE_T *s_ptProfile = &tUartSimProfile_netx4000;
+static UARTSIM_TIME_T s_tNow = 0;
+static unsigned long long s_ullCycles = 0;
+static unsigned long long s_ullCyclePsRemainder = 0;
+
+
+void uartsim_set_profile(const UARTSIM_PROFILE_T *ptProfile)
+{
+	s_ptProfile = ptProfile;
+}
+
+
+const UARTSIM_PROFILE_T *uartsim_get_profile(void)
+{
+	return s_ptProfile;
+}
+
+
+UARTSIM_TIME_T uartsim_now(void)
+{
+	return s_tNow;
+}
+
+
+unsigned long long uartsim_get_cycles(void)
+{
+	return s_ullCycles;
+}
+
+
+void uartsim_consume_cycles(unsigned long ulCycles)
+{
+	unsigned long long ullPs;
+
+
+	s_ullCycles += ulCycles;
+
+	/* Convert the cycles to picoseconds and keep the remainder for the next call. */
+	ullPs = ulCycles * UARTSIM_PS_PER_S + s_ullCyclePsRemainder;
+	s_ullCyclePsRemainder = ullPs % s_ptProfile->ulCpuFrequency;
+	uartsim_advance(ullPs / s_ptProfile->ulCpuFrequency);
+}
+
+
+void uartsim_advance(UARTSIM_TIME_T tDelta)
+{
+	unsigned int uiCnt;
+
+
+	s_tNow += tDelta;
+
+	/* A finished TX character can appear on the RX line of any UART. */
+	for(uiCnt=0; uiCnt<(sizeof(s_aptUarts)/sizeof(s_aptUarts[0])); ++uiCnt)
+	{
+		s_aptUarts[uiCnt]->update_tx(s_tNow);
+	}
+	for(uiCnt=0; uiCnt<(sizeof(s_aptUarts)/sizeof(s_aptUarts[0])); ++uiCnt)
+	{
+		s_aptUarts[uiCnt]->update_rx(s_tNow);
+	}
+}
+
+
+/*-------------------------------------------------------------------------*/
+
+
+UartSimRegister::UartSimRegister(UartSim *ptSim, UARTSIM_REGISTER_T tRegister)
+ : m_ptSim(ptSim)
+ , m_tRegister(tRegister)
+{
+}
+
+
+UartSimRegister::operator unsigned long() const
+{
+	return m_ptSim->read(m_tRegister);
+}
+
+
+UartSimRegister &UartSimRegister::operator=(unsigned long ulValue)
+{
+	m_ptSim->write(m_tRegister, ulValue);
+	return *this;
+}
+
+
+UartSimRegister &UartSimRegister::operator=(const UartSimRegister &tOther)
+{
+	m_ptSim->write(m_tRegister, (unsigned long)tOther);
+	return *this;
+}
+
+
+UARTSIM_UART_AREA_STRUCT::UARTSIM_UART_AREA_STRUCT(UartSim *ptSim)
+ : ulUartdr(ptSim, UARTSIM_REGISTER_uartdr)
+ , ulUartrsr(ptSim, UARTSIM_REGISTER_uartrsr)
+ , ulUartlcr_h(ptSim, UARTSIM_REGISTER_uartlcr_h)
+ , ulUartlcr_m(ptSim, UARTSIM_REGISTER_uartlcr_m)
+ , ulUartlcr_l(ptSim, UARTSIM_REGISTER_uartlcr_l)
+ , ulUartcr(ptSim, UARTSIM_REGISTER_uartcr)
+ , ulUartfr(ptSim, UARTSIM_REGISTER_uartfr)
+ , ulUartiir(ptSim, UARTSIM_REGISTER_uartiir)
+ , ulUartilpr(ptSim, UARTSIM_REGISTER_uartilpr)
+ , ulUartrts(ptSim, UARTSIM_REGISTER_uartrts)
+ , ulUartforerun(ptSim, UARTSIM_REGISTER_uartforerun)
+ , ulUarttrail(ptSim, UARTSIM_REGISTER_uarttrail)
+ , ulUartdrvout(ptSim, UARTSIM_REGISTER_uartdrvout)
+ , ulUartcr_2(ptSim, UARTSIM_REGISTER_uartcr_2)
+ , ulUartrxiflsel(ptSim, UARTSIM_REGISTER_uartrxiflsel)
+ , ulUarttxiflsel(ptSim, UARTSIM_REGISTER_uarttxiflsel)
+{
+}
+
+
+/*-------------------------------------------------------------------------*/
+
+
+UartSim::UartSim(void)
+ : tArea(this)
+{
+	reset();
+}
+
+
+void UartSim::reset(void)
+{
+	unsigned int uiCnt;
+
+
+	for(uiCnt=0; uiCnt<UARTSIM_REGISTER_COUNT; ++uiCnt)
+	{
+		m_aulRegister[uiCnt] = 0;
+	}
+
+	m_tTxFifo.clear();
+	m_fTxShiftActive = false;
+	m_fLastAccessFr = false;
+	m_ucTxShift = 0;
+	m_tTxShiftDone = 0;
+
+	m_tRxLine.clear();
+	m_tRxFifo.clear();
+	m_tPeerLineFree = 0;
+
+	m_fCtsActive = true;
+
+	m_tPeer = nullptr;
+	atTxLog.clear();
+	clear_statistics();
+}
+
+
+void UartSim::clear_statistics(void)
+{
+	m_tStatistics = UARTSIM_STATISTICS_T();
+}
+
+
+const UARTSIM_STATISTICS_T &UartSim::get_statistics(void) const
+{
+	return m_tStatistics;
+}
+
+
+unsigned long UartSim::get_baud_rate(void) const
+{
+	unsigned long ulDivider;
+
+
+	/* This is baud rate mode 2 with a module clock of 100MHz. */
+	ulDivider  = (m_aulRegister[UARTSIM_REGISTER_uartlcr_m] & 0xffU) << 8U;
+	ulDivider |=  m_aulRegister[UARTSIM_REGISTER_uartlcr_l] & 0xffU;
+	return (unsigned long)((ulDivider * 100000000ULL) / (16ULL * 65536ULL));
+}
+
+
+UARTSIM_TIME_T UartSim::get_char_time(void) const
+{
+	unsigned long ulDivider;
+	unsigned long ulLcrH;
+	unsigned long ulBits;
+	UARTSIM_TIME_T tBitTime;
+
+
+	ulDivider  = (m_aulRegister[UARTSIM_REGISTER_uartlcr_m] & 0xffU) << 8U;
+	ulDivider |=  m_aulRegister[UARTSIM_REGISTER_uartlcr_l] & 0xffU;
+	if( ulDivider==0 )
+	{
+		/* The UART does not run at all. */
+		return UINT64_MAX;
+	}
+
+	/* One bit lasts 16 * 65536 / (divider * 100MHz) seconds. */
+	tBitTime = (16ULL * 65536ULL * 10000ULL) / ulDivider;
+
+	/* Start bit, data bits, optional parity and 1 or 2 stop bits. */
+	ulLcrH = m_aulRegister[UARTSIM_REGISTER_uartlcr_h];
+	ulBits  = 1U;
+	ulBits += 5U + ((ulLcrH & MSK_UARTSIM_uartlcr_h_WLEN) >> SRT_UARTSIM_uartlcr_h_WLEN);
+	ulBits += ((ulLcrH & MSK_UARTSIM_uartlcr_h_PEN)!=0) ? 1U : 0U;
+	ulBits += ((ulLcrH & MSK_UARTSIM_uartlcr_h_STP2)!=0) ? 2U : 1U;
+
+	return tBitTime * ulBits;
+}
+
+
+unsigned long UartSim::get_flags(void)
+{
+	unsigned long ulFlags;
+	size_t sizDepth;
+
+
+	sizDepth = ((m_aulRegister[UARTSIM_REGISTER_uartlcr_h] & MSK_UARTSIM_uartlcr_h_FEN)!=0) ? UARTSIM_FIFO_DEPTH : 1U;
+
+	ulFlags = 0;
+	if( m_fTxShiftActive==true || m_tTxFifo.empty()==false )
+	{
+		ulFlags |= MSK_UARTSIM_uartfr_BUSY;
+	}
+	if( m_tRxFifo.empty()==true )
+	{
+		ulFlags |= MSK_UARTSIM_uartfr_RXFE;
+	}
+	if( m_tTxFifo.size()>=sizDepth )
+	{
+		ulFlags |= MSK_UARTSIM_uartfr_TXFF;
+	}
+	if( m_tRxFifo.size()>=sizDepth )
+	{
+		ulFlags |= MSK_UARTSIM_uartfr_RXFF;
+	}
+	if( m_tTxFifo.empty()==true )
+	{
+		ulFlags |= MSK_UARTSIM_uartfr_TXFE;
+	}
+	if( m_fCtsActive==true )
+	{
+		ulFlags |= MSK_UARTSIM_uartfr_CTS;
+	}
+
+	return ulFlags;
+}
+
+
+void UartSim::start_next_tx(UARTSIM_TIME_T tStart)
+{
+	UARTSIM_TIME_T tCharTime;
+
+
+	if( m_tTxFifo.empty()==true || (m_aulRegister[UARTSIM_REGISTER_uartcr] & MSK_UARTSIM_uartcr_uartEN)==0 )
+	{
+		m_fTxShiftActive = false;
+	}
+	else if( (m_aulRegister[UARTSIM_REGISTER_uartrts] & MSK_UARTSIM_uartrts_CTS_ctr)!=0 && m_fCtsActive==false )
+	{
+		/* The transmitter waits for CTS. */
+		m_fTxShiftActive = false;
+	}
+	else
+	{
+		m_ucTxShift = m_tTxFifo.front();
+		m_tTxFifo.pop_front();
+		m_fTxShiftActive = true;
+
+		tCharTime = get_char_time();
+		if( tCharTime==UINT64_MAX )
+		{
+			m_tTxShiftDone = UINT64_MAX;
+		}
+		else
+		{
+			m_tTxShiftDone = tStart + tCharTime;
+		}
+	}
+}
+
+
+void UartSim::update_tx(UARTSIM_TIME_T tNow)
+{
+	UARTSIM_TIME_T tDone;
+	unsigned char ucData;
+
+
+	while( m_fTxShiftActive==true && m_tTxShiftDone<=tNow )
+	{
+		tDone = m_tTxShiftDone;
+		ucData = m_ucTxShift;
+		++m_tStatistics.ulTxBytes;
+
+		/* Start the next character before the peer sees this one. */
+		start_next_tx(tDone);
+
+		if( (m_aulRegister[UARTSIM_REGISTER_uartcr] & MSK_UARTSIM_uartcr_LBE)!=0 )
+		{
+			/* The internal loopback replaces the line. */
+			peer_send_char(ucData, tDone);
+		}
+		else if( m_tPeer )
+		{
+			m_tPeer(*this, ucData, tDone);
+		}
+	}
+}
+
+
+void UartSim::update_rx(UARTSIM_TIME_T tNow)
+{
+	size_t sizDepth;
+
+
+	sizDepth = ((m_aulRegister[UARTSIM_REGISTER_uartlcr_h] & MSK_UARTSIM_uartlcr_h_FEN)!=0) ? UARTSIM_FIFO_DEPTH : 1U;
+
+	while( m_tRxLine.empty()==false && m_tRxLine.front().tArrival<=tNow )
+	{
+		if( (m_aulRegister[UARTSIM_REGISTER_uartcr] & MSK_UARTSIM_uartcr_uartEN)==0 )
+		{
+			/* A disabled UART ignores the line. */
+		}
+		else if( m_tRxFifo.size()>=sizDepth )
+		{
+			/* The character is lost. */
+			m_aulRegister[UARTSIM_REGISTER_uartrsr] |= MSK_UARTSIM_uartrsr_OE;
+			++m_tStatistics.ulRxOverruns;
+		}
+		else
+		{
+			m_tRxFifo.push_back(m_tRxLine.front().ulValue);
+		}
+		m_tRxLine.pop_front();
+	}
+}
+
+
+unsigned long UartSim::read(UARTSIM_REGISTER_T tRegister)
+{
+	unsigned long ulValue;
+
+
+	uartsim_consume_cycles(s_ptProfile->ulCyclesPerRegisterAccess);
+
+	switch( tRegister )
+	{
+	case UARTSIM_REGISTER_uartdr:
+		++m_tStatistics.ulReadsDr;
+		if( m_fLastAccessFr==true )
+		{
+			++m_tStatistics.ulReadsFrUsed;
+		}
+		if( m_tRxFifo.empty()==true )
+		{
+			ulValue = 0;
+		}
+		else
+		{
+			ulValue = m_tRxFifo.front();
+			m_tRxFifo.pop_front();
+			++m_tStatistics.ulRxBytes;
+
+			/* The error flags of the character are added to the RSR. They
+			 * stay set until the RSR is written.
+			 */
+			m_aulRegister[UARTSIM_REGISTER_uartrsr] |= (ulValue >> 8U) & (MSK_UARTSIM_uartrsr_FE|MSK_UARTSIM_uartrsr_PE|MSK_UARTSIM_uartrsr_BE);
+			ulValue &= 0xffU;
+		}
+		break;
+
+	case UARTSIM_REGISTER_uartfr:
+		++m_tStatistics.ulReadsFr;
+		ulValue = get_flags();
+		break;
+
+	case UARTSIM_REGISTER_uartrsr:
+		++m_tStatistics.ulReadsRsr;
+		ulValue = m_aulRegister[UARTSIM_REGISTER_uartrsr];
+		break;
+
+	default:
+		++m_tStatistics.ulOtherAccesses;
+		ulValue = m_aulRegister[tRegister];
+		break;
+	}
+	m_fLastAccessFr = (tRegister==UARTSIM_REGISTER_uartfr);
+
+	return ulValue;
+}
+
+
+void UartSim::write(UARTSIM_REGISTER_T tRegister, unsigned long ulValue)
+{
+	size_t sizDepth;
+
+
+	uartsim_consume_cycles(s_ptProfile->ulCyclesPerRegisterAccess);
+
+	switch( tRegister )
+	{
+	case UARTSIM_REGISTER_uartdr:
+		++m_tStatistics.ulWritesDr;
+		if( m_fLastAccessFr==true )
+		{
+			++m_tStatistics.ulReadsFrUsed;
+		}
+		sizDepth = ((m_aulRegister[UARTSIM_REGISTER_uartlcr_h] & MSK_UARTSIM_uartlcr_h_FEN)!=0) ? UARTSIM_FIFO_DEPTH : 1U;
+		if( (m_aulRegister[UARTSIM_REGISTER_uartcr] & MSK_UARTSIM_uartcr_uartEN)==0 || m_tTxFifo.size()>=sizDepth )
+		{
+			++m_tStatistics.ulTxDropped;
+		}
+		else
+		{
+			m_tTxFifo.push_back((unsigned char)(ulValue & 0xffU));
+			atTxLog.push_back((unsigned char)(ulValue & 0xffU));
+			if( m_fTxShiftActive==false )
+			{
+				start_next_tx(uartsim_now());
+			}
+		}
+		break;
+
+	case UARTSIM_REGISTER_uartrsr:
+		/* Any write clears the error flags. */
+		++m_tStatistics.ulOtherAccesses;
+		m_aulRegister[UARTSIM_REGISTER_uartrsr] = 0;
+		break;
+
+	case UARTSIM_REGISTER_uartfr:
+		/* The flags are read only. */
+		++m_tStatistics.ulOtherAccesses;
+		break;
+
+	default:
+		++m_tStatistics.ulOtherAccesses;
+		m_aulRegister[tRegister] = ulValue;
+		break;
+	}
+	m_fLastAccessFr = false;
+}
+
+
+/*-------------------------------------------------------------------------*/
+
+
+void UartSim::set_peer(UARTSIM_PEER_T tPeer)
+{
+	m_tPeer = tPeer;
+}
+
+
+void UartSim::set_peer_none(void)
+{
+	m_tPeer = nullptr;
+}
+
+
+void UartSim::set_peer_cts(bool fActive)
+{
+	m_fCtsActive = fActive;
+
+	/* Continue a waiting transmission. */
+	if( fActive==true && m_fTxShiftActive==false )
+	{
+		start_next_tx(uartsim_now());
+	}
+}
+
+
+void UartSim::set_peer_loopback(void)
+{
+	/* A strap from TX to RX. */
+	m_tPeer = [](UartSim &tUart, unsigned char ucData, UARTSIM_TIME_T tTime)
+	{
+		tUart.peer_send_char(ucData, tTime);
+	};
+}
+
+
+void UartSim::set_peer_echo(UARTSIM_TIME_T tLatency)
+{
+	/* The DUT starts to send each character after the latency. */
+	m_tPeer = [tLatency](UartSim &tUart, unsigned char ucData, UARTSIM_TIME_T tTime)
+	{
+		tUart.peer_send(&ucData, 1, tTime + tLatency);
+	};
+}
+
+
+void UartSim::peer_send(const unsigned char *pucData, size_t sizData, UARTSIM_TIME_T tStart)
+{
+	const unsigned char *pucCnt;
+	const unsigned char *pucEnd;
+	UARTSIM_TIME_T tCharTime;
+	UARTSIM_TIME_T tArrival;
+
+
+	tCharTime = get_char_time();
+	if( tCharTime!=UINT64_MAX )
+	{
+		if( m_tPeerLineFree>tStart )
+		{
+			tStart = m_tPeerLineFree;
+		}
+
+		pucCnt = pucData;
+		pucEnd = pucData + sizData;
+		while( pucCnt<pucEnd )
+		{
+			tArrival = tStart + tCharTime;
+			peer_send_char(*(pucCnt++), tArrival);
+			tStart = tArrival;
+		}
+		m_tPeerLineFree = tStart;
+	}
+}
+
+
+void UartSim::peer_send_char(unsigned long ulValue, UARTSIM_TIME_T tArrival)
+{
+	std::deque<RX_CHAR_T>::iterator tIter;
+	RX_CHAR_T tChar;
+
+
+	tChar.tArrival = tArrival;
+	tChar.ulValue = ulValue;
+
+	/* Keep the line sorted by the arrival time. */
+	tIter = m_tRxLine.end();
+	while( tIter!=m_tRxLine.begin() && (tIter-1)->tArrival>tArrival )
+	{
+		--tIter;
+	}
+	m_tRxLine.insert(tIter, tChar);
+
+	/* The character might be due already. */
+	update_rx(uartsim_now());
+}
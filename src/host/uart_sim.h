@@ -0,0 +1,293 @@
+/***************************************************************************
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef __UART_SIM_H__
+#define __UART_SIM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+
+/*-------------------------------------------------------------------------*/
+
+/* All times in the simulation are in picoseconds. */
+typedef uint64_t UARTSIM_TIME_T;
+
+#define UARTSIM_PS_PER_US 1000000ULL
+#define UARTSIM_PS_PER_MS 1000000000ULL
+#define UARTSIM_PS_PER_S  1000000000000ULL
+
+
+/* The cost model of one chip. */
+typedef struct UARTSIM_PROFILE_STRUCT
+{
+	const char *pcName;
+	unsigned long ulCpuFrequency;
+	unsigned long ulCyclesPerRegisterAccess;
+	unsigned long ulCyclesPerSystimeCall;
+	unsigned long ulCyclesPerTicksRead;
+} UARTSIM_PROFILE_T;
+
+extern const UARTSIM_PROFILE_T tUartSimProfile_netx4000;
+extern const UARTSIM_PROFILE_T tUartSimProfile_netx90;
+
+void uartsim_set_profile(const UARTSIM_PROFILE_T *ptProfile);
+const UARTSIM_PROFILE_T *uartsim_get_profile(void);
+
+/* The virtual clock. */
+UARTSIM_TIME_T uartsim_now(void);
+void uartsim_consume_cycles(unsigned long ulCycles);
+void uartsim_advance(UARTSIM_TIME_T tDelta);
+unsigned long long uartsim_get_cycles(void);
+
+
+/*-------------------------------------------------------------------------*/
+
+/* The register offsets of the UART area. */
+typedef enum UARTSIM_REGISTER_ENUM
+{
+	UARTSIM_REGISTER_uartdr       = 0,
+	UARTSIM_REGISTER_uartrsr      = 1,
+	UARTSIM_REGISTER_uartlcr_h    = 2,
+	UARTSIM_REGISTER_uartlcr_m    = 3,
+	UARTSIM_REGISTER_uartlcr_l    = 4,
+	UARTSIM_REGISTER_uartcr       = 5,
+	UARTSIM_REGISTER_uartfr       = 6,
+	UARTSIM_REGISTER_uartiir      = 7,
+	UARTSIM_REGISTER_uartilpr     = 8,
+	UARTSIM_REGISTER_uartrts      = 9,
+	UARTSIM_REGISTER_uartforerun  = 10,
+	UARTSIM_REGISTER_uarttrail    = 11,
+	UARTSIM_REGISTER_uartdrvout   = 12,
+	UARTSIM_REGISTER_uartcr_2     = 13,
+	UARTSIM_REGISTER_uartrxiflsel = 14,
+	UARTSIM_REGISTER_uarttxiflsel = 15,
+	UARTSIM_REGISTER_COUNT        = 16
+} UARTSIM_REGISTER_T;
+
+
+#define MSK_UARTSIM_uartfr_CTS               0x00000001U
+#define MSK_UARTSIM_uartfr_DSR               0x00000002U
+#define MSK_UARTSIM_uartfr_DCD               0x00000004U
+#define MSK_UARTSIM_uartfr_BUSY              0x00000008U
+#define MSK_UARTSIM_uartfr_RXFE              0x00000010U
+#define MSK_UARTSIM_uartfr_TXFF              0x00000020U
+#define MSK_UARTSIM_uartfr_RXFF              0x00000040U
+#define MSK_UARTSIM_uartfr_TXFE              0x00000080U
+
+#define MSK_UARTSIM_uartrsr_FE               0x00000001U
+#define MSK_UARTSIM_uartrsr_PE               0x00000002U
+#define MSK_UARTSIM_uartrsr_BE               0x00000004U
+#define MSK_UARTSIM_uartrsr_OE               0x00000008U
+
+#define MSK_UARTSIM_uartlcr_h_BRK            0x00000001U
+#define MSK_UARTSIM_uartlcr_h_PEN            0x00000002U
+#define MSK_UARTSIM_uartlcr_h_EPS            0x00000004U
+#define MSK_UARTSIM_uartlcr_h_STP2           0x00000008U
+#define MSK_UARTSIM_uartlcr_h_FEN            0x00000010U
+#define MSK_UARTSIM_uartlcr_h_WLEN           0x00000060U
+#define SRT_UARTSIM_uartlcr_h_WLEN           5
+
+#define MSK_UARTSIM_uartcr_uartEN            0x00000001U
+#define MSK_UARTSIM_uartcr_SIREN             0x00000002U
+#define MSK_UARTSIM_uartcr_SIRLP             0x00000004U
+#define MSK_UARTSIM_uartcr_MSIE              0x00000008U
+#define MSK_UARTSIM_uartcr_RIE               0x00000010U
+#define MSK_UARTSIM_uartcr_TIE               0x00000020U
+#define MSK_UARTSIM_uartcr_RTIE              0x00000040U
+#define MSK_UARTSIM_uartcr_LBE               0x00000080U
+
+#define MSK_UARTSIM_uartrts_AUTO             0x00000001U
+#define MSK_UARTSIM_uartrts_RTS_pol          0x00000002U
+#define MSK_UARTSIM_uartrts_CTS_ctr          0x00000004U
+#define MSK_UARTSIM_uartrts_CTS_pol          0x00000008U
+#define MSK_UARTSIM_uartrts_MOD2             0x00000010U
+#define MSK_UARTSIM_uartrts_COUNT            0x00000020U
+
+#define MSK_UARTSIM_uartdrvout_DRVTX         0x00000001U
+#define MSK_UARTSIM_uartdrvout_DRVRTS        0x00000002U
+
+#define MSK_UARTSIM_uartcr_2_Baud_Rate_Mode  0x00000001U
+
+
+/*-------------------------------------------------------------------------*/
+
+class UartSim;
+
+
+/* One register of the simulated UART.
+ * All reads and writes are forwarded to the model. This is the only reason
+ * why the host build is C++.
+ */
+class UartSimRegister
+{
+public:
+	UartSimRegister(UartSim *ptSim, UARTSIM_REGISTER_T tRegister);
+
+	operator unsigned long() const;
+	UartSimRegister &operator=(unsigned long ulValue);
+	UartSimRegister &operator=(const UartSimRegister &tOther);
+
+private:
+	UartSim *m_ptSim;
+	UARTSIM_REGISTER_T m_tRegister;
+};
+
+
+
+typedef struct UARTSIM_UART_AREA_STRUCT
+{
+	UARTSIM_UART_AREA_STRUCT(UartSim *ptSim);
+
+	UartSimRegister ulUartdr;
+	UartSimRegister ulUartrsr;
+	UartSimRegister ulUartlcr_h;
+	UartSimRegister ulUartlcr_m;
+	UartSimRegister ulUartlcr_l;
+	UartSimRegister ulUartcr;
+	UartSimRegister ulUartfr;
+	UartSimRegister ulUartiir;
+	UartSimRegister ulUartilpr;
+	UartSimRegister ulUartrts;
+	UartSimRegister ulUartforerun;
+	UartSimRegister ulUarttrail;
+	UartSimRegister ulUartdrvout;
+	UartSimRegister ulUartcr_2;
+	UartSimRegister ulUartrxiflsel;
+	UartSimRegister ulUarttxiflsel;
+} UARTSIM_UART_AREA_T;
+
+
+
+/* Access counters of one UART. */
+typedef struct UARTSIM_STATISTICS_STRUCT
+{
+	unsigned long ulReadsFr;
+	/* The flag reads which were followed by a data access. The others only
+	 * waited for the FIFO.
+	 */
+	unsigned long ulReadsFrUsed;
+	unsigned long ulReadsDr;
+	unsigned long ulWritesDr;
+	/* The reads of the receive status register. */
+	unsigned long ulReadsRsr;
+	unsigned long ulOtherAccesses;
+	unsigned long ulTxBytes;
+	unsigned long ulRxBytes;
+	unsigned long ulRxOverruns;
+	unsigned long ulTxDropped;
+} UARTSIM_STATISTICS_T;
+
+
+
+/* A peer is called for every byte which left the TX shift register. */
+typedef std::function<void(UartSim &tUart, unsigned char ucData, UARTSIM_TIME_T tTime)> UARTSIM_PEER_T;
+
+
+
+class UartSim
+{
+public:
+	UartSim(void);
+
+	/* This is the area which is seen by the firmware. */
+	UARTSIM_UART_AREA_T tArea;
+
+	/* Put the UART back to the power-on state and clear all statistics. */
+	void reset(void);
+
+	/* Register access from the firmware. */
+	unsigned long read(UARTSIM_REGISTER_T tRegister);
+	void write(UARTSIM_REGISTER_T tRegister, unsigned long ulValue);
+
+	/* Process all events up to the given time. */
+	void update_tx(UARTSIM_TIME_T tNow);
+	void update_rx(UARTSIM_TIME_T tNow);
+
+	/* Configure the line side. */
+	void set_peer(UARTSIM_PEER_T tPeer);
+	void set_peer_loopback(void);
+	void set_peer_echo(UARTSIM_TIME_T tLatency);
+	void set_peer_none(void);
+
+	/* The hardware handshake. The CTS input of the UART is active after a
+	 * reset.
+	 */
+	void set_peer_cts(bool fActive);
+
+	/* Send data from the line side to the RX pin.
+	 * The bytes are transferred back to back with the current character
+	 * time, starting not earlier than tStart.
+	 */
+	void peer_send(const unsigned char *pucData, size_t sizData, UARTSIM_TIME_T tStart);
+	/* Place one character on the RX pin which is complete at tArrival. */
+	void peer_send_char(unsigned long ulValue, UARTSIM_TIME_T tArrival);
+
+	/* Get the current settings. */
+	unsigned long get_baud_rate(void) const;
+	UARTSIM_TIME_T get_char_time(void) const;
+
+	const UARTSIM_STATISTICS_T &get_statistics(void) const;
+	void clear_statistics(void);
+
+	/* All bytes which were sent by the firmware. */
+	std::vector<unsigned char> atTxLog;
+
+private:
+	unsigned long get_flags(void);
+	void start_next_tx(UARTSIM_TIME_T tStart);
+
+	unsigned long m_aulRegister[UARTSIM_REGISTER_COUNT];
+	bool m_fLastAccessFr;
+
+	/* The TX FIFO and the shift register. */
+	std::deque<unsigned char> m_tTxFifo;
+	bool m_fTxShiftActive;
+	unsigned char m_ucTxShift;
+	UARTSIM_TIME_T m_tTxShiftDone;
+
+	/* The RX line carries characters with their arrival time. */
+	typedef struct RX_CHAR_STRUCT
+	{
+		UARTSIM_TIME_T tArrival;
+		unsigned long ulValue;
+	} RX_CHAR_T;
+	std::deque<RX_CHAR_T> m_tRxLine;
+	std::deque<unsigned long> m_tRxFifo;
+	UARTSIM_TIME_T m_tPeerLineFree;
+
+	bool m_fCtsActive;
+
+	UARTSIM_PEER_T m_tPeer;
+	UARTSIM_STATISTICS_T m_tStatistics;
+};
+
+
+/* The UART instances of the host simulation. */
+extern UartSim tUartSim_uart0;
+extern UartSim tUartSim_uart1;
+extern UartSim tUartSim_uart2;
+
+#define UARTSIM_FIFO_DEPTH 16
+
+
+#endif  /* __UART_SIM_H__ */
@@ -9,7 +9,9 @@ typedef enum UART_CMD_ENUM
 {
 	UART_CMD_Open = 0,
 	UART_CMD_RunSequence = 1,
-	UART_CMD_Close = 2
+	UART_CMD_Close = 2,
+	UART_CMD_Serve = 3,
+	UART_CMD_RunSequences = 4
 } UART_CMD_T;
 
 
@@ -20,11 +22,349 @@ typedef enum UART_SEQ_COMMAND_ENUM
 	UART_SEQ_COMMAND_Send = 1,
 	UART_SEQ_COMMAND_Receive = 2,
 	UART_SEQ_COMMAND_BaudRate = 3,
-	UART_SEQ_COMMAND_Delay = 4
+	UART_SEQ_COMMAND_Delay = 4,
+	UART_SEQ_COMMAND_Transceive = 5,
+	UART_SEQ_COMMAND_Expect = 6,
+	UART_SEQ_COMMAND_ReceiveUntil = 7,
+	UART_SEQ_COMMAND_ReceiveIdle = 8,
+	UART_SEQ_COMMAND_ReceiveUs = 9,
+	UART_SEQ_COMMAND_DelayUs = 10,
+	UART_SEQ_COMMAND_Repeat = 11,
+	UART_SEQ_COMMAND_EndRepeat = 12,
+	UART_SEQ_COMMAND_Bert = 13,
+	UART_SEQ_COMMAND_ReceiveTimestamps = 14,
+	UART_SEQ_COMMAND_BaudSweep = 15,
+	UART_SEQ_COMMAND_AutoBaud = 16,
+	UART_SEQ_COMMAND_Benchmark = 17,
+	UART_SEQ_COMMAND_JumpIf = 18,
+	UART_SEQ_COMMAND_RegisterLoad = 19,
+	UART_SEQ_COMMAND_RegisterOp = 20,
+	UART_SEQ_COMMAND_SendRegisters = 21,
+	UART_SEQ_COMMAND_CrcAppend = 22,
+	UART_SEQ_COMMAND_CrcVerify = 23,
+	UART_SEQ_COMMAND_SendPattern = 24,
+	UART_SEQ_COMMAND_SendLong = 25,
+	UART_SEQ_COMMAND_ReceiveLong = 26
 } UART_SEQ_COMMAND_T;
 
 
 
+/* The flags of the expect command. */
+typedef enum UART_SEQ_EXPECT_FLAG_ENUM
+{
+	UART_SEQ_EXPECT_FLAG_Mask = 0x01,
+	UART_SEQ_EXPECT_FLAG_Stop = 0x02
+} UART_SEQ_EXPECT_FLAG_T;
+
+
+
+/* The flags of the repeat command. */
+typedef enum UART_SEQ_REPEAT_FLAG_ENUM
+{
+	UART_SEQ_REPEAT_FLAG_Overwrite = 0x01
+} UART_SEQ_REPEAT_FLAG_T;
+
+
+
+/* The flags of the jump command. The jump is taken if the last received
+ * bytes match the data. "Not" takes it if they do not match.
+ */
+typedef enum UART_SEQ_JUMP_FLAG_ENUM
+{
+	UART_SEQ_JUMP_FLAG_Mask = 0x01,
+	UART_SEQ_JUMP_FLAG_Not = 0x02,
+	UART_SEQ_JUMP_FLAG_Remove = 0x04
+} UART_SEQ_JUMP_FLAG_T;
+
+
+
+/* A sequence has a few registers with 32 bits. They are 0 when the
+ * sequence starts. The registers are loaded from the received data and
+ * sent with the SendRegisters command.
+ */
+typedef enum UART_SEQ_REGISTER_ENUM
+{
+	UART_SEQ_REGISTER_Count = 8
+} UART_SEQ_REGISTER_T;
+
+/* The flags of the register load command and of the placeholders.
+ * FromEnd counts the offset back from the end of the received data.
+ */
+typedef enum UART_SEQ_REGISTER_FLAG_ENUM
+{
+	UART_SEQ_REGISTER_FLAG_BigEndian = 0x01,
+	UART_SEQ_REGISTER_FLAG_FromEnd = 0x02
+} UART_SEQ_REGISTER_FLAG_T;
+
+/* The operations of the RegisterOp command. */
+typedef enum UART_SEQ_REGISTER_OP_ENUM
+{
+	UART_SEQ_REGISTER_OP_Set = 0,
+	UART_SEQ_REGISTER_OP_Add = 1
+} UART_SEQ_REGISTER_OP_T;
+
+
+
+/* The CRCs of the CrcAppend and CrcVerify commands. */
+typedef enum UART_SEQ_CRC_ENUM
+{
+	UART_SEQ_CRC_Modbus = 0,
+	UART_SEQ_CRC_Ccitt = 1,
+	UART_SEQ_CRC_Crc32 = 2
+} UART_SEQ_CRC_T;
+
+/* CrcAppend can use this many of the last sent bytes. */
+typedef enum UART_SEQ_CRC_HISTORY_ENUM
+{
+	UART_SEQ_CRC_HistorySize = 256
+} UART_SEQ_CRC_HISTORY_T;
+
+/* The flags of the CrcVerify command. A wrong CRC counts as one expect
+ * mismatch at the position of the CRC. Remove drops the CRC from the
+ * receive buffer. Stop lets the command fail for a wrong CRC. Status adds
+ * one byte to the receive buffer, which is 0 for a good CRC and 1 for a
+ * wrong one. The jump command can test it.
+ */
+typedef enum UART_SEQ_CRC_FLAG_ENUM
+{
+	UART_SEQ_CRC_FLAG_Remove = 0x01,
+	UART_SEQ_CRC_FLAG_Stop = 0x02,
+	UART_SEQ_CRC_FLAG_Status = 0x04
+} UART_SEQ_CRC_FLAG_T;
+
+
+
+/* The generated data of the SendPattern command. The command sends a block
+ * several times. Fill sends the value for every byte. Counter starts with
+ * the value and increments it for every byte, also over the block borders.
+ * Block sends the data after the command.
+ */
+typedef enum UART_SEQ_PATTERN_ENUM
+{
+	UART_SEQ_PATTERN_Fill = 0,
+	UART_SEQ_PATTERN_Counter = 1,
+	UART_SEQ_PATTERN_Block = 2
+} UART_SEQ_PATTERN_T;
+
+
+
+/* The pseudo random bit sequences of the BERT command. The value is the
+ * length of the shift register.
+ */
+typedef enum UART_SEQ_PRBS_ENUM
+{
+	UART_SEQ_PRBS_7 = 7,
+	UART_SEQ_PRBS_15 = 15,
+	UART_SEQ_PRBS_23 = 23,
+	UART_SEQ_PRBS_31 = 31
+} UART_SEQ_PRBS_T;
+
+
+
+/* The BERT command writes this result to the receive buffer. */
+typedef struct UART_SEQ_BERT_RESULT_STRUCT
+{
+	uint32_t ulBytesSent;
+	uint32_t ulBytesReceived;
+	uint32_t ulByteErrors;
+	uint32_t ulBitErrors;
+	uint32_t ulFirstErrorOffset;
+	uint32_t ulElapsedMs;
+} UART_SEQ_BERT_RESULT_T;
+
+
+
+/* The baud sweep command runs a short BERT for each divider in a range.
+ * It writes a header with the number of records (16 bit) and then one
+ * record for each divider. The records are not aligned. The counters
+ * saturate at 0xffff.
+ */
+typedef enum UART_SEQ_BAUD_SWEEP_ENUM
+{
+	UART_SEQ_BAUD_SWEEP_HeaderSize = 2
+} UART_SEQ_BAUD_SWEEP_T;
+
+typedef struct UART_SEQ_BAUD_SWEEP_RECORD_STRUCT
+{
+	uint16_t usDivider;
+	uint16_t usBytesReceived;
+	uint16_t usByteErrors;
+	uint16_t usBitErrors;
+} UART_SEQ_BAUD_SWEEP_RECORD_T;
+
+
+
+/* The auto baud command measures 2 to UART_SEQ_AUTOBAUD_EdgesMax edges. */
+typedef enum UART_SEQ_AUTOBAUD_ENUM
+{
+	UART_SEQ_AUTOBAUD_EdgesMax = 32
+} UART_SEQ_AUTOBAUD_T;
+
+/* The auto baud command writes this result to the receive buffer. The
+ * measured baud rate is rounded to a standard baud rate if it is close
+ * enough. The UART uses ulBaudRate after the command.
+ */
+typedef struct UART_SEQ_AUTOBAUD_RESULT_STRUCT
+{
+	uint32_t ulMeasuredBaudRate;
+	uint32_t ulBaudRate;
+} UART_SEQ_AUTOBAUD_RESULT_T;
+
+
+
+/* The benchmark command sends a counter and receives it at the same time.
+ * This needs a loopback, either the internal one of the open command or a
+ * connection from TX to RX. It writes this result to the receive buffer.
+ * The elapsed time starts with the first byte and ends with the last
+ * received byte. The busy ticks are the CPU cycles (see "ticks.h") for
+ * moving the data, without the polls which found nothing to do. The
+ * maximum RX fill is the largest number of bytes which were waiting in the
+ * RX FIFO for one read.
+ */
+typedef struct UART_SEQ_BENCHMARK_RESULT_STRUCT
+{
+	uint32_t ulBytesSent;
+	uint32_t ulBytesReceived;
+	uint32_t ulByteErrors;
+	uint32_t ulElapsedUs;
+	uint32_t ulBusyTicks;
+	uint32_t ulPolls;
+	uint32_t ulMaxRxFill;
+} UART_SEQ_BENCHMARK_RESULT_T;
+
+
+
+/* The receive idle command measures the idle gap in microseconds. A gap
+ * must be at least UART_SEQ_RECEIVE_IDLE_GapMinMs, as a shorter one can end
+ * the command between two characters at low baud rates. The maximum
+ * depends on the ticks of the netX (see TICKS_MAX_US in "ticks.h").
+ */
+typedef enum UART_SEQ_RECEIVE_IDLE_ENUM
+{
+	UART_SEQ_RECEIVE_IDLE_GapMinMs = 2
+} UART_SEQ_RECEIVE_IDLE_T;
+
+
+
+/* The receive until command writes this header in front of the data.
+ * The pattern index is 0xff if the maximum size was reached before any
+ * pattern matched.
+ */
+typedef enum UART_SEQ_RECEIVE_UNTIL_ENUM
+{
+	UART_SEQ_RECEIVE_UNTIL_HeaderSize = 3,
+	UART_SEQ_RECEIVE_UNTIL_NoMatch = 0xff
+} UART_SEQ_RECEIVE_UNTIL_T;
+
+
+
+/* The receive timestamps command writes a header with the size of the
+ * received data (16 bit) and the size of the timestamps (32 bit), the
+ * received data and then the timestamps. There is one
+ * timestamp for each byte. It is the time in microseconds since the
+ * previous byte or the start of the command for the first byte. Each
+ * timestamp is stored in 7 bit groups, starting with the lowest. Bit 7 is
+ * set in all groups except the last one.
+ */
+typedef enum UART_SEQ_RECEIVE_TIMESTAMPS_ENUM
+{
+	UART_SEQ_RECEIVE_TIMESTAMPS_HeaderSize = 6,
+	UART_SEQ_RECEIVE_TIMESTAMPS_DeltaSizeMax = 4
+} UART_SEQ_RECEIVE_TIMESTAMPS_T;
+
+
+
+/* A run sequence command with telemetry writes one record for each executed
+ * command to the end of the receive buffer. The records are not aligned.
+ * The status is 0 for a successful command and 1 for a failed one. The
+ * bytes are all bytes which the command moved through the UART. The ticks
+ * are CPU cycles (see "ticks.h"). A poll is one read of the flag register.
+ */
+typedef struct UART_SEQ_TELEMETRY_RECORD_STRUCT
+{
+	uint8_t ucCommand;
+	uint8_t ucStatus;
+	uint16_t usReserved;
+	uint32_t ulBytes;
+	uint32_t ulTicks;
+	uint32_t ulPolls;
+} UART_SEQ_TELEMETRY_RECORD_T;
+
+
+
+/* The events of the trace. */
+typedef enum UART_TRACE_EVENT_ENUM
+{
+	UART_TRACE_EVENT_SequenceStart = 1,    /* usParameter: -, ulValue: size of the sequence */
+	UART_TRACE_EVENT_SequenceEnd = 2,      /* usParameter: 0 for OK, 1 for error, ulValue: size of the received data */
+	UART_TRACE_EVENT_CommandStart = 3,     /* usParameter: command, ulValue: offset of the command in the sequence */
+	UART_TRACE_EVENT_CommandEnd = 4,       /* usParameter: command | status<<8, ulValue: bytes */
+	UART_TRACE_EVENT_TimeoutTotal = 5,     /* usParameter: command, ulValue: bytes */
+	UART_TRACE_EVENT_TimeoutChar = 6,      /* usParameter: command, ulValue: bytes */
+	UART_TRACE_EVENT_RxError = 7           /* usParameter: receive status register, ulValue: offset in the receive buffer */
+} UART_TRACE_EVENT_T;
+
+
+/* One entry of the trace. The ticks are the CPU cycles (see "ticks.h"). */
+typedef struct UART_TRACE_ENTRY_STRUCT
+{
+	uint8_t ucEvent;
+	uint8_t ucUart;
+	uint16_t usParameter;
+	uint32_t ulValue;
+	uint32_t ulTicks;
+} UART_TRACE_ENTRY_T;
+
+
+/* The trace is a ring buffer in the RAM of the netX. It is set up by the
+ * host with the open command. The netX writes the entries without any
+ * formatting, the host reads them when they are needed.
+ * ulWriteCount counts all entries since the start of the trace. The next
+ * entry is written to atEntries[ulWriteCount % ulEntries].
+ */
+typedef struct UART_TRACE_STRUCT
+{
+	volatile uint32_t ulWriteCount;
+	uint32_t ulEntries;
+	UART_TRACE_ENTRY_T atEntries[];
+} UART_TRACE_T;
+
+
+
+/* The hardware handshake of the open command.
+ * With CTS the transmitter waits while the CTS input is inactive. The netX
+ * UART has no RTS which follows the RX FIFO, so only CTS is supported.
+ */
+typedef enum UART_FLOW_CONTROL_ENUM
+{
+	UART_FLOW_CONTROL_Cts = 0x01
+} UART_FLOW_CONTROL_T;
+
+/* The receive errors. The value is the index in the counters of the
+ * sequence result and the byte in ulRxErrorActions of the open command.
+ */
+typedef enum UART_RX_ERROR_ENUM
+{
+	UART_RX_ERROR_Overrun = 0,
+	UART_RX_ERROR_Framing = 1,
+	UART_RX_ERROR_Parity = 2,
+	UART_RX_ERROR_Break = 3
+} UART_RX_ERROR_T;
+
+#define UART_RX_ERROR_COUNT 4
+
+/* The reaction on a receive error. The errors are checked once for each
+ * burst of received bytes. Each error type is counted once per burst.
+ * Mark also stores the offset of the first burst with an error in the
+ * receive buffer. Stop does the same and lets the command fail.
+ */
+typedef enum UART_RX_ERROR_ACTION_ENUM
+{
+	UART_RX_ERROR_ACTION_Continue = 0,
+	UART_RX_ERROR_ACTION_Mark = 1,
+	UART_RX_ERROR_ACTION_Stop = 2
+} UART_RX_ERROR_ACTION_T;
+
 typedef struct UART_PARAMETER_OPEN_STRUCT
 {
 	uint32_t ptHandle;
@@ -32,6 +372,29 @@ typedef struct UART_PARAMETER_OPEN_STRUCT
 	uint32_t ulBaudRate;
 	uint8_t  aucMMIO[4];
 	uint16_t ausPortcontrol[4];
+	/* The trace buffer. Set the size to 0 to keep the current trace. */
+	uint32_t ptTrace;
+	uint32_t sizTrace;
+	/* A combination of UART_FLOW_CONTROL_T flags. With CTS a send fails if
+	 * the TX FIFO is not empty after ulTimeoutCtsMs. It must not be 0.
+	 */
+	uint32_t ulFlowControl;
+	uint32_t ulTimeoutCtsMs;
+	/* One UART_RX_ERROR_ACTION_T for each UART_RX_ERROR_T. The action for
+	 * an error is in bits 8*error to 8*error+7.
+	 */
+	uint32_t ulRxErrorActions;
+	/* Set this to 1 to connect TX with RX inside the UART. The pins are
+	 * not used for the data then.
+	 */
+	uint32_t ulLoopback;
+	/* Reject baud rates with a larger error, also in the BaudRate command.
+	 * Set this to 0 to accept all errors.
+	 */
+	uint32_t ulMaxErrorPpm;
+	/* The real baud rate and its error. */
+	uint32_t ulAchievedBaudRate;
+	int32_t lBaudRateErrorPpm;
 } UART_PARAMETER_OPEN_T;
 
 
@@ -44,10 +407,42 @@ typedef struct UART_PARAMETER_RUN_SEQUENCE_STRUCT
 	uint8_t *pucReceivedData;
 	uint32_t sizReceivedDataMax;
 	uint32_t sizReceivedData;
+	uint32_t ulExpectMismatches;
+	uint32_t ulExpectFirstMismatch;
+	/* Reserve space for this number of telemetry records at the end of
+	 * the receive buffer. 0 disables the telemetry.
+	 */
+	uint32_t ulTelemetryMax;
+	/* The number of executed commands. Only the first ulTelemetryMax
+	 * records are stored.
+	 */
+	uint32_t ulTelemetryRecords;
+	/* The real baud rate and its error at the end of the sequence. */
+	uint32_t ulAchievedBaudRate;
+	int32_t lBaudRateErrorPpm;
+	/* The receive errors of the sequence, indexed by UART_RX_ERROR_T. */
+	uint32_t aulRxErrors[UART_RX_ERROR_COUNT];
+	/* The offset of the first marked error in the receive buffer. This is
+	 * 0xffffffff if no error was marked.
+	 */
+	uint32_t ulRxErrorFirstOffset;
 } UART_PARAMETER_RUN_SEQUENCE_T;
 
 
 
+/* Run one sequence on each of several UARTs at the same time.
+ * ptSequences points to an array of sizSequences run sequence parameters.
+ * Each entry must use a different handle. The results are written to the
+ * entries.
+ */
+typedef struct UART_PARAMETER_RUN_SEQUENCES_STRUCT
+{
+	uint32_t sizSequences;
+	uint32_t ptSequences;
+} UART_PARAMETER_RUN_SEQUENCES_T;
+
+
+
 typedef struct UART_PARAMETER_CLOSE_STRUCT
 {
 	uint32_t ptHandle;
@@ -55,6 +450,13 @@ typedef struct UART_PARAMETER_CLOSE_STRUCT
 
 
 
+typedef struct UART_PARAMETER_SERVE_STRUCT
+{
+	uint32_t ptMailbox;
+} UART_PARAMETER_SERVE_T;
+
+
+
 typedef struct UART_PARAMETER_STRUCT
 {
 	uint32_t ulVerbose;
@@ -63,11 +465,29 @@ typedef struct UART_PARAMETER_STRUCT
 		UART_PARAMETER_OPEN_T tOpen;
 		UART_PARAMETER_RUN_SEQUENCE_T tRunSequence;
 		UART_PARAMETER_CLOSE_T tClose;
+		UART_PARAMETER_SERVE_T tServe;
+		UART_PARAMETER_RUN_SEQUENCES_T tRunSequences;
 	} uParameter;
 } UART_PARAMETER_T;
 
 
 
+/* The mailbox of the server mode.
+ * The host writes a command to tParameter and sets ulRequest to a new value.
+ * The server executes the command, writes the result to ulResult and copies
+ * ulRequest to ulAcknowledge.
+ * The command UART_CMD_Serve stops the server.
+ */
+typedef struct UART_MAILBOX_STRUCT
+{
+	volatile uint32_t ulAcknowledge;
+	volatile uint32_t ulResult;
+	UART_PARAMETER_T tParameter;
+	volatile uint32_t ulRequest;
+} UART_MAILBOX_T;
+
+
+
 typedef enum TEST_RESULT_ENUM
 {
 	TEST_RESULT_OK = 0,
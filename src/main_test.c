@@ -23,10 +23,16 @@
 
 #include <string.h>
 
+#include "baudrate.h"
+#include "crc.h"
 #include "netx_io_areas.h"
+#include "pattern_match.h"
 #include "portcontrol.h"
+#include "prbs.h"
 #include "rdy_run.h"
 #include "systime.h"
+#include "ticks.h"
+#include "trace.h"
 #include "uprintf.h"
 #include "version.h"
 
@@ -40,6 +46,15 @@ typedef struct UART_HANDLE_STRUCT
 	unsigned long ulUartIndex;
 	unsigned long ulCurrentBaudRate;
 	unsigned long ulCurrentDeviceSpecificSpeedValue;
+	/* The real baud rate and its deviation from ulCurrentBaudRate. */
+	unsigned long ulAchievedBaudRate;
+	long lBaudRateErrorPpm;
+	/* Reject all baud rates with a larger deviation. 0 accepts all. */
+	unsigned long ulMaxErrorPpm;
+	/* The UART_RX_ERROR_ACTION_T for each UART_RX_ERROR_T. */
+	unsigned long ulRxErrorActions;
+	/* The longest wait for the transmitter with CTS. 0 without CTS. */
+	unsigned long ulTimeoutCtsMs;
 } UART_HANDLE_T;
 
 
@@ -72,9 +87,114 @@ typedef union UART_SEQ_COMMAND_READ_UNION
 
 
 
+/* The extended commands have 32 bit sizes and timeouts. */
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_WRITE_LONG_STRUCT
+{
+        uint32_t ulDataSize;
+};
+
+typedef union UART_SEQ_COMMAND_WRITE_LONG_UNION
+{
+        struct UART_SEQ_COMMAND_WRITE_LONG_STRUCT s;
+        unsigned char auc[4];
+} UART_SEQ_COMMAND_WRITE_LONG_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_READ_LONG_STRUCT
+{
+        uint32_t ulDataSize;
+        uint32_t ulTimeoutTotalMs;
+        uint32_t ulTimeoutCharMs;
+};
+
+typedef union UART_SEQ_COMMAND_READ_LONG_UNION
+{
+        struct UART_SEQ_COMMAND_READ_LONG_STRUCT s;
+        unsigned char auc[12];
+} UART_SEQ_COMMAND_READ_LONG_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_READ_US_STRUCT
+{
+        unsigned short usDataSize;
+        uint32_t ulTimeoutTotalUs;
+        uint32_t ulTimeoutCharUs;
+};
+
+typedef union UART_SEQ_COMMAND_READ_US_UNION
+{
+        struct UART_SEQ_COMMAND_READ_US_STRUCT s;
+        unsigned char auc[10];
+} UART_SEQ_COMMAND_READ_US_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_TRANSCEIVE_STRUCT
+{
+        unsigned short usSendSize;
+        unsigned short usReceiveSize;
+        unsigned short usTimeoutTotalMs;
+        unsigned short usTimeoutCharMs;
+};
+
+typedef union UART_SEQ_COMMAND_TRANSCEIVE_UNION
+{
+        struct UART_SEQ_COMMAND_TRANSCEIVE_STRUCT s;
+        unsigned char auc[8];
+} UART_SEQ_COMMAND_TRANSCEIVE_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_EXPECT_STRUCT
+{
+        unsigned short usDataSize;
+        unsigned char ucFlags;
+};
+
+typedef union UART_SEQ_COMMAND_EXPECT_UNION
+{
+        struct UART_SEQ_COMMAND_EXPECT_STRUCT s;
+        unsigned char auc[3];
+} UART_SEQ_COMMAND_EXPECT_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_RECEIVE_UNTIL_STRUCT
+{
+        unsigned short usDataSize;
+        unsigned short usTimeoutTotalMs;
+        unsigned short usTimeoutCharMs;
+        unsigned char ucPatterns;
+};
+
+typedef union UART_SEQ_COMMAND_RECEIVE_UNTIL_UNION
+{
+        struct UART_SEQ_COMMAND_RECEIVE_UNTIL_STRUCT s;
+        unsigned char auc[7];
+} UART_SEQ_COMMAND_RECEIVE_UNTIL_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_RECEIVE_IDLE_STRUCT
+{
+        unsigned short usDataSize;
+        unsigned short usTimeoutTotalMs;
+        unsigned short usIdleGapMs;
+};
+
+typedef union UART_SEQ_COMMAND_RECEIVE_IDLE_UNION
+{
+        struct UART_SEQ_COMMAND_RECEIVE_IDLE_STRUCT s;
+        unsigned char auc[6];
+} UART_SEQ_COMMAND_RECEIVE_IDLE_T;
+
+
+
 struct __attribute__((__packed__)) UART_SEQ_COMMAND_BAUDRATE_STRUCT
 {
-        unsigned long ulBaudRate;
+        uint32_t ulBaudRate;
 };
 
 typedef union UART_SEQ_COMMAND_BAUDRATE_UNION
@@ -85,9 +205,23 @@ typedef union UART_SEQ_COMMAND_BAUDRATE_UNION
 
 
 
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_AUTOBAUD_STRUCT
+{
+        unsigned char ucEdges;
+        unsigned short usTimeoutTotalMs;
+};
+
+typedef union UART_SEQ_COMMAND_AUTOBAUD_UNION
+{
+        struct UART_SEQ_COMMAND_AUTOBAUD_STRUCT s;
+        unsigned char auc[3];
+} UART_SEQ_COMMAND_AUTOBAUD_T;
+
+
+
 struct __attribute__((__packed__)) UART_SEQ_COMMAND_DELAY_STRUCT
 {
-        unsigned long ulDelayInMs;
+        uint32_t ulDelayInMs;
 };
 
 typedef union UART_SEQ_COMMAND_DELAY_UNION
@@ -98,51 +232,313 @@ typedef union UART_SEQ_COMMAND_DELAY_UNION
 
 
 
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_DELAY_US_STRUCT
+{
+        uint32_t ulDelayInUs;
+};
+
+typedef union UART_SEQ_COMMAND_DELAY_US_UNION
+{
+        struct UART_SEQ_COMMAND_DELAY_US_STRUCT s;
+        unsigned char auc[4];
+} UART_SEQ_COMMAND_DELAY_US_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_REPEAT_STRUCT
+{
+        uint32_t ulCount;
+        unsigned char ucFlags;
+};
+
+typedef union UART_SEQ_COMMAND_REPEAT_UNION
+{
+        struct UART_SEQ_COMMAND_REPEAT_STRUCT s;
+        unsigned char auc[5];
+} UART_SEQ_COMMAND_REPEAT_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_BERT_STRUCT
+{
+        unsigned char ucPrbs;
+        uint32_t ulSize;
+        uint32_t ulTimeoutCharUs;
+        uint32_t ulSeed;
+};
+
+typedef union UART_SEQ_COMMAND_BERT_UNION
+{
+        struct UART_SEQ_COMMAND_BERT_STRUCT s;
+        unsigned char auc[13];
+} UART_SEQ_COMMAND_BERT_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_BAUD_SWEEP_STRUCT
+{
+        unsigned char ucPrbs;
+        unsigned short usDividerFirst;
+        unsigned short usDividerLast;
+        unsigned short usDividerStep;
+        unsigned short usSize;
+        uint32_t ulTimeoutCharUs;
+};
+
+typedef union UART_SEQ_COMMAND_BAUD_SWEEP_UNION
+{
+        struct UART_SEQ_COMMAND_BAUD_SWEEP_STRUCT s;
+        unsigned char auc[13];
+} UART_SEQ_COMMAND_BAUD_SWEEP_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_BENCHMARK_STRUCT
+{
+        uint32_t ulBaudRate;
+        uint32_t ulSize;
+        uint32_t ulTimeoutCharUs;
+};
+
+typedef union UART_SEQ_COMMAND_BENCHMARK_UNION
+{
+        struct UART_SEQ_COMMAND_BENCHMARK_STRUCT s;
+        unsigned char auc[12];
+} UART_SEQ_COMMAND_BENCHMARK_T;
+
+
+
+/* The offset of the jump target is relative to the end of the command. */
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_JUMP_STRUCT
+{
+        unsigned char ucFlags;
+        unsigned char ucLeave;
+        int16_t sOffset;
+        unsigned short usDataSize;
+};
+
+typedef union UART_SEQ_COMMAND_JUMP_UNION
+{
+        struct UART_SEQ_COMMAND_JUMP_STRUCT s;
+        unsigned char auc[6];
+} UART_SEQ_COMMAND_JUMP_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_REGISTER_LOAD_STRUCT
+{
+        unsigned char ucRegister;
+        unsigned char ucFlags;
+        unsigned short usOffset;
+        unsigned char ucSize;
+};
+
+typedef union UART_SEQ_COMMAND_REGISTER_LOAD_UNION
+{
+        struct UART_SEQ_COMMAND_REGISTER_LOAD_STRUCT s;
+        unsigned char auc[5];
+} UART_SEQ_COMMAND_REGISTER_LOAD_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_REGISTER_OP_STRUCT
+{
+        unsigned char ucRegister;
+        unsigned char ucOperation;
+        uint32_t ulValue;
+};
+
+typedef union UART_SEQ_COMMAND_REGISTER_OP_UNION
+{
+        struct UART_SEQ_COMMAND_REGISTER_OP_STRUCT s;
+        unsigned char auc[6];
+} UART_SEQ_COMMAND_REGISTER_OP_T;
+
+
+
+/* The placeholders follow the header. The data follows the placeholders. */
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_SEND_REGISTERS_STRUCT
+{
+        unsigned short usDataSize;
+        unsigned char ucPlaceholders;
+};
+
+typedef union UART_SEQ_COMMAND_SEND_REGISTERS_UNION
+{
+        struct UART_SEQ_COMMAND_SEND_REGISTERS_STRUCT s;
+        unsigned char auc[3];
+} UART_SEQ_COMMAND_SEND_REGISTERS_T;
+
+
+
+/* A placeholder replaces ucSize bytes at usOffset in the data with a
+ * register.
+ */
+struct __attribute__((__packed__)) UART_SEQ_PLACEHOLDER_STRUCT
+{
+        unsigned short usOffset;
+        unsigned char ucRegister;
+        unsigned char ucSize;
+        unsigned char ucFlags;
+};
+
+typedef union UART_SEQ_PLACEHOLDER_UNION
+{
+        struct UART_SEQ_PLACEHOLDER_STRUCT s;
+        unsigned char auc[5];
+} UART_SEQ_PLACEHOLDER_T;
+
+
+
+/* The data of the Block pattern follows the command. */
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_SEND_PATTERN_STRUCT
+{
+        unsigned char ucPattern;
+        unsigned char ucValue;
+        unsigned short usBlockSize;
+        unsigned short usCount;
+};
+
+typedef union UART_SEQ_COMMAND_SEND_PATTERN_UNION
+{
+        struct UART_SEQ_COMMAND_SEND_PATTERN_STRUCT s;
+        unsigned char auc[6];
+} UART_SEQ_COMMAND_SEND_PATTERN_T;
+
+
+
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_CRC_APPEND_STRUCT
+{
+        unsigned char ucCrc;
+        unsigned short usSize;
+};
+
+typedef union UART_SEQ_COMMAND_CRC_APPEND_UNION
+{
+        struct UART_SEQ_COMMAND_CRC_APPEND_STRUCT s;
+        unsigned char auc[3];
+} UART_SEQ_COMMAND_CRC_APPEND_T;
+
+
+
+/* The size includes the CRC at the end of the frame. */
+struct __attribute__((__packed__)) UART_SEQ_COMMAND_CRC_VERIFY_STRUCT
+{
+        unsigned char ucCrc;
+        unsigned char ucFlags;
+        unsigned short usSize;
+};
+
+typedef union UART_SEQ_COMMAND_CRC_VERIFY_UNION
+{
+        struct UART_SEQ_COMMAND_CRC_VERIFY_STRUCT s;
+        unsigned char auc[4];
+} UART_SEQ_COMMAND_CRC_VERIFY_T;
+
+
+
+/* This is the maximum nesting level of repeat blocks. */
+#define CMD_REPEAT_DEPTH 8
+
+typedef struct CMD_REPEAT_STRUCT
+{
+	const unsigned char *pucCmdStart;
+	unsigned char *pucRecStart;
+	unsigned long ulRemaining;
+	UART_SEQ_REPEAT_FLAG_T tFlags;
+} CMD_REPEAT_T;
+
+
+
 typedef struct CMD_STATE_STRUCT
 {
 	unsigned long ulVerbose;
+	unsigned long ulUartIndex;
+	const unsigned char *pucCmdStart;
 	const unsigned char *pucCmdCnt;
 	const unsigned char *pucCmdEnd;
+	unsigned char *pucRecStart;
 	unsigned char *pucRecCnt;
 	unsigned char *pucRecEnd;
+	unsigned long ulRecDiscarded;
+	unsigned long ulExpectMismatches;
+	unsigned long ulExpectFirstMismatch;
+	unsigned int uiRepeatDepth;
+	CMD_REPEAT_T atRepeat[CMD_REPEAT_DEPTH];
+
+	/* The counters of the running command for the telemetry. */
+	unsigned long ulPolls;
+	unsigned long ulBytes;
+
+	/* The telemetry records are at the end of the receive buffer. They
+	 * are not aligned.
+	 */
+	unsigned char *pucTelemetry;
+	unsigned long ulTelemetryMax;
+	unsigned long ulTelemetryRecords;
+	unsigned long ulTelemetryStart;
+
+	/* The receive errors. A stop action sets iRxErrorStop. All commands
+	 * which check the errors fail then.
+	 */
+	unsigned long ulRxErrorActions;
+	unsigned long aulRxErrors[UART_RX_ERROR_COUNT];
+	unsigned long ulRxErrorFirstOffset;
+	int iRxErrorStop;
+
+	/* The registers of the sequence. */
+	unsigned long aulRegister[UART_SEQ_REGISTER_Count];
+
+	/* The last sent bytes for the CRC. ulTxHistory counts all sent bytes. */
+	unsigned char aucTxHistory[UART_SEQ_CRC_HistorySize];
+	unsigned long ulTxHistory;
+
+	/* The running command. */
+	unsigned char ucCommand;
 } CMD_STATE_T;
 
 
 
-static int getDeviceSpecificBaudRate(unsigned long ulBaudRate, unsigned long *pulDeviceSpecificSpeed)
+/* Program the divider for a baud rate. The baud rate is rejected if the
+ * real baud rate deviates more than ulMaxErrorPpm from it. The setting is
+ * also returned for a rejected baud rate. It is all 0 if the baud rate can
+ * not be set at all.
+ */
+static int uart_set_baud_rate(HOSTADEF(UART) *ptUartArea, unsigned long ulBaudRate, unsigned long ulMaxErrorPpm, BAUDRATE_SETTING_T *ptSetting)
 {
-	unsigned long ulDeviceFrequency;
-	unsigned long long ullDiv;
-	unsigned long ulDiv;
 	int iResult;
+	unsigned long ulError;
 
 
-	/* The frequency of all UART cores is 100MHz. */
-	ulDeviceFrequency = 100000000UL;
-
-	/* Get the baud rate divider.
-	 *
-	 * From the regdef:
-	 *   ( (Baud Rate * 16) / System Frequency ) * 2^16
-	 *
-	 * = BaudRate * 16 * 65536 / SystemFrequency
-	 */
-	ullDiv = ulBaudRate * 16ULL * 65536ULL;
-	/* Round the next integer division. */
-	ullDiv += ulDeviceFrequency / 2;
-	ullDiv /= ulDeviceFrequency;
-
-	/* The UART module has only 16bits for the divider. */
-	if( ullDiv>0xffff )
+	iResult = baudrate_get_setting(ulBaudRate, ptSetting);
+	if( iResult!=0 )
 	{
-		iResult = -1;
+		ptSetting->ulDivider = 0;
+		ptSetting->ulAchievedBaudRate = 0;
+		ptSetting->lErrorPpm = 0;
+		uprintf("Failed to set the baud rate to %d.\n", ulBaudRate);
 	}
 	else
 	{
-		iResult = 0;
+		if( ptSetting->lErrorPpm<0 )
+		{
+			ulError = (unsigned long)(-ptSetting->lErrorPpm);
+		}
+		else
+		{
+			ulError = (unsigned long)(ptSetting->lErrorPpm);
+		}
 
-		ulDiv = (unsigned long)(ullDiv);
-		*pulDeviceSpecificSpeed = ulDiv;
+		if( ulMaxErrorPpm!=0 && ulError>ulMaxErrorPpm )
+		{
+			uprintf("The baud rate %d is %d with an error of %d ppm. This exceeds the limit of %d ppm.\n", ulBaudRate, ptSetting->ulAchievedBaudRate, ptSetting->lErrorPpm, ulMaxErrorPpm);
+			iResult = -1;
+		}
+		else
+		{
+			ptUartArea->ulUartlcr_l = ptSetting->ulDivider & 0xffU;
+			ptUartArea->ulUartlcr_m = ptSetting->ulDivider >> 8;
+		}
 	}
 
 	return iResult;
@@ -150,160 +546,241 @@ static int getDeviceSpecificBaudRate(unsigned long ulBaudRate, unsigned long *pu
 
 
 
-static int command_clean(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+/* The UART has no register with the fill level of the FIFOs. The flags for
+ * a completely full RX FIFO and a completely empty TX FIFO are used instead.
+ * They allow to move a complete FIFO without checking the flags for each
+ * byte.
+ */
+#define UART_FIFO_DEPTH 16U
+
+
+/* Read the flag register. Each read counts as one poll for the telemetry. */
+static inline unsigned long uart_get_flags(CMD_STATE_T *ptState, HOSTADEF(UART) *ptUartArea)
 {
-	int iResult;
-	unsigned long ulValue;
-	HOSTADEF(UART) *ptUartArea;
-	unsigned long ulCleanCnt;
+	++ptState->ulPolls;
+	return ptUartArea->ulUartfr;
+}
 
 
-	if( ptState->ulVerbose!=0U )
-	{
-		uprintf("CLEAN\n");
-	}
 
-	ptUartArea = ptHandle->ptUart;
+/* The flags in the receive status register for each UART_RX_ERROR_T. */
+static const unsigned long aulRxErrorFlags[UART_RX_ERROR_COUNT] =
+{
+	HOSTMSK(uartrsr_OE),
+	HOSTMSK(uartrsr_FE),
+	HOSTMSK(uartrsr_PE),
+	HOSTMSK(uartrsr_BE)
+};
 
-	ulCleanCnt = 0;
-	while(1)
+/* The flags stay set until the register is written. This is checked once
+ * for each burst of received bytes and not for each byte.
+ */
+#define UART_RX_ERROR_FLAGS (HOSTMSK(uartrsr_OE)|HOSTMSK(uartrsr_FE)|HOSTMSK(uartrsr_PE)|HOSTMSK(uartrsr_BE))
+
+
+/* Count the errors of a burst and run the actions of the handle. Each
+ * error type is counted once for the burst.
+ * pucData is the position of the first byte of the burst in the receive
+ * buffer.
+ */
+static void uart_rx_error(CMD_STATE_T *ptState, HOSTADEF(UART) *ptUartArea, unsigned long ulStatus, const unsigned char *pucData)
+{
+	unsigned int uiError;
+	unsigned long ulAction;
+	unsigned long ulMaxAction;
+	unsigned long ulOffset;
+
+
+	/* Clear the flags. The overrun flag stays set until this write. */
+	ptUartArea->ulUartrsr = 0;
+
+	ulMaxAction = UART_RX_ERROR_ACTION_Continue;
+	for(uiError=0; uiError<UART_RX_ERROR_COUNT; ++uiError)
 	{
-		/* Check for data in the FIFO. */
-		ulValue  = ptUartArea->ulUartfr;
-		ulValue &= HOSTMSK(uartfr_RXFE);
-		if( ulValue!=0 )
-		{
-			/* The FIFO is empty, nothing more to discard. */
-			break;
-		}
-		else
+		if( (ulStatus & aulRxErrorFlags[uiError])!=0 )
 		{
-			/* Get the received byte. */
-			ptUartArea->ulUartdr;
-			++ulCleanCnt;
+			++ptState->aulRxErrors[uiError];
+			ulAction = (ptState->ulRxErrorActions >> (8U * uiError)) & 0xffU;
+			if( ulAction>ulMaxAction )
+			{
+				ulMaxAction = ulAction;
+			}
 		}
 	}
 
-	if( ptState->ulVerbose!=0U )
+	if( ulMaxAction!=UART_RX_ERROR_ACTION_Continue )
 	{
-		uprintf("Removed %d bytes from the RX FIFO.\n", ulCleanCnt);
+		ulOffset = (unsigned long)(pucData - ptState->pucRecStart);
+		trace_event(UART_TRACE_EVENT_RxError, ptState->ulUartIndex, ulStatus, ulOffset);
+		if( ptState->ulRxErrorFirstOffset==0xffffffffU )
+		{
+			ptState->ulRxErrorFirstOffset = ulOffset;
+		}
+		if( ulMaxAction==UART_RX_ERROR_ACTION_Stop )
+		{
+			uprintf("Receive error 0x%02x at offset %d.\n", ulStatus, ulOffset);
+			ptState->iRxErrorStop = 1;
+		}
 	}
-
-	iResult = 0;
-
-	return iResult;
 }
 
 
 
-static int command_receive(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+/* Check that each receive error has a known action. */
+static int uart_rx_error_actions_check(unsigned long ulActions)
 {
 	int iResult;
-	const UART_SEQ_COMMAND_READ_T *ptCmd;
-	unsigned long ulDataSize;
-	unsigned long ulValue;
-	unsigned long ulTimeoutTotalMs;
-	unsigned long ulTimeoutCharMs;
-	unsigned long ulTimerTotal;
-	unsigned long ulTimerChar;
-	int iElapsedTimerTotal;
-	int iElapsedTimerChar;
-	unsigned char *pucCnt;
-	unsigned char *pucEnd;
-	HOSTADEF(UART) *ptUartArea;
+	unsigned int uiError;
+	unsigned long ulAction;
 
 
-	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_READ_T))>ptState->pucCmdEnd )
+	iResult = 0;
+	for(uiError=0; uiError<UART_RX_ERROR_COUNT; ++uiError)
 	{
-		if( ptState->ulVerbose!=0U )
+		ulAction = (ulActions >> (8U * uiError)) & 0xffU;
+		if( ulAction>UART_RX_ERROR_ACTION_Stop )
 		{
-			uprintf("Not enough data for the read command left.\n");
+			iResult = -1;
+			break;
 		}
-		iResult = -1;
+	}
+
+	return iResult;
+}
+
+
+
+/* Check the receive status of all bytes since the last check.
+ * pucData is the position of the first of these bytes in the receive buffer.
+ */
+static void uart_rx_check(CMD_STATE_T *ptState, HOSTADEF(UART) *ptUartArea, const unsigned char *pucData)
+{
+	unsigned long ulStatus;
+
+
+	ulStatus = ptUartArea->ulUartrsr & UART_RX_ERROR_FLAGS;
+	if( ulStatus!=0 )
+	{
+		uart_rx_error(ptState, ptUartArea, ulStatus, pucData);
+	}
+}
+
+
+
+/* Read one byte from the RX FIFO. The receive status is checked with
+ * uart_rx_check after the burst.
+ */
+static inline unsigned char uart_read_byte(HOSTADEF(UART) *ptUartArea)
+{
+	return (unsigned char)(ptUartArea->ulUartdr & 0xffU);
+}
+
+
+
+/* Read the data in the RX FIFO. The flags must show that the FIFO is not
+ * empty. The burst drains the FIFO and is limited by the FIFO depth and the
+ * end of the buffer. A full FIFO is read without a flag read between the
+ * bytes. The receive status is checked once after the burst.
+ */
+static unsigned char *uart_read_fifo(CMD_STATE_T *ptState, HOSTADEF(UART) *ptUartArea, unsigned long ulFlags, unsigned char *pucCnt, unsigned char *pucEnd)
+{
+	unsigned char *pucBurstStart;
+	unsigned char *pucBurstEnd;
+
+
+	pucBurstStart = pucCnt;
+	pucBurstEnd = pucCnt + UART_FIFO_DEPTH;
+	if( pucBurstEnd>pucEnd )
+	{
+		pucBurstEnd = pucEnd;
+	}
+
+	if( (ulFlags & HOSTMSK(uartfr_RXFF))!=0 )
+	{
+		do
+		{
+			*pucCnt = uart_read_byte(ptUartArea);
+			++pucCnt;
+		} while( pucCnt<pucBurstEnd );
 	}
 	else
 	{
-		ptCmd = (const UART_SEQ_COMMAND_READ_T*)(ptState->pucCmdCnt);
-		ulDataSize = ptCmd->s.usDataSize;
-		if( (ptState->pucRecCnt + ulDataSize)>ptState->pucRecEnd )
+		do
 		{
-			if( ptState->ulVerbose!=0U )
+			*pucCnt = uart_read_byte(ptUartArea);
+			++pucCnt;
+			if( pucCnt>=pucBurstEnd )
 			{
-				uprintf("Not enough data for the receive data left.\n");
+				break;
 			}
-			iResult = -1;
-		}
-		else
-		{
-			/* Get the timeout values. */
-			ulTimeoutTotalMs = ptCmd->s.usTimeoutTotalMs;
-			ulTimeoutCharMs = ptCmd->s.usTimeoutCharMs;
+			ulFlags = uart_get_flags(ptState, ptUartArea);
+		} while( (ulFlags & HOSTMSK(uartfr_RXFE))==0 );
+	}
 
-			if( ptState->ulVerbose!=0U )
-			{
-				uprintf("RECEIVE %d bytes, total timeout = %dms, char timeout = %dms\n", ulDataSize, ulTimeoutTotalMs, ulTimeoutCharMs);
-			}
+	ptState->ulBytes += (unsigned long)(pucCnt - pucBurstStart);
+	uart_rx_check(ptState, ptUartArea, pucBurstStart);
 
-			/* Receive the data. */
-			iResult = 0;
-			ptUartArea = ptHandle->ptUart;
-			ulTimerTotal = systime_get_ms();
-			pucCnt = ptState->pucRecCnt;
-			pucEnd = ptState->pucRecCnt + ulDataSize;
-			iElapsedTimerTotal = 0;
-			iElapsedTimerChar = 0;
-			while(pucCnt<pucEnd)
-			{
-				/* Wait for data in the FIFO. */
-				ulTimerChar = systime_get_ms();
-				do
-				{
-					ulValue  = ptUartArea->ulUartfr;
-					ulValue &= HOSTMSK(uartfr_RXFE);
-					if( ulTimeoutTotalMs!=0 )
-					{
-						iElapsedTimerTotal = systime_elapsed(ulTimerTotal, ulTimeoutTotalMs);
-					}
-					if( ulTimeoutCharMs!=0 )
-					{
-						iElapsedTimerChar = systime_elapsed(ulTimerChar, ulTimeoutCharMs);
-					}
-				} while( ulValue!=0 && iElapsedTimerTotal==0 && iElapsedTimerChar==0 );
+	return pucCnt;
+}
 
-				if( iElapsedTimerTotal!=0 )
-				{
-					uprintf("The total timeout of %dms elapsed.\n", ulTimeoutTotalMs);
-					iResult = -1;
-					break;
-				}
-				else if( iElapsedTimerChar!=0 )
-				{
-					uprintf("The char timeout of %dms elapsed.\n", ulTimeoutCharMs);
-					iResult = -1;
-					break;
-				}
-				else
-				{
-					/* Get the received byte. */
-					*(pucCnt++) = (unsigned char)(ptUartArea->ulUartdr & 0xff);
-				}
-			}
-			if( iResult!=0 )
-			{
-				if( ptState->ulVerbose!=0U )
-				{
-					uprintf("The receive operation failed.\n");
-				}
-			}
-			else
-			{
-				if( ptState->ulVerbose!=0U )
-				{
-					hexdump(ptState->pucRecCnt, ulDataSize);
-				}
-				ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_READ_T);
-				ptState->pucRecCnt += ulDataSize;
-			}
+
+
+/* Fill the TX FIFO. The flags must show that the FIFO is empty.
+ * The sent bytes are also kept in the history for the CRC.
+ */
+static const unsigned char *uart_write_fifo(CMD_STATE_T *ptState, HOSTADEF(UART) *ptUartArea, const unsigned char *pucCnt, const unsigned char *pucEnd)
+{
+	const unsigned char *pucBurstEnd;
+	unsigned char ucData;
+
+
+	pucBurstEnd = pucCnt + UART_FIFO_DEPTH;
+	if( pucBurstEnd>pucEnd )
+	{
+		pucBurstEnd = pucEnd;
+	}
+
+	ptState->ulBytes += (unsigned long)(pucBurstEnd - pucCnt);
+	while( pucCnt<pucBurstEnd )
+	{
+		ucData = *(pucCnt++);
+		ptUartArea->ulUartdr = ucData;
+		ptState->aucTxHistory[ptState->ulTxHistory & (UART_SEQ_CRC_HistorySize - 1U)] = ucData;
+		++ptState->ulTxHistory;
+	}
+
+	return pucCnt;
+}
+
+
+
+/* Wait until the flags in ulMask of the transmitter have the value
+ * ulExpected. With CTS the peer can stop the transmitter, so the wait
+ * fails after the CTS timeout of the handle.
+ */
+static int uart_wait_tx(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle, unsigned long ulMask, unsigned long ulExpected)
+{
+	int iResult;
+	unsigned long ulValue;
+	unsigned long ulTimer;
+
+
+	iResult = 0;
+	ulTimer = systime_get_ms();
+	while(1)
+	{
+		ulValue  = uart_get_flags(ptState, ptHandle->ptUart);
+		ulValue &= ulMask;
+		if( ulValue==ulExpected )
+		{
+			break;
+		}
+		else if( ptHandle->ulTimeoutCtsMs!=0 && systime_elapsed(ulTimer, ptHandle->ulTimeoutCtsMs)!=0 )
+		{
+			uprintf("The transmitter waited %dms for CTS.\n", ptHandle->ulTimeoutCtsMs);
+			trace_event(UART_TRACE_EVENT_TimeoutChar, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+			iResult = -1;
+			break;
 		}
 	}
 
@@ -312,120 +789,170 @@ static int command_receive(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
 
 
 
-static int command_send(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+static int command_clean(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
 {
 	int iResult;
-	const UART_SEQ_COMMAND_WRITE_T *ptCmd;
-	unsigned long ulDataSize;
 	unsigned long ulValue;
 	HOSTADEF(UART) *ptUartArea;
-	const unsigned char *pucCnt;
-	const unsigned char *pucEnd;
+	unsigned long ulCleanCnt;
+	unsigned long ulCnt;
 
 
-	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_WRITE_T))>ptState->pucCmdEnd )
+	if( ptState->ulVerbose!=0U )
 	{
-		if( ptState->ulVerbose!=0U )
-		{
-			uprintf("Not enough data for the write header left.\n");
-		}
-		iResult = -1;
+		uprintf("CLEAN\n");
 	}
-	else
+
+	ptUartArea = ptHandle->ptUart;
+
+	ulCleanCnt = 0;
+	while(1)
 	{
-		ptCmd = (const UART_SEQ_COMMAND_WRITE_T*)(ptState->pucCmdCnt);
-		ulDataSize = ptCmd->s.usDataSize;
-		if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_WRITE_T) + ulDataSize)>ptState->pucCmdEnd )
+		/* Check for data in the FIFO. */
+		ulValue = uart_get_flags(ptState, ptUartArea);
+		if( (ulValue & HOSTMSK(uartfr_RXFE))!=0 )
 		{
-			if( ptState->ulVerbose!=0U )
+			/* The FIFO is empty, nothing more to discard. */
+			break;
+		}
+		else if( (ulValue & HOSTMSK(uartfr_RXFF))!=0 )
+		{
+			/* Throw away a complete FIFO. */
+			for(ulCnt=0; ulCnt<UART_FIFO_DEPTH; ++ulCnt)
 			{
-				uprintf("Not enough data for the complete write command left.\n");
+				ulValue = ptUartArea->ulUartdr;
 			}
-			iResult = -1;
+			ulCleanCnt += UART_FIFO_DEPTH;
 		}
 		else
 		{
-			/* Send the data. */
-			pucCnt = ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_WRITE_T);
-			pucEnd = ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_WRITE_T) + ulDataSize;
-
-			if( ptState->ulVerbose!=0U )
-			{
-				uprintf("SEND %d bytes\n", ulDataSize);
-				hexdump(pucCnt, ulDataSize);
-			}
-
-			ptUartArea = ptHandle->ptUart;
-			while(pucCnt<pucEnd)
-			{
-				/* Wait until there is space in the FIFO. */
-				do
-				{
-					ulValue  = ptUartArea->ulUartfr;
-					ulValue &= HOSTMSK(uartfr_TXFF);
-				} while( ulValue!=0 );
-
-				ptUartArea->ulUartdr = *(pucCnt++);
-			}
-
-		        /* Wait until all data in the TX FIFO is send. */
-			do
-			{
-				ulValue  = ptUartArea->ulUartfr;
-				ulValue &= HOSTMSK(uartfr_BUSY);
-			} while( ulValue!=0 );
+			/* Get the received byte and throw it away. */
+			ulValue = ptUartArea->ulUartdr;
+			++ulCleanCnt;
+		}
+	}
 
-			ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_WRITE_T) + ulDataSize;
+	/* The errors of the discarded data are not counted. */
+	ptUartArea->ulUartrsr = 0;
 
-			iResult = 0;
-		}
+	ptState->ulBytes += ulCleanCnt;
+	if( ptState->ulVerbose!=0U )
+	{
+		uprintf("Removed %d bytes from the RX FIFO.\n", ulCleanCnt);
 	}
 
+	iResult = 0;
+
 	return iResult;
 }
 
 
 
-static int command_baudrate(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+/* Receive data with timeouts in milliseconds. This is used by the receive
+ * command and its extended version.
+ */
+static int receive_data(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle, unsigned long ulDataSize, unsigned long ulTimeoutTotalMs, unsigned long ulTimeoutCharMs)
 {
 	int iResult;
-	const UART_SEQ_COMMAND_BAUDRATE_T *ptCmd;
-	unsigned long ulBaudRate;
-	unsigned long ulCurrentDeviceSpecificSpeedValue;
+	unsigned long ulValue;
+	unsigned long ulFlags;
+	unsigned long ulTimerTotal;
+	unsigned long ulTimerChar;
+	int iElapsedTimerTotal;
+	int iElapsedTimerChar;
+	unsigned char *pucCnt;
+	unsigned char *pucEnd;
 	HOSTADEF(UART) *ptUartArea;
 
 
-	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_BAUDRATE_T))>ptState->pucCmdEnd )
+	if( ulDataSize>(unsigned long)(ptState->pucRecEnd - ptState->pucRecCnt) )
 	{
 		if( ptState->ulVerbose!=0U )
 		{
-			uprintf("Not enough data for the baud rate command left.\n");
+			uprintf("Not enough data for the receive data left.\n");
 		}
 		iResult = -1;
 	}
 	else
 	{
-		ptCmd = (const UART_SEQ_COMMAND_BAUDRATE_T*)(ptState->pucCmdCnt);
-		ulBaudRate = ptCmd->s.ulBaudRate;
-
 		if( ptState->ulVerbose!=0U )
 		{
-			uprintf("BaudRate %d\n", ulBaudRate);
+			uprintf("RECEIVE %d bytes, total timeout = %dms, char timeout = %dms\n", ulDataSize, ulTimeoutTotalMs, ulTimeoutCharMs);
+		}
+
+		/* Receive the data. */
+		iResult = 0;
+		ptUartArea = ptHandle->ptUart;
+		ulTimerTotal = 0;
+		ulTimerChar = 0;
+		if( ulTimeoutTotalMs!=0 )
+		{
+			ulTimerTotal = systime_get_ms();
 		}
+		pucCnt = ptState->pucRecCnt;
+		pucEnd = ptState->pucRecCnt + ulDataSize;
+		iElapsedTimerTotal = 0;
+		iElapsedTimerChar = 0;
+		while(pucCnt<pucEnd)
+		{
+			/* Wait for data in the FIFO. */
+			if( ulTimeoutCharMs!=0 )
+			{
+				ulTimerChar = systime_get_ms();
+			}
+			do
+			{
+				ulFlags = uart_get_flags(ptState, ptUartArea);
+				ulValue = ulFlags & HOSTMSK(uartfr_RXFE);
+				if( ulTimeoutTotalMs!=0 )
+				{
+					iElapsedTimerTotal = systime_elapsed(ulTimerTotal, ulTimeoutTotalMs);
+				}
+				if( ulTimeoutCharMs!=0 )
+				{
+					iElapsedTimerChar = systime_elapsed(ulTimerChar, ulTimeoutCharMs);
+				}
+			} while( ulValue!=0 && iElapsedTimerTotal==0 && iElapsedTimerChar==0 );
 
-		iResult = getDeviceSpecificBaudRate(ulBaudRate, &ulCurrentDeviceSpecificSpeedValue);
+			if( iElapsedTimerTotal!=0 )
+			{
+				uprintf("The total timeout of %dms elapsed.\n", ulTimeoutTotalMs);
+				trace_event(UART_TRACE_EVENT_TimeoutTotal, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+				iResult = -1;
+				break;
+			}
+			else if( iElapsedTimerChar!=0 )
+			{
+				uprintf("The char timeout of %dms elapsed.\n", ulTimeoutCharMs);
+				trace_event(UART_TRACE_EVENT_TimeoutChar, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+				iResult = -1;
+				break;
+			}
+			else
+			{
+				/* Get the received data. */
+				pucCnt = uart_read_fifo(ptState, ptUartArea, ulFlags, pucCnt, pucEnd);
+				if( ptState->iRxErrorStop!=0 )
+				{
+					iResult = -1;
+					break;
+				}
+			}
+		}
 		if( iResult!=0 )
 		{
-			uprintf("Failed to set the baud rate to %d.\n", ulBaudRate);
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("The receive operation failed.\n");
+			}
 		}
 		else
 		{
-			ptUartArea = ptHandle->ptUart;
-
-			ptUartArea->ulUartlcr_l = ulCurrentDeviceSpecificSpeedValue & 0xffU;
-			ptUartArea->ulUartlcr_m = ulCurrentDeviceSpecificSpeedValue >> 8;
-
-			ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_BAUDRATE_T);
+			if( ptState->ulVerbose!=0U )
+			{
+				hexdump(ptState->pucRecCnt, ulDataSize);
+			}
+			ptState->pucRecCnt += ulDataSize;
 		}
 	}
 
@@ -434,32 +961,28 @@ static int command_baudrate(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
 
 
 
-static int command_delay(CMD_STATE_T *ptState)
+static int command_receive(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
 {
 	int iResult;
-	const UART_SEQ_COMMAND_DELAY_T *ptCmd;
+	const UART_SEQ_COMMAND_READ_T *ptCmd;
 
 
-	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_DELAY_T))>ptState->pucCmdEnd )
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_READ_T))>ptState->pucCmdEnd )
 	{
 		if( ptState->ulVerbose!=0U )
 		{
-			uprintf("Not enough data for the delay command left.\n");
+			uprintf("Not enough data for the read command left.\n");
 		}
 		iResult = -1;
 	}
 	else
 	{
-		ptCmd = (const UART_SEQ_COMMAND_DELAY_T*)(ptState->pucCmdCnt);
-
-		if( ptState->ulVerbose!=0U )
+		ptCmd = (const UART_SEQ_COMMAND_READ_T*)(ptState->pucCmdCnt);
+		iResult = receive_data(ptState, ptHandle, ptCmd->s.usDataSize, ptCmd->s.usTimeoutTotalMs, ptCmd->s.usTimeoutCharMs);
+		if( iResult==0 )
 		{
-			uprintf("Delay %d ms\n", ptCmd->s.ulDelayInMs);
+			ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_READ_T);
 		}
-
-		systime_delay_ms(ptCmd->s.ulDelayInMs);
-		iResult = 0;
-		ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_DELAY_T);
 	}
 
 	return iResult;
@@ -467,478 +990,4821 @@ static int command_delay(CMD_STATE_T *ptState)
 
 
 
-typedef struct UART_INSTANCE_STRUCT
+/* This is the receive command with 32 bit sizes. One command can fill the
+ * complete receive buffer.
+ */
+static int command_receive_long(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
 {
-	HOSTADEF(UART) * const ptArea;
-#if ASIC_TYP==ASIC_TYP_NETX10 || ASIC_TYP==ASIC_TYP_NETX50 || ASIC_TYP==ASIC_TYP_NETX56 || ASIC_TYP==ASIC_TYP_NETX6 || ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
-	HOSTMMIODEF atMMIO[4];
-#endif
-} UART_INSTANCE_T;
-
+	int iResult;
+	const UART_SEQ_COMMAND_READ_LONG_T *ptCmd;
 
 
-static const UART_INSTANCE_T atUartInstances[] =
-{
-#if ASIC_TYP==ASIC_TYP_NETX10
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_READ_LONG_T))>ptState->pucCmdEnd )
 	{
-		.ptArea = (NX10_UART_AREA_T * const)Addr_NX10_uart0,
-		.atMMIO =
+		if( ptState->ulVerbose!=0U )
 		{
-			NX10_MMIO_CFG_uart0_rxd,
-			NX10_MMIO_CFG_uart0_txd,
-			NX10_MMIO_CFG_uart0_rtsn,
-			NX10_MMIO_CFG_uart0_ctsn
+			uprintf("Not enough data for the read command left.\n");
 		}
-	},
-
+		iResult = -1;
+	}
+	else
 	{
-		.ptArea = (NX10_UART_AREA_T * const)Addr_NX10_uart1,
-		.atMMIO =
+		ptCmd = (const UART_SEQ_COMMAND_READ_LONG_T*)(ptState->pucCmdCnt);
+		iResult = receive_data(ptState, ptHandle, ptCmd->s.ulDataSize, ptCmd->s.ulTimeoutTotalMs, ptCmd->s.ulTimeoutCharMs);
+		if( iResult==0 )
 		{
-			NX10_MMIO_CFG_uart1_rxd,
-			NX10_MMIO_CFG_uart1_txd,
-			NX10_MMIO_CFG_uart1_rtsn,
-			NX10_MMIO_CFG_uart1_ctsn
+			ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_READ_LONG_T);
 		}
 	}
 
-#elif ASIC_TYP==ASIC_TYP_NETX50
+	return iResult;
+}
+
+
+
+/* This is the receive command with microsecond timeouts. The timers use
+ * the ticks of the CPU core instead of the systime unit. A timer is only
+ * read if the FIFO is empty and the timeout is enabled. Without timeouts a
+ * poll is one read of the flag register.
+ */
+static int command_receive_us(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_READ_US_T *ptCmd;
+	unsigned long ulDataSize;
+	unsigned long ulValue;
+	unsigned long ulTimeoutTotalUs;
+	unsigned long ulTimeoutCharUs;
+	unsigned long ulTimeoutTotalTicks;
+	unsigned long ulTimeoutCharTicks;
+	unsigned long ulTimerTotal;
+	unsigned long ulTimerChar;
+	unsigned char *pucCnt;
+	unsigned char *pucEnd;
+	HOSTADEF(UART) *ptUartArea;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_READ_US_T))>ptState->pucCmdEnd )
 	{
-		.ptArea = (NX50_UART_AREA_T * const)Addr_NX50_uart0,
-		.atMMIO =
+		if( ptState->ulVerbose!=0U )
 		{
-			NX50_MMIO_CFG_uart0_rxd,
-			NX50_MMIO_CFG_uart0_txd,
-			NX50_MMIO_CFG_uart0_rts,
-			NX50_MMIO_CFG_uart0_cts
+			uprintf("Not enough data for the read command left.\n");
 		}
-	},
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_READ_US_T*)(ptState->pucCmdCnt);
+		ulDataSize = ptCmd->s.usDataSize;
+		ulTimeoutTotalUs = ptCmd->s.ulTimeoutTotalUs;
+		ulTimeoutCharUs = ptCmd->s.ulTimeoutCharUs;
+		if( (ptState->pucRecCnt + ulDataSize)>ptState->pucRecEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the receive data left.\n");
+			}
+			iResult = -1;
+		}
+		else if( ulTimeoutTotalUs>TICKS_MAX_US || ulTimeoutCharUs>TICKS_MAX_US )
+		{
+			uprintf("The timeouts must not exceed %dus.\n", TICKS_MAX_US);
+			iResult = -1;
+		}
+		else
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("RECEIVE %d bytes, total timeout = %dus, char timeout = %dus\n", ulDataSize, ulTimeoutTotalUs, ulTimeoutCharUs);
+			}
+
+			ulTimeoutTotalTicks = ulTimeoutTotalUs * TICKS_PER_US;
+			ulTimeoutCharTicks = ulTimeoutCharUs * TICKS_PER_US;
+
+			/* Receive the data. */
+			iResult = 0;
+			ptUartArea = ptHandle->ptUart;
+			pucCnt = ptState->pucRecCnt;
+			pucEnd = ptState->pucRecCnt + ulDataSize;
+			ulTimerTotal = 0;
+			ulTimerChar = 0;
+			if( (ulTimeoutTotalTicks|ulTimeoutCharTicks)!=0 )
+			{
+				ulTimerTotal = ticks_get();
+				ulTimerChar = ulTimerTotal;
+			}
+			while( pucCnt<pucEnd )
+			{
+				ulValue = uart_get_flags(ptState, ptUartArea);
+				if( (ulValue & HOSTMSK(uartfr_RXFE))==0 )
+				{
+					/* Get the received data. */
+					pucCnt = uart_read_fifo(ptState, ptUartArea, ulValue, pucCnt, pucEnd);
+					if( ptState->iRxErrorStop!=0 )
+					{
+						iResult = -1;
+						break;
+					}
+					if( ulTimeoutCharTicks!=0 )
+					{
+						ulTimerChar = ticks_get();
+					}
+				}
+				else if( ulTimeoutTotalTicks!=0 && ticks_elapsed(ulTimerTotal, ulTimeoutTotalTicks)!=0 )
+				{
+					uprintf("The total timeout of %dus elapsed.\n", ulTimeoutTotalUs);
+					trace_event(UART_TRACE_EVENT_TimeoutTotal, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+					iResult = -1;
+					break;
+				}
+				else if( ulTimeoutCharTicks!=0 && ticks_elapsed(ulTimerChar, ulTimeoutCharTicks)!=0 )
+				{
+					uprintf("The char timeout of %dus elapsed.\n", ulTimeoutCharUs);
+					trace_event(UART_TRACE_EVENT_TimeoutChar, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+					iResult = -1;
+					break;
+				}
+			}
+			if( iResult!=0 )
+			{
+				if( ptState->ulVerbose!=0U )
+				{
+					uprintf("The receive operation failed.\n");
+				}
+			}
+			else
+			{
+				if( ptState->ulVerbose!=0U )
+				{
+					hexdump(ptState->pucRecCnt, ulDataSize);
+				}
+				ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_READ_US_T);
+				ptState->pucRecCnt += ulDataSize;
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Receive data and store the arrival time of each byte. The time is taken
+ * from the ticks when the byte is read from the FIFO, so the FIFO is read
+ * byte by byte. The timestamps are the differences to the previous byte in
+ * microseconds. They are converted from the time since the start of the
+ * command, so the rounding errors do not add up.
+ *
+ * The total timeout is required. It keeps the ticks from wrapping around
+ * and limits the size of a timestamp to UART_SEQ_RECEIVE_TIMESTAMPS_DeltaSizeMax
+ * bytes.
+ */
+static int command_receive_timestamps(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_READ_US_T *ptCmd;
+	unsigned long ulDataSize;
+	unsigned long ulValue;
+	unsigned long ulTimeoutTotalUs;
+	unsigned long ulTimeoutCharUs;
+	unsigned long ulTimeoutTotalTicks;
+	unsigned long ulTimeoutCharTicks;
+	unsigned long ulTimerTotal;
+	unsigned long ulTimerChar;
+	unsigned long ulTimeUs;
+	unsigned long ulLastUs;
+	unsigned long ulDelta;
+	unsigned char *pucCnt;
+	unsigned char *pucEnd;
+	unsigned char *pucChecked;
+	unsigned char *pucDelta;
+	HOSTADEF(UART) *ptUartArea;
+
 
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_READ_US_T))>ptState->pucCmdEnd )
 	{
-		.ptArea = (NX50_UART_AREA_T * const)Addr_NX50_uart1,
-		.atMMIO =
+		if( ptState->ulVerbose!=0U )
 		{
-			NX50_MMIO_CFG_uart1_rxd,
-			NX50_MMIO_CFG_uart1_txd,
-			NX50_MMIO_CFG_uart1_rts,
-			NX50_MMIO_CFG_uart1_cts
+			uprintf("Not enough data for the read command left.\n");
 		}
-	},
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_READ_US_T*)(ptState->pucCmdCnt);
+		ulDataSize = ptCmd->s.usDataSize;
+		ulTimeoutTotalUs = ptCmd->s.ulTimeoutTotalUs;
+		ulTimeoutCharUs = ptCmd->s.ulTimeoutCharUs;
+		if( (ptState->pucRecCnt + UART_SEQ_RECEIVE_TIMESTAMPS_HeaderSize + ulDataSize * (1U + UART_SEQ_RECEIVE_TIMESTAMPS_DeltaSizeMax))>ptState->pucRecEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the receive data left.\n");
+			}
+			iResult = -1;
+		}
+		else if( ulTimeoutTotalUs==0 || ulTimeoutTotalUs>TICKS_MAX_US || ulTimeoutCharUs>TICKS_MAX_US )
+		{
+			uprintf("The total timeout is required. The timeouts must not exceed %dus.\n", TICKS_MAX_US);
+			iResult = -1;
+		}
+		else
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("RECEIVE TIMESTAMPS %d bytes, total timeout = %dus, char timeout = %dus\n", ulDataSize, ulTimeoutTotalUs, ulTimeoutCharUs);
+			}
+
+			ulTimeoutTotalTicks = ulTimeoutTotalUs * TICKS_PER_US;
+			ulTimeoutCharTicks = ulTimeoutCharUs * TICKS_PER_US;
+
+			/* The data follows the header. The timestamps follow the data. */
+			iResult = 0;
+			ptUartArea = ptHandle->ptUart;
+			pucCnt = ptState->pucRecCnt + UART_SEQ_RECEIVE_TIMESTAMPS_HeaderSize;
+			pucEnd = pucCnt + ulDataSize;
+			pucChecked = pucCnt;
+			pucDelta = pucEnd;
+			ulLastUs = 0;
+			ulTimerTotal = ticks_get();
+			ulTimerChar = ulTimerTotal;
+			while( pucCnt<pucEnd )
+			{
+				ulValue = uart_get_flags(ptState, ptUartArea);
+				if( (ulValue & HOSTMSK(uartfr_RXFE))==0 )
+				{
+					*pucCnt = uart_read_byte(ptUartArea);
+					++pucCnt;
+					++ptState->ulBytes;
+					ulTimerChar = ticks_get();
+
+					ulTimeUs = (ulTimerChar - ulTimerTotal) / TICKS_PER_US;
+					ulDelta = ulTimeUs - ulLastUs;
+					ulLastUs = ulTimeUs;
+					while( ulDelta>=0x80U )
+					{
+						*(pucDelta++) = (unsigned char)(ulDelta | 0x80U);
+						ulDelta >>= 7U;
+					}
+					*(pucDelta++) = (unsigned char)ulDelta;
+				}
+				else if( pucChecked!=pucCnt )
+				{
+					/* The FIFO is empty. Check the bytes of the last burst. */
+					uart_rx_check(ptState, ptUartArea, pucChecked);
+					pucChecked = pucCnt;
+					if( ptState->iRxErrorStop!=0 )
+					{
+						iResult = -1;
+						break;
+					}
+				}
+				else if( ticks_elapsed(ulTimerTotal, ulTimeoutTotalTicks)!=0 )
+				{
+					uprintf("The total timeout of %dus elapsed.\n", ulTimeoutTotalUs);
+					trace_event(UART_TRACE_EVENT_TimeoutTotal, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+					iResult = -1;
+					break;
+				}
+				else if( ulTimeoutCharTicks!=0 && ticks_elapsed(ulTimerChar, ulTimeoutCharTicks)!=0 )
+				{
+					uprintf("The char timeout of %dus elapsed.\n", ulTimeoutCharUs);
+					trace_event(UART_TRACE_EVENT_TimeoutChar, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+					iResult = -1;
+					break;
+				}
+			}
+			if( pucChecked!=pucCnt )
+			{
+				uart_rx_check(ptState, ptUartArea, pucChecked);
+				if( ptState->iRxErrorStop!=0 )
+				{
+					iResult = -1;
+				}
+			}
+			if( iResult!=0 )
+			{
+				if( ptState->ulVerbose!=0U )
+				{
+					uprintf("The receive operation failed.\n");
+				}
+			}
+			else
+			{
+				/* Write the size of the data and the timestamps to the header.
+				 * The timestamps can have up to 4 times the size of the data.
+				 */
+				ulValue = (unsigned long)(pucDelta - pucEnd);
+				ptState->pucRecCnt[0] = (unsigned char)(ulDataSize & 0xffU);
+				ptState->pucRecCnt[1] = (unsigned char)(ulDataSize >> 8U);
+				ptState->pucRecCnt[2] = (unsigned char)(ulValue & 0xffU);
+				ptState->pucRecCnt[3] = (unsigned char)((ulValue >> 8U) & 0xffU);
+				ptState->pucRecCnt[4] = (unsigned char)((ulValue >> 16U) & 0xffU);
+				ptState->pucRecCnt[5] = (unsigned char)(ulValue >> 24U);
+
+				if( ptState->ulVerbose!=0U )
+				{
+					hexdump(ptState->pucRecCnt + UART_SEQ_RECEIVE_TIMESTAMPS_HeaderSize, ulDataSize);
+				}
+				ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_READ_US_T);
+				ptState->pucRecCnt = pucDelta;
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Send data from the command. This is used by the send command and its
+ * extended version.
+ */
+static int send_data(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle, const unsigned char *pucData, unsigned long ulDataSize)
+{
+	int iResult;
+	HOSTADEF(UART) *ptUartArea;
+	const unsigned char *pucCnt;
+	const unsigned char *pucEnd;
+
 
+	pucCnt = pucData;
+	pucEnd = pucData + ulDataSize;
+
+	if( ptState->ulVerbose!=0U )
 	{
-		.ptArea = (NX50_UART_AREA_T * const)Addr_NX50_uart2,
-		.atMMIO =
+		uprintf("SEND %d bytes\n", ulDataSize);
+		hexdump(pucCnt, ulDataSize);
+	}
+
+	iResult = 0;
+	ptUartArea = ptHandle->ptUart;
+	while(pucCnt<pucEnd)
+	{
+		/* Wait until the FIFO is empty. The shift register is
+		 * still busy with the last byte, so there is enough time
+		 * to fill the complete FIFO.
+		 */
+		iResult = uart_wait_tx(ptState, ptHandle, HOSTMSK(uartfr_TXFE), HOSTMSK(uartfr_TXFE));
+		if( iResult!=0 )
 		{
-			NX50_MMIO_CFG_uart2_rxd,
-			NX50_MMIO_CFG_uart2_txd,
-			NX50_MMIO_CFG_uart2_rts,
-			NX50_MMIO_CFG_uart2_cts
+			break;
 		}
+
+		pucCnt = uart_write_fifo(ptState, ptUartArea, pucCnt, pucEnd);
 	}
 
-#elif ASIC_TYP==ASIC_TYP_NETX56
+	if( iResult==0 )
 	{
-		.ptArea = (NX56_UART_AREA_T * const)Addr_NX56_uart0,
-		.atMMIO =
+		/* Wait until all data in the TX FIFO is send. */
+		iResult = uart_wait_tx(ptState, ptHandle, HOSTMSK(uartfr_BUSY), 0);
+	}
+
+	return iResult;
+}
+
+
+
+static int command_send(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_WRITE_T *ptCmd;
+	unsigned long ulDataSize;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_WRITE_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
 		{
-			NX56_MMIO_CFG_uart0_rxd,
-			NX56_MMIO_CFG_uart0_txd,
-			NX56_MMIO_CFG_uart0_rtsn,
-			NX56_MMIO_CFG_uart0_ctsn
+			uprintf("Not enough data for the write header left.\n");
 		}
-	},
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_WRITE_T*)(ptState->pucCmdCnt);
+		ulDataSize = ptCmd->s.usDataSize;
+		if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_WRITE_T) + ulDataSize)>ptState->pucCmdEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the complete write command left.\n");
+			}
+			iResult = -1;
+		}
+		else
+		{
+			iResult = send_data(ptState, ptHandle, ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_WRITE_T), ulDataSize);
+			if( iResult==0 )
+			{
+				ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_WRITE_T) + ulDataSize;
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* This is the send command with a 32 bit size. The size is compared with
+ * the rest of the sequence before the pointers are moved, so it can not
+ * wrap around.
+ */
+static int command_send_long(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_WRITE_LONG_T *ptCmd;
+	unsigned long ulDataSize;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_WRITE_LONG_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the write header left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_WRITE_LONG_T*)(ptState->pucCmdCnt);
+		ulDataSize = ptCmd->s.ulDataSize;
+		if( ulDataSize>(unsigned long)(ptState->pucCmdEnd - ptState->pucCmdCnt - sizeof(UART_SEQ_COMMAND_WRITE_LONG_T)) )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the complete write command left.\n");
+			}
+			iResult = -1;
+		}
+		else
+		{
+			iResult = send_data(ptState, ptHandle, ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_WRITE_LONG_T), ulDataSize);
+			if( iResult==0 )
+			{
+				ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_WRITE_LONG_T) + ulDataSize;
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Copy the registers into one burst of a SendRegisters command. The burst
+ * starts at ulPos in the data.
+ */
+static void send_registers_fill(const CMD_STATE_T *ptState, unsigned char *pucBurst, unsigned long ulPos, unsigned long ulBurstSize, const unsigned char *pucPlaceholders, unsigned long ulPlaceholders)
+{
+	const UART_SEQ_PLACEHOLDER_T *ptPlaceholder;
+	unsigned long ulCnt;
+	unsigned long ulByte;
+	unsigned long ulSize;
+	unsigned long ulOffset;
+	unsigned long ulShift;
+	unsigned long ulValue;
+
+
+	for(ulCnt=0; ulCnt<ulPlaceholders; ++ulCnt)
+	{
+		ptPlaceholder = (const UART_SEQ_PLACEHOLDER_T*)(pucPlaceholders + ulCnt * sizeof(UART_SEQ_PLACEHOLDER_T));
+		ulSize = ptPlaceholder->s.ucSize;
+		ulValue = ptState->aulRegister[ptPlaceholder->s.ucRegister];
+		for(ulByte=0; ulByte<ulSize; ++ulByte)
+		{
+			ulOffset = ptPlaceholder->s.usOffset + ulByte;
+			if( ulOffset>=ulPos && ulOffset<(ulPos + ulBurstSize) )
+			{
+				ulShift = ulByte;
+				if( (ptPlaceholder->s.ucFlags & UART_SEQ_REGISTER_FLAG_BigEndian)!=0 )
+				{
+					ulShift = ulSize - 1U - ulByte;
+				}
+				pucBurst[ulOffset - ulPos] = (unsigned char)((ulValue >> (8U * ulShift)) & 0xffU);
+			}
+		}
+	}
+}
+
+
+
+/* Send data with placeholders which are replaced by registers. The data is
+ * copied to a buffer for each burst, so the line timing is the same as for
+ * the send command.
+ */
+static int command_send_registers(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_SEND_REGISTERS_T *ptCmd;
+	const UART_SEQ_PLACEHOLDER_T *ptPlaceholder;
+	unsigned long ulDataSize;
+	unsigned long ulPlaceholders;
+	unsigned long ulCmdSize;
+	unsigned long ulCnt;
+	unsigned long ulPos;
+	unsigned long ulBurstSize;
+	HOSTADEF(UART) *ptUartArea;
+	const unsigned char *pucPlaceholders;
+	const unsigned char *pucData;
+	unsigned char aucBurst[UART_FIFO_DEPTH];
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_SEND_REGISTERS_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the send registers header left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_SEND_REGISTERS_T*)(ptState->pucCmdCnt);
+		ulDataSize = ptCmd->s.usDataSize;
+		ulPlaceholders = ptCmd->s.ucPlaceholders;
+		pucPlaceholders = ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_SEND_REGISTERS_T);
+		pucData = pucPlaceholders + ulPlaceholders * sizeof(UART_SEQ_PLACEHOLDER_T);
+		ulCmdSize = sizeof(UART_SEQ_COMMAND_SEND_REGISTERS_T) + ulPlaceholders * sizeof(UART_SEQ_PLACEHOLDER_T) + ulDataSize;
+		if( (ptState->pucCmdCnt + ulCmdSize)>ptState->pucCmdEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the complete send registers command left.\n");
+			}
+			iResult = -1;
+		}
+		else
+		{
+			/* Check all placeholders before the first byte is sent. */
+			iResult = 0;
+			for(ulCnt=0; ulCnt<ulPlaceholders; ++ulCnt)
+			{
+				ptPlaceholder = (const UART_SEQ_PLACEHOLDER_T*)(pucPlaceholders + ulCnt * sizeof(UART_SEQ_PLACEHOLDER_T));
+				if( ptPlaceholder->s.ucRegister>=UART_SEQ_REGISTER_Count || ptPlaceholder->s.ucSize<1U || ptPlaceholder->s.ucSize>4U || ((unsigned long)ptPlaceholder->s.usOffset + ptPlaceholder->s.ucSize)>ulDataSize )
+				{
+					uprintf("Placeholder %d is invalid: r%d with %d bytes at offset %d.\n", ulCnt, ptPlaceholder->s.ucRegister, ptPlaceholder->s.ucSize, ptPlaceholder->s.usOffset);
+					iResult = -1;
+					break;
+				}
+			}
+
+			if( iResult==0 )
+			{
+				if( ptState->ulVerbose!=0U )
+				{
+					uprintf("SEND %d bytes with %d placeholders\n", ulDataSize, ulPlaceholders);
+				}
+
+				ptUartArea = ptHandle->ptUart;
+				ulPos = 0;
+				while( ulPos<ulDataSize )
+				{
+					/* Prepare the next burst while the FIFO is still busy. */
+					ulBurstSize = ulDataSize - ulPos;
+					if( ulBurstSize>UART_FIFO_DEPTH )
+					{
+						ulBurstSize = UART_FIFO_DEPTH;
+					}
+					memcpy(aucBurst, pucData + ulPos, ulBurstSize);
+					send_registers_fill(ptState, aucBurst, ulPos, ulBurstSize, pucPlaceholders, ulPlaceholders);
+
+					iResult = uart_wait_tx(ptState, ptHandle, HOSTMSK(uartfr_TXFE), HOSTMSK(uartfr_TXFE));
+					if( iResult!=0 )
+					{
+						break;
+					}
+
+					uart_write_fifo(ptState, ptUartArea, aucBurst, aucBurst + ulBurstSize);
+					if( ptState->ulVerbose!=0U )
+					{
+						hexdump(aucBurst, ulBurstSize);
+					}
+					ulPos += ulBurstSize;
+				}
+
+				if( iResult==0 )
+				{
+					/* Wait until all data in the TX FIFO is send. */
+					iResult = uart_wait_tx(ptState, ptHandle, HOSTMSK(uartfr_BUSY), 0);
+				}
+				if( iResult==0 )
+				{
+					ptState->pucCmdCnt += ulCmdSize;
+				}
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Send generated data. Only the pattern is in the command, so long
+ * transfers do not need space in the buffer. Each burst is generated while
+ * the FIFO is still busy with the previous one.
+ */
+static int command_send_pattern(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_SEND_PATTERN_T *ptCmd;
+	UART_SEQ_PATTERN_T tPattern;
+	unsigned char ucValue;
+	unsigned long ulBlockSize;
+	unsigned long ulCmdSize;
+	unsigned long ulTotal;
+	unsigned long ulPos;
+	unsigned long ulBlockPos;
+	unsigned long ulBurstSize;
+	unsigned long ulCnt;
+	HOSTADEF(UART) *ptUartArea;
+	const unsigned char *pucBlock;
+	unsigned char aucBurst[UART_FIFO_DEPTH];
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_SEND_PATTERN_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the send pattern command left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_SEND_PATTERN_T*)(ptState->pucCmdCnt);
+		tPattern = (UART_SEQ_PATTERN_T)(ptCmd->s.ucPattern);
+		ucValue = ptCmd->s.ucValue;
+		ulBlockSize = ptCmd->s.usBlockSize;
+		ulTotal = ulBlockSize * ptCmd->s.usCount;
+		pucBlock = ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_SEND_PATTERN_T);
+		ulCmdSize = sizeof(UART_SEQ_COMMAND_SEND_PATTERN_T);
+		if( tPattern==UART_SEQ_PATTERN_Block )
+		{
+			ulCmdSize += ulBlockSize;
+		}
+
+		if( tPattern!=UART_SEQ_PATTERN_Fill && tPattern!=UART_SEQ_PATTERN_Counter && tPattern!=UART_SEQ_PATTERN_Block )
+		{
+			uprintf("Invalid pattern: %d\n", tPattern);
+			iResult = -1;
+		}
+		else if( (ptState->pucCmdCnt + ulCmdSize)>ptState->pucCmdEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the block of the send pattern command left.\n");
+			}
+			iResult = -1;
+		}
+		else
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("SEND PATTERN %d with %d blocks of %d bytes\n", tPattern, ptCmd->s.usCount, ulBlockSize);
+			}
+
+			iResult = 0;
+			ptUartArea = ptHandle->ptUart;
+			ulPos = 0;
+			ulBlockPos = 0;
+			while( ulPos<ulTotal )
+			{
+				/* Prepare the next burst while the FIFO is still busy. */
+				ulBurstSize = ulTotal - ulPos;
+				if( ulBurstSize>UART_FIFO_DEPTH )
+				{
+					ulBurstSize = UART_FIFO_DEPTH;
+				}
+				switch( tPattern )
+				{
+				case UART_SEQ_PATTERN_Fill:
+					memset(aucBurst, ucValue, ulBurstSize);
+					break;
+
+				case UART_SEQ_PATTERN_Counter:
+					for(ulCnt=0; ulCnt<ulBurstSize; ++ulCnt)
+					{
+						aucBurst[ulCnt] = ucValue;
+						++ucValue;
+					}
+					break;
+
+				case UART_SEQ_PATTERN_Block:
+					for(ulCnt=0; ulCnt<ulBurstSize; ++ulCnt)
+					{
+						aucBurst[ulCnt] = pucBlock[ulBlockPos];
+						++ulBlockPos;
+						if( ulBlockPos>=ulBlockSize )
+						{
+							ulBlockPos = 0;
+						}
+					}
+					break;
+				}
+
+				iResult = uart_wait_tx(ptState, ptHandle, HOSTMSK(uartfr_TXFE), HOSTMSK(uartfr_TXFE));
+				if( iResult!=0 )
+				{
+					break;
+				}
+
+				uart_write_fifo(ptState, ptUartArea, aucBurst, aucBurst + ulBurstSize);
+				ulPos += ulBurstSize;
+			}
+
+			if( iResult==0 )
+			{
+				/* Wait until all data in the TX FIFO is send. */
+				iResult = uart_wait_tx(ptState, ptHandle, HOSTMSK(uartfr_BUSY), 0);
+			}
+			if( iResult==0 )
+			{
+				ptState->pucCmdCnt += ulCmdSize;
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Send a CRC over the last sent bytes. The bytes can be from several
+ * commands. The history has the last UART_SEQ_CRC_HistorySize bytes.
+ */
+static int command_crc_append(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_CRC_APPEND_T *ptCmd;
+	UART_SEQ_CRC_T tCrc;
+	unsigned long ulSize;
+	unsigned long ulStart;
+	unsigned long ulFirst;
+	unsigned long ulCrc;
+	unsigned int uiCrcSize;
+	unsigned char aucCrc[4];
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_CRC_APPEND_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the CRC append command left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_CRC_APPEND_T*)(ptState->pucCmdCnt);
+		tCrc = (UART_SEQ_CRC_T)(ptCmd->s.ucCrc);
+		ulSize = ptCmd->s.usSize;
+		uiCrcSize = crc_get_size(tCrc);
+
+		if( uiCrcSize==0 )
+		{
+			uprintf("Invalid CRC: %d\n", tCrc);
+			iResult = -1;
+		}
+		else if( ulSize>UART_SEQ_CRC_HistorySize || ulSize>ptState->ulTxHistory )
+		{
+			uprintf("The CRC needs the last %d sent bytes, but only %d are available.\n", ulSize, (ptState->ulTxHistory<UART_SEQ_CRC_HistorySize) ? ptState->ulTxHistory : (unsigned long)UART_SEQ_CRC_HistorySize);
+			iResult = -1;
+		}
+		else
+		{
+			/* The bytes can wrap around at the end of the history. */
+			ulStart = (ptState->ulTxHistory - ulSize) & (UART_SEQ_CRC_HistorySize - 1U);
+			ulFirst = UART_SEQ_CRC_HistorySize - ulStart;
+			if( ulFirst>ulSize )
+			{
+				ulFirst = ulSize;
+			}
+			ulCrc = crc_init(tCrc);
+			ulCrc = crc_update(tCrc, ulCrc, ptState->aucTxHistory + ulStart, ulFirst);
+			ulCrc = crc_update(tCrc, ulCrc, ptState->aucTxHistory, ulSize - ulFirst);
+			ulCrc = crc_finish(tCrc, ulCrc);
+			crc_get_bytes(tCrc, ulCrc, aucCrc);
+
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("CRC APPEND over %d bytes: 0x%08x\n", ulSize, ulCrc);
+			}
+
+			iResult = uart_wait_tx(ptState, ptHandle, HOSTMSK(uartfr_TXFE), HOSTMSK(uartfr_TXFE));
+			if( iResult==0 )
+			{
+				uart_write_fifo(ptState, ptHandle->ptUart, aucCrc, aucCrc + uiCrcSize);
+
+				/* Wait until all data in the TX FIFO is send. */
+				iResult = uart_wait_tx(ptState, ptHandle, HOSTMSK(uartfr_BUSY), 0);
+			}
+			if( iResult==0 )
+			{
+				ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_CRC_APPEND_T);
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Send and receive at the same time. The loop drains the RX FIFO before it
+ * refills the TX FIFO, so a DUT can answer while the request is still on
+ * the line.
+ */
+static int command_transceive(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_TRANSCEIVE_T *ptCmd;
+	unsigned long ulSendSize;
+	unsigned long ulReceiveSize;
+	unsigned long ulValue;
+	unsigned long ulTimeoutTotalMs;
+	unsigned long ulTimeoutCharMs;
+	unsigned long ulTimerTotal;
+	unsigned long ulTimerChar;
+	const unsigned char *pucTxCnt;
+	const unsigned char *pucTxEnd;
+	unsigned char *pucRxCnt;
+	unsigned char *pucRxEnd;
+	HOSTADEF(UART) *ptUartArea;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_TRANSCEIVE_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the transceive header left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_TRANSCEIVE_T*)(ptState->pucCmdCnt);
+		ulSendSize = ptCmd->s.usSendSize;
+		ulReceiveSize = ptCmd->s.usReceiveSize;
+		if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_TRANSCEIVE_T) + ulSendSize)>ptState->pucCmdEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the complete transceive command left.\n");
+			}
+			iResult = -1;
+		}
+		else if( (ptState->pucRecCnt + ulReceiveSize)>ptState->pucRecEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the receive data left.\n");
+			}
+			iResult = -1;
+		}
+		else
+		{
+			/* Get the timeout values. */
+			ulTimeoutTotalMs = ptCmd->s.usTimeoutTotalMs;
+			ulTimeoutCharMs = ptCmd->s.usTimeoutCharMs;
+
+			pucTxCnt = ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_TRANSCEIVE_T);
+			pucTxEnd = pucTxCnt + ulSendSize;
+			pucRxCnt = ptState->pucRecCnt;
+			pucRxEnd = pucRxCnt + ulReceiveSize;
+
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("TRANSCEIVE send %d bytes, receive %d bytes, total timeout = %dms, char timeout = %dms\n", ulSendSize, ulReceiveSize, ulTimeoutTotalMs, ulTimeoutCharMs);
+				hexdump(pucTxCnt, ulSendSize);
+			}
+
+			iResult = 0;
+			ptUartArea = ptHandle->ptUart;
+			ulTimerTotal = systime_get_ms();
+			ulTimerChar = ulTimerTotal;
+			while( pucTxCnt<pucTxEnd || pucRxCnt<pucRxEnd )
+			{
+				ulValue = uart_get_flags(ptState, ptUartArea);
+				if( (ulValue & HOSTMSK(uartfr_RXFE))==0 && pucRxCnt<pucRxEnd )
+				{
+					/* Get the received data. */
+					pucRxCnt = uart_read_fifo(ptState, ptUartArea, ulValue, pucRxCnt, pucRxEnd);
+					if( ptState->iRxErrorStop!=0 )
+					{
+						iResult = -1;
+						break;
+					}
+					if( ulTimeoutCharMs!=0 )
+					{
+						ulTimerChar = systime_get_ms();
+					}
+				}
+				else if( (ulValue & HOSTMSK(uartfr_TXFE))!=0 && pucTxCnt<pucTxEnd )
+				{
+					pucTxCnt = uart_write_fifo(ptState, ptUartArea, pucTxCnt, pucTxEnd);
+					if( ulTimeoutCharMs!=0 )
+					{
+						ulTimerChar = systime_get_ms();
+					}
+				}
+				/* Nothing to do in this round. Check the timeouts. */
+				else if( ulTimeoutTotalMs!=0 && systime_elapsed(ulTimerTotal, ulTimeoutTotalMs)!=0 )
+				{
+					uprintf("The total timeout of %dms elapsed.\n", ulTimeoutTotalMs);
+					trace_event(UART_TRACE_EVENT_TimeoutTotal, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+					iResult = -1;
+					break;
+				}
+				else if( ulTimeoutCharMs!=0 && systime_elapsed(ulTimerChar, ulTimeoutCharMs)!=0 )
+				{
+					uprintf("The char timeout of %dms elapsed.\n", ulTimeoutCharMs);
+					trace_event(UART_TRACE_EVENT_TimeoutChar, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+					iResult = -1;
+					break;
+				}
+			}
+
+			if( iResult==0 )
+			{
+				/* Wait until all data in the TX FIFO is sent. */
+				iResult = uart_wait_tx(ptState, ptHandle, HOSTMSK(uartfr_BUSY), 0);
+			}
+
+			if( iResult!=0 )
+			{
+				if( ptState->ulVerbose!=0U )
+				{
+					uprintf("The transceive operation failed.\n");
+				}
+			}
+			else
+			{
+				if( ptState->ulVerbose!=0U )
+				{
+					hexdump(ptState->pucRecCnt, ulReceiveSize);
+				}
+				ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_TRANSCEIVE_T) + ulSendSize;
+				ptState->pucRecCnt += ulReceiveSize;
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Compare the last received bytes with the expected data. The compared bytes
+ * are removed from the receive buffer, so they do not have to be read back
+ * by the host. Only the number of mismatches and the position of the first
+ * mismatch in the received stream are returned.
+ */
+static int command_expect(CMD_STATE_T *ptState)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_EXPECT_T *ptCmd;
+	unsigned long ulDataSize;
+	UART_SEQ_EXPECT_FLAG_T tFlags;
+	unsigned long ulCmdSize;
+	unsigned long ulCnt;
+	unsigned long ulMismatches;
+	unsigned long ulFirstMismatch;
+	unsigned char ucDiff;
+	const unsigned char *pucExpected;
+	const unsigned char *pucMask;
+	unsigned char *pucReceived;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_EXPECT_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the expect header left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_EXPECT_T*)(ptState->pucCmdCnt);
+		ulDataSize = ptCmd->s.usDataSize;
+		tFlags = (UART_SEQ_EXPECT_FLAG_T)(ptCmd->s.ucFlags);
+
+		/* The expected data is followed by the optional mask. */
+		ulCmdSize = sizeof(UART_SEQ_COMMAND_EXPECT_T) + ulDataSize;
+		if( (tFlags & UART_SEQ_EXPECT_FLAG_Mask)!=0 )
+		{
+			ulCmdSize += ulDataSize;
+		}
+
+		if( (ptState->pucCmdCnt + ulCmdSize)>ptState->pucCmdEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the complete expect command left.\n");
+			}
+			iResult = -1;
+		}
+		else if( (ptState->pucRecStart + ulDataSize)>ptState->pucRecCnt )
+		{
+			uprintf("Expecting %d bytes, but only %d bytes were received.\n", ulDataSize, (unsigned long)(ptState->pucRecCnt - ptState->pucRecStart));
+			iResult = -1;
+		}
+		else
+		{
+			pucExpected = ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_EXPECT_T);
+			pucMask = NULL;
+			if( (tFlags & UART_SEQ_EXPECT_FLAG_Mask)!=0 )
+			{
+				pucMask = pucExpected + ulDataSize;
+			}
+			pucReceived = ptState->pucRecCnt - ulDataSize;
+
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("EXPECT %d bytes%s\n", ulDataSize, (pucMask!=NULL) ? " with mask" : "");
+			}
+
+			ulMismatches = 0;
+			ulFirstMismatch = 0;
+			for(ulCnt=0; ulCnt<ulDataSize; ++ulCnt)
+			{
+				ucDiff = (unsigned char)(pucReceived[ulCnt] ^ pucExpected[ulCnt]);
+				if( pucMask!=NULL )
+				{
+					ucDiff &= pucMask[ulCnt];
+				}
+				if( ucDiff!=0 )
+				{
+					if( ulMismatches==0 )
+					{
+						ulFirstMismatch = ulCnt;
+					}
+					++ulMismatches;
+				}
+			}
+
+			if( ulMismatches!=0 )
+			{
+				/* Convert the offset to a position in the received stream. */
+				ulFirstMismatch += (unsigned long)(pucReceived - ptState->pucRecStart) + ptState->ulRecDiscarded;
+				if( ptState->ulExpectMismatches==0 )
+				{
+					ptState->ulExpectFirstMismatch = ulFirstMismatch;
+				}
+				ptState->ulExpectMismatches += ulMismatches;
+
+				if( ptState->ulVerbose!=0U )
+				{
+					uprintf("%d bytes do not match. The first mismatch is at offset %d.\n", ulMismatches, ulFirstMismatch);
+					hexdump(pucReceived, ulDataSize);
+				}
+			}
+
+			/* Remove the compared data from the receive buffer. */
+			ptState->pucRecCnt = pucReceived;
+			ptState->ulRecDiscarded += ulDataSize;
+			ptState->pucCmdCnt += ulCmdSize;
+
+			if( ulMismatches!=0 && (tFlags & UART_SEQ_EXPECT_FLAG_Stop)!=0 )
+			{
+				iResult = -1;
+			}
+			else
+			{
+				iResult = 0;
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Check the CRC at the end of the last received frame. A wrong CRC counts
+ * as one expect mismatch, so the host gets the result without reading the
+ * frame.
+ */
+static int command_crc_verify(CMD_STATE_T *ptState)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_CRC_VERIFY_T *ptCmd;
+	UART_SEQ_CRC_T tCrc;
+	UART_SEQ_CRC_FLAG_T tFlags;
+	unsigned long ulSize;
+	unsigned long ulCrc;
+	unsigned long ulPosition;
+	unsigned int uiCrcSize;
+	int iMatch;
+	unsigned char *pucFrame;
+	unsigned char *pucCrc;
+	unsigned char aucCrc[4];
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_CRC_VERIFY_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the CRC verify command left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_CRC_VERIFY_T*)(ptState->pucCmdCnt);
+		tCrc = (UART_SEQ_CRC_T)(ptCmd->s.ucCrc);
+		tFlags = (UART_SEQ_CRC_FLAG_T)(ptCmd->s.ucFlags);
+		ulSize = ptCmd->s.usSize;
+		uiCrcSize = crc_get_size(tCrc);
+
+		if( uiCrcSize==0 )
+		{
+			uprintf("Invalid CRC: %d\n", tCrc);
+			iResult = -1;
+		}
+		else if( ulSize<uiCrcSize )
+		{
+			uprintf("The frame has %d bytes, but the CRC alone has %d bytes.\n", ulSize, uiCrcSize);
+			iResult = -1;
+		}
+		else if( (ptState->pucRecStart + ulSize)>ptState->pucRecCnt )
+		{
+			uprintf("Checking a CRC over %d bytes, but only %d bytes were received.\n", ulSize, (unsigned long)(ptState->pucRecCnt - ptState->pucRecStart));
+			iResult = -1;
+		}
+		else if( (tFlags & (UART_SEQ_CRC_FLAG_Remove|UART_SEQ_CRC_FLAG_Status))==UART_SEQ_CRC_FLAG_Status && ptState->pucRecCnt>=ptState->pucRecEnd )
+		{
+			uprintf("The receive buffer has no space for the CRC status.\n");
+			iResult = -1;
+		}
+		else
+		{
+			pucFrame = ptState->pucRecCnt - ulSize;
+			pucCrc = ptState->pucRecCnt - uiCrcSize;
+
+			ulCrc = crc_init(tCrc);
+			ulCrc = crc_update(tCrc, ulCrc, pucFrame, ulSize - uiCrcSize);
+			ulCrc = crc_finish(tCrc, ulCrc);
+			crc_get_bytes(tCrc, ulCrc, aucCrc);
+			iMatch = (memcmp(pucCrc, aucCrc, uiCrcSize)==0) ? 1 : 0;
+
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("CRC VERIFY over %d bytes: 0x%08x %s\n", ulSize - uiCrcSize, ulCrc, (iMatch!=0) ? "ok" : "wrong");
+			}
+
+			if( iMatch==0 )
+			{
+				ulPosition = (unsigned long)(pucCrc - ptState->pucRecStart) + ptState->ulRecDiscarded;
+				if( ptState->ulExpectMismatches==0 )
+				{
+					ptState->ulExpectFirstMismatch = ulPosition;
+				}
+				++ptState->ulExpectMismatches;
+			}
+
+			if( (tFlags & UART_SEQ_CRC_FLAG_Remove)!=0 )
+			{
+				ptState->pucRecCnt = pucCrc;
+				ptState->ulRecDiscarded += uiCrcSize;
+			}
+			if( (tFlags & UART_SEQ_CRC_FLAG_Status)!=0 )
+			{
+				/* The status byte is not from the line. Keep the positions of the following data. */
+				*(ptState->pucRecCnt++) = (iMatch!=0) ? 0U : 1U;
+				--ptState->ulRecDiscarded;
+			}
+
+			ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_CRC_VERIFY_T);
+
+			if( iMatch==0 && (tFlags & UART_SEQ_CRC_FLAG_Stop)!=0 )
+			{
+				iResult = -1;
+			}
+			else
+			{
+				iResult = 0;
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Check a receive until command and build the automaton from its patterns.
+ * Each pattern is a size byte followed by the data. ppucCmdNext gets the
+ * start of the next command.
+ */
+static int receive_until_prepare(CMD_STATE_T *ptState, PATTERN_MATCH_T *ptMatch, const unsigned char **ppucCmdNext)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_RECEIVE_UNTIL_T *ptCmd;
+	unsigned long ulDataSize;
+	unsigned long ulPatterns;
+	unsigned long ulCnt;
+	unsigned long ulPatternSize;
+	const unsigned char *pucPattern;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_RECEIVE_UNTIL_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the receive until header left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_RECEIVE_UNTIL_T*)(ptState->pucCmdCnt);
+		ulDataSize = ptCmd->s.usDataSize;
+		ulPatterns = ptCmd->s.ucPatterns;
+
+		/* Build the automaton from the patterns. */
+		iResult = 0;
+		pattern_match_init(ptMatch);
+		pucPattern = ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_RECEIVE_UNTIL_T);
+		for(ulCnt=0; ulCnt<ulPatterns; ++ulCnt)
+		{
+			if( (pucPattern + 1U)>ptState->pucCmdEnd || (pucPattern + 1U + pucPattern[0])>ptState->pucCmdEnd )
+			{
+				if( ptState->ulVerbose!=0U )
+				{
+					uprintf("Not enough data for the complete receive until command left.\n");
+				}
+				iResult = -1;
+				break;
+			}
+			ulPatternSize = *(pucPattern++);
+			iResult = pattern_match_add(ptMatch, pucPattern, ulPatternSize, ulCnt);
+			if( iResult!=0 )
+			{
+				uprintf("Pattern %d is empty or does not fit into the automaton.\n", ulCnt);
+				break;
+			}
+			pucPattern += ulPatternSize;
+		}
+
+		if( iResult!=0 )
+		{
+			/* The error message was already printed. */
+		}
+		else if( (ptState->pucRecCnt + UART_SEQ_RECEIVE_UNTIL_HeaderSize + ulDataSize)>ptState->pucRecEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the receive data left.\n");
+			}
+			iResult = -1;
+		}
+		else
+		{
+			pattern_match_compile(ptMatch);
+			*ppucCmdNext = pucPattern;
+
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("RECEIVE UNTIL one of %d patterns, max %d bytes, total timeout = %dms, char timeout = %dms\n", ulPatterns, ulDataSize, ptCmd->s.usTimeoutTotalMs, ptCmd->s.usTimeoutCharMs);
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Write the header of a receive until command in front of the received
+ * data. pucCnt is the end of the received data.
+ */
+static void receive_until_finish(CMD_STATE_T *ptState, UART_SEQ_RECEIVE_UNTIL_T tPatternIndex, unsigned char *pucCnt, const unsigned char *pucCmdNext)
+{
+	unsigned long ulReceived;
+
+
+	ulReceived = (unsigned long)(pucCnt - ptState->pucRecCnt) - UART_SEQ_RECEIVE_UNTIL_HeaderSize;
+	ptState->pucRecCnt[0] = (unsigned char)tPatternIndex;
+	ptState->pucRecCnt[1] = (unsigned char)(ulReceived & 0xffU);
+	ptState->pucRecCnt[2] = (unsigned char)(ulReceived >> 8U);
+
+	if( ptState->ulVerbose!=0U )
+	{
+		if( tPatternIndex==UART_SEQ_RECEIVE_UNTIL_NoMatch )
+		{
+			uprintf("No pattern matched in %d bytes.\n", ulReceived);
+		}
+		else
+		{
+			uprintf("Pattern %d matched after %d bytes.\n", tPatternIndex, ulReceived);
+		}
+		hexdump(ptState->pucRecCnt + UART_SEQ_RECEIVE_UNTIL_HeaderSize, ulReceived);
+	}
+	ptState->pucCmdCnt = pucCmdNext;
+	ptState->pucRecCnt = pucCnt;
+}
+
+
+
+/* Receive until one of several patterns is found or the maximum size is
+ * reached. The received bytes are fed to an automaton which finds all
+ * patterns in one pass.
+ * The result is a header with the index of the pattern and the number of
+ * received bytes followed by the data. Only the received bytes use space in
+ * the receive buffer.
+ */
+static int command_receive_until(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_RECEIVE_UNTIL_T *ptCmd;
+	unsigned long ulValue;
+	unsigned long ulTimeoutTotalMs;
+	unsigned long ulTimeoutCharMs;
+	unsigned long ulTimerTotal;
+	unsigned long ulTimerChar;
+	unsigned int uiMatch;
+	UART_SEQ_RECEIVE_UNTIL_T tPatternIndex;
+	const unsigned char *pucCmdNext;
+	unsigned char *pucCnt;
+	unsigned char *pucEnd;
+	unsigned char *pucChecked;
+	HOSTADEF(UART) *ptUartArea;
+	PATTERN_MATCH_T tMatch;
+
+
+	iResult = receive_until_prepare(ptState, &tMatch, &pucCmdNext);
+	if( iResult==0 )
+	{
+		ptCmd = (const UART_SEQ_COMMAND_RECEIVE_UNTIL_T*)(ptState->pucCmdCnt);
+
+		/* Get the timeout values. */
+		ulTimeoutTotalMs = ptCmd->s.usTimeoutTotalMs;
+		ulTimeoutCharMs = ptCmd->s.usTimeoutCharMs;
+
+		ptUartArea = ptHandle->ptUart;
+		pucCnt = ptState->pucRecCnt + UART_SEQ_RECEIVE_UNTIL_HeaderSize;
+		pucEnd = pucCnt + ptCmd->s.usDataSize;
+		pucChecked = pucCnt;
+		tPatternIndex = UART_SEQ_RECEIVE_UNTIL_NoMatch;
+		ulTimerTotal = systime_get_ms();
+		ulTimerChar = ulTimerTotal;
+		while( pucCnt<pucEnd )
+		{
+			ulValue  = uart_get_flags(ptState, ptUartArea);
+			ulValue &= HOSTMSK(uartfr_RXFE);
+			if( ulValue==0 )
+			{
+				/* Get the received byte. */
+				ulValue = uart_read_byte(ptUartArea);
+				*(pucCnt++) = (unsigned char)ulValue;
+				++ptState->ulBytes;
+				if( ulTimeoutCharMs!=0 )
+				{
+					ulTimerChar = systime_get_ms();
+				}
+
+				uiMatch = pattern_match_step(&tMatch, (unsigned char)ulValue);
+				if( uiMatch!=0 )
+				{
+					tPatternIndex = (UART_SEQ_RECEIVE_UNTIL_T)(uiMatch - 1U);
+					break;
+				}
+			}
+			else if( pucChecked!=pucCnt )
+			{
+				/* The FIFO is empty. Check the bytes of the last burst. */
+				uart_rx_check(ptState, ptUartArea, pucChecked);
+				pucChecked = pucCnt;
+				if( ptState->iRxErrorStop!=0 )
+				{
+					iResult = -1;
+					break;
+				}
+			}
+			else if( ulTimeoutTotalMs!=0 && systime_elapsed(ulTimerTotal, ulTimeoutTotalMs)!=0 )
+			{
+				uprintf("The total timeout of %dms elapsed.\n", ulTimeoutTotalMs);
+				trace_event(UART_TRACE_EVENT_TimeoutTotal, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+				iResult = -1;
+				break;
+			}
+			else if( ulTimeoutCharMs!=0 && systime_elapsed(ulTimerChar, ulTimeoutCharMs)!=0 )
+			{
+				uprintf("The char timeout of %dms elapsed.\n", ulTimeoutCharMs);
+				trace_event(UART_TRACE_EVENT_TimeoutChar, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+				iResult = -1;
+				break;
+			}
+		}
+		if( pucChecked!=pucCnt )
+		{
+			uart_rx_check(ptState, ptUartArea, pucChecked);
+			if( ptState->iRxErrorStop!=0 )
+			{
+				iResult = -1;
+			}
+		}
+
+		if( iResult!=0 )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("The receive until operation failed.\n");
+			}
+		}
+		else
+		{
+			receive_until_finish(ptState, tPatternIndex, pucCnt, pucCmdNext);
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Check the idle gap of a receive idle command. It is measured with the
+ * ticks, so it must fit into TICKS_MAX_US.
+ */
+static int receive_idle_gap_check(unsigned long ulIdleGapMs)
+{
+	int iResult;
+
+
+	iResult = 0;
+	if( ulIdleGapMs<UART_SEQ_RECEIVE_IDLE_GapMinMs || ulIdleGapMs>(TICKS_MAX_US / 1000U) )
+	{
+		uprintf("The idle gap must be between %d and %dms.\n", UART_SEQ_RECEIVE_IDLE_GapMinMs, TICKS_MAX_US / 1000U);
+		iResult = -1;
+	}
+
+	return iResult;
+}
+
+
+
+/* Receive up to a maximum number of bytes. The command ends successfully
+ * when the line was idle for the gap after the last received byte. Only the
+ * received bytes use space in the receive buffer.
+ * The gap is measured in ticks, as the millisecond timer can end it up to
+ * 1ms early. The total timeout is an error. It also applies to the wait for
+ * the first byte, so an empty response is detected.
+ */
+static int command_receive_idle(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_RECEIVE_IDLE_T *ptCmd;
+	unsigned long ulDataSize;
+	unsigned long ulValue;
+	unsigned long ulTimeoutTotalMs;
+	unsigned long ulIdleGapMs;
+	unsigned long ulIdleGapTicks;
+	unsigned long ulTimerTotal;
+	unsigned long ulTimerIdle;
+	unsigned long ulReceived;
+	unsigned char *pucCnt;
+	unsigned char *pucEnd;
+	HOSTADEF(UART) *ptUartArea;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_RECEIVE_IDLE_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the receive idle command left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_RECEIVE_IDLE_T*)(ptState->pucCmdCnt);
+		ulDataSize = ptCmd->s.usDataSize;
+		ulTimeoutTotalMs = ptCmd->s.usTimeoutTotalMs;
+		ulIdleGapMs = ptCmd->s.usIdleGapMs;
+		if( (ptState->pucRecCnt + ulDataSize)>ptState->pucRecEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the receive data left.\n");
+			}
+			iResult = -1;
+		}
+		else if( receive_idle_gap_check(ulIdleGapMs)!=0 )
+		{
+			iResult = -1;
+		}
+		else
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("RECEIVE IDLE up to %d bytes, total timeout = %dms, idle gap = %dms\n", ulDataSize, ulTimeoutTotalMs, ulIdleGapMs);
+			}
+
+			ulIdleGapTicks = ulIdleGapMs * 1000U * TICKS_PER_US;
+
+			iResult = 0;
+			ptUartArea = ptHandle->ptUart;
+			pucCnt = ptState->pucRecCnt;
+			pucEnd = ptState->pucRecCnt + ulDataSize;
+			ulTimerTotal = systime_get_ms();
+			ulTimerIdle = ticks_get();
+			while( pucCnt<pucEnd )
+			{
+				ulValue = uart_get_flags(ptState, ptUartArea);
+				if( (ulValue & HOSTMSK(uartfr_RXFE))==0 )
+				{
+					/* Get the received data. */
+					pucCnt = uart_read_fifo(ptState, ptUartArea, ulValue, pucCnt, pucEnd);
+					if( ptState->iRxErrorStop!=0 )
+					{
+						iResult = -1;
+						break;
+					}
+					ulTimerIdle = ticks_get();
+				}
+				/* The idle gap starts with the first byte. */
+				else if( pucCnt!=ptState->pucRecCnt && ticks_elapsed(ulTimerIdle, ulIdleGapTicks)!=0 )
+				{
+					break;
+				}
+				else if( ulTimeoutTotalMs!=0 && systime_elapsed(ulTimerTotal, ulTimeoutTotalMs)!=0 )
+				{
+					uprintf("The total timeout of %dms elapsed.\n", ulTimeoutTotalMs);
+					trace_event(UART_TRACE_EVENT_TimeoutTotal, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+					iResult = -1;
+					break;
+				}
+			}
+
+			if( iResult!=0 )
+			{
+				if( ptState->ulVerbose!=0U )
+				{
+					uprintf("The receive idle operation failed.\n");
+				}
+			}
+			else
+			{
+				ulReceived = (unsigned long)(pucCnt - ptState->pucRecCnt);
+				if( ptState->ulVerbose!=0U )
+				{
+					uprintf("Received %d bytes.\n", ulReceived);
+					hexdump(ptState->pucRecCnt, ulReceived);
+				}
+				ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_RECEIVE_IDLE_T);
+				ptState->pucRecCnt = pucCnt;
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Set a new baud rate for a handle. This is the common path of all
+ * commands which change the baud rate.
+ */
+static int handle_set_baud_rate(UART_HANDLE_T *ptHandle, unsigned long ulBaudRate)
+{
+	int iResult;
+	BAUDRATE_SETTING_T tSetting;
+
+
+	iResult = uart_set_baud_rate(ptHandle->ptUart, ulBaudRate, ptHandle->ulMaxErrorPpm, &tSetting);
+	if( iResult==0 )
+	{
+		ptHandle->ulCurrentBaudRate = ulBaudRate;
+		ptHandle->ulCurrentDeviceSpecificSpeedValue = tSetting.ulDivider;
+		ptHandle->ulAchievedBaudRate = tSetting.ulAchievedBaudRate;
+		ptHandle->lBaudRateErrorPpm = tSetting.lErrorPpm;
+	}
+
+	return iResult;
+}
+
+
+
+static int command_baudrate(CMD_STATE_T *ptState, UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_BAUDRATE_T *ptCmd;
+	unsigned long ulBaudRate;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_BAUDRATE_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the baud rate command left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_BAUDRATE_T*)(ptState->pucCmdCnt);
+		ulBaudRate = ptCmd->s.ulBaudRate;
+
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("BaudRate %d\n", ulBaudRate);
+		}
+
+		iResult = handle_set_baud_rate(ptHandle, ulBaudRate);
+		if( iResult==0 )
+		{
+			ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_BAUDRATE_T);
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* The auto baud command runs the UART with the fastest baud rate. Each
+ * falling edge on the RX line starts a character then. The time between
+ * the characters is the time between the falling edges. The sync byte 0x55
+ * has a falling edge every 2 bit times, which gives the bit time directly.
+ * This works for baud rates up to about 1MBaud.
+ */
+#define UART_AUTOBAUD_DIVIDER 0xffffU
+/* A character with the fastest baud rate needs 1.6us. No real edges can be
+ * closer than this.
+ */
+#define UART_AUTOBAUD_MIN_DELTA_TICKS ((16U * TICKS_PER_US) / 10U)
+/* A measured baud rate this close to a standard baud rate is rounded to it. */
+#define UART_AUTOBAUD_STANDARD_PPM 30000U
+
+static int command_autobaud(CMD_STATE_T *ptState, UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_AUTOBAUD_T *ptCmd;
+	unsigned long ulEdges;
+	unsigned long ulTimeoutTotal;
+	unsigned long ulTimerStart;
+	unsigned long ulValue;
+	unsigned long ulCnt;
+	unsigned long ulDeltas;
+	unsigned long ulTickLast;
+	unsigned long ulTick;
+	unsigned long ulDelta;
+	unsigned long ulDeltaMedian;
+	unsigned long ulDeltaSum;
+	unsigned long ulDeltaSumCnt;
+	unsigned long ulMeasured;
+	unsigned long ulBaudRate;
+	unsigned long aulDeltas[UART_SEQ_AUTOBAUD_EdgesMax];
+	UART_SEQ_AUTOBAUD_RESULT_T tResult;
+	HOSTADEF(UART) *ptUartArea;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_AUTOBAUD_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the auto baud command left.\n");
+		}
+		iResult = -1;
+	}
+	else if( (ptState->pucRecCnt + sizeof(UART_SEQ_AUTOBAUD_RESULT_T))>ptState->pucRecEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the receive data left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_AUTOBAUD_T*)(ptState->pucCmdCnt);
+		ulEdges = ptCmd->s.ucEdges;
+		ulTimeoutTotal = ptCmd->s.usTimeoutTotalMs;
+
+		if( ulEdges<2U || ulEdges>UART_SEQ_AUTOBAUD_EdgesMax )
+		{
+			uprintf("The number of edges must be between 2 and %d.\n", UART_SEQ_AUTOBAUD_EdgesMax);
+			iResult = -1;
+		}
+		else if( ulTimeoutTotal==0 )
+		{
+			uprintf("The total timeout is required.\n");
+			iResult = -1;
+		}
+		else
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("AutoBaud with %d edges, total timeout = %dms\n", ulEdges, ulTimeoutTotal);
+			}
+
+			ptUartArea = ptHandle->ptUart;
+
+			/* Use the fastest baud rate and drop all old data. */
+			ptUartArea->ulUartlcr_l = UART_AUTOBAUD_DIVIDER & 0xffU;
+			ptUartArea->ulUartlcr_m = UART_AUTOBAUD_DIVIDER >> 8;
+			while(1)
+			{
+				ulValue = uart_get_flags(ptState, ptUartArea);
+				if( (ulValue & HOSTMSK(uartfr_RXFE))!=0 )
+				{
+					break;
+				}
+				ulValue = ptUartArea->ulUartdr;
+			}
+
+			/* Get the time of each character. */
+			ulCnt = 0;
+			ulDeltas = 0;
+			ulTickLast = 0;
+			ulTimerStart = systime_get_ms();
+			do
+			{
+				ulValue = uart_get_flags(ptState, ptUartArea);
+				if( (ulValue & HOSTMSK(uartfr_RXFE))==0 )
+				{
+					ulTick = ticks_get();
+					ulValue = ptUartArea->ulUartdr;
+					++ptState->ulBytes;
+
+					/* Skip characters which were waiting in the FIFO. They
+					 * have no valid time.
+					 */
+					ulDelta = ulTick - ulTickLast;
+					if( ulCnt==0 || ulDelta>=UART_AUTOBAUD_MIN_DELTA_TICKS )
+					{
+						if( ulCnt!=0 )
+						{
+							aulDeltas[ulDeltas] = ulDelta;
+							++ulDeltas;
+						}
+						ulTickLast = ulTick;
+						++ulCnt;
+					}
+				}
+				else if( systime_elapsed(ulTimerStart, ulTimeoutTotal)!=0 )
+				{
+					break;
+				}
+			} while( ulCnt<ulEdges );
+
+			/* The sync bytes have framing errors at the wrong baud rate.
+			 * They are not counted.
+			 */
+			ptUartArea->ulUartrsr = 0;
+
+			if( ulCnt<ulEdges )
+			{
+				trace_event(UART_TRACE_EVENT_TimeoutTotal, ptState->ulUartIndex, ptState->ucCommand, ulCnt);
+				uprintf("The auto baud command found only %d of %d edges.\n", ulCnt, ulEdges);
+				iResult = -1;
+			}
+			else
+			{
+				/* Most times are 2 bit times. Only the time from the last edge
+				 * of one sync byte to the first edge of the next one can be
+				 * longer. Sort the times and use the mean of all times near
+				 * the median.
+				 */
+				for(ulCnt=1; ulCnt<ulDeltas; ++ulCnt)
+				{
+					ulDelta = aulDeltas[ulCnt];
+					ulValue = ulCnt;
+					while( ulValue>0 && aulDeltas[ulValue-1U]>ulDelta )
+					{
+						aulDeltas[ulValue] = aulDeltas[ulValue-1U];
+						--ulValue;
+					}
+					aulDeltas[ulValue] = ulDelta;
+				}
+				ulDeltaMedian = aulDeltas[ulDeltas / 2U];
+				ulDeltaSum = 0;
+				ulDeltaSumCnt = 0;
+				for(ulCnt=0; ulCnt<ulDeltas; ++ulCnt)
+				{
+					ulDelta = aulDeltas[ulCnt];
+					if( ulDelta>=(ulDeltaMedian - (ulDeltaMedian / 8U)) && ulDelta<=(ulDeltaMedian + (ulDeltaMedian / 8U)) )
+					{
+						ulDeltaSum += ulDelta;
+						++ulDeltaSumCnt;
+					}
+				}
+				ulMeasured = (2U * TICKS_PER_US * 1000000U) / (ulDeltaSum / ulDeltaSumCnt);
+
+				/* Prefer a standard baud rate. */
+				ulBaudRate = baudrate_get_standard(ulMeasured, UART_AUTOBAUD_STANDARD_PPM);
+				if( ulBaudRate==0 )
+				{
+					ulBaudRate = ulMeasured;
+				}
+
+				if( ptState->ulVerbose!=0U )
+				{
+					uprintf("Measured %d baud, using %d baud.\n", ulMeasured, ulBaudRate);
+				}
+
+				iResult = handle_set_baud_rate(ptHandle, ulBaudRate);
+				if( iResult==0 )
+				{
+					tResult.ulMeasuredBaudRate = ulMeasured;
+					tResult.ulBaudRate = ulBaudRate;
+
+					/* The receive buffer has no alignment. */
+					memcpy(ptState->pucRecCnt, &tResult, sizeof(UART_SEQ_AUTOBAUD_RESULT_T));
+					ptState->pucRecCnt += sizeof(UART_SEQ_AUTOBAUD_RESULT_T);
+					ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_AUTOBAUD_T);
+				}
+			}
+
+			if( iResult!=0 )
+			{
+				/* Go back to the old baud rate. */
+				ulValue = ptHandle->ulCurrentDeviceSpecificSpeedValue;
+				ptUartArea->ulUartlcr_l = ulValue & 0xffU;
+				ptUartArea->ulUartlcr_m = ulValue >> 8;
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+static int command_delay(CMD_STATE_T *ptState)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_DELAY_T *ptCmd;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_DELAY_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the delay command left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_DELAY_T*)(ptState->pucCmdCnt);
+
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Delay %d ms\n", ptCmd->s.ulDelayInMs);
+		}
+
+		systime_delay_ms(ptCmd->s.ulDelayInMs);
+		iResult = 0;
+		ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_DELAY_T);
+	}
+
+	return iResult;
+}
+
+
+
+static int command_delay_us(CMD_STATE_T *ptState)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_DELAY_US_T *ptCmd;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_DELAY_US_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the delay command left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_DELAY_US_T*)(ptState->pucCmdCnt);
+
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Delay %d us\n", ptCmd->s.ulDelayInUs);
+		}
+
+		ticks_delay_us(ptCmd->s.ulDelayInUs);
+		iResult = 0;
+		ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_DELAY_US_T);
+	}
+
+	return iResult;
+}
+
+
+
+/* Send ulSize bytes of a PRBS and compare the received data with the same
+ * PRBS. This ends if all data is received or no data was moved for the
+ * char timeout. ptPrbs is the state of the generator. It is not changed.
+ */
+static void bert_transfer(CMD_STATE_T *ptState, HOSTADEF(UART) *ptUartArea, const PRBS_T *ptPrbs, unsigned long ulSize, unsigned long ulTimeoutCharUs, UART_SEQ_BERT_RESULT_T *ptResult)
+{
+	unsigned long ulTimeoutCharTicks;
+	unsigned long ulTimerChar;
+	unsigned long ulTimerStart;
+	unsigned long ulValue;
+	unsigned long ulSent;
+	unsigned long ulReceived;
+	unsigned long ulByteErrors;
+	unsigned long ulBitErrors;
+	unsigned long ulFirstError;
+	unsigned long ulBurstEnd;
+	unsigned char ucDiff;
+	PRBS_T tPrbsTx;
+	PRBS_T tPrbsRx;
+
+
+	/* The checker starts with the same state as the generator. */
+	tPrbsTx = *ptPrbs;
+	tPrbsRx = *ptPrbs;
+	ulTimeoutCharTicks = ulTimeoutCharUs * TICKS_PER_US;
+
+	ulSent = 0;
+	ulReceived = 0;
+	ulByteErrors = 0;
+	ulBitErrors = 0;
+	ulFirstError = 0xffffffffU;
+	ulTimerStart = systime_get_ms();
+	ulTimerChar = ticks_get();
+	while( ulReceived<ulSize )
+	{
+		ulValue = uart_get_flags(ptState, ptUartArea);
+		if( (ulValue & HOSTMSK(uartfr_RXFE))==0 )
+		{
+			/* Check the received data. A full FIFO is read in one burst. */
+			ulBurstEnd = ulReceived + 1U;
+			if( (ulValue & HOSTMSK(uartfr_RXFF))!=0 )
+			{
+				ulBurstEnd = ulReceived + UART_FIFO_DEPTH;
+				if( ulBurstEnd>ulSize )
+				{
+					ulBurstEnd = ulSize;
+				}
+			}
+			do
+			{
+				ucDiff  = (unsigned char)(ptUartArea->ulUartdr & 0xffU);
+				ucDiff ^= prbs_get_byte(&tPrbsRx);
+				if( ucDiff!=0 )
+				{
+					if( ulByteErrors==0 )
+					{
+						ulFirstError = ulReceived;
+					}
+					++ulByteErrors;
+					do
+					{
+						ucDiff &= (unsigned char)(ucDiff - 1U);
+						++ulBitErrors;
+					} while( ucDiff!=0 );
+				}
+				++ulReceived;
+			} while( ulReceived<ulBurstEnd );
+			ulTimerChar = ticks_get();
+		}
+		else if( (ulValue & HOSTMSK(uartfr_TXFE))!=0 && ulSent<ulSize )
+		{
+			/* Fill the TX FIFO. */
+			ulBurstEnd = ulSent + UART_FIFO_DEPTH;
+			if( ulBurstEnd>ulSize )
+			{
+				ulBurstEnd = ulSize;
+			}
+			do
+			{
+				ptUartArea->ulUartdr = prbs_get_byte(&tPrbsTx);
+				++ulSent;
+			} while( ulSent<ulBurstEnd );
+			ulTimerChar = ticks_get();
+		}
+		else if( ticks_elapsed(ulTimerChar, ulTimeoutCharTicks)!=0 )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("The char timeout of %dus elapsed.\n", ulTimeoutCharUs);
+			}
+			break;
+		}
+	}
+
+	/* The BERT compares the data itself. The receive errors of the
+	 * pattern are not counted.
+	 */
+	ptUartArea->ulUartrsr = 0;
+
+	ptState->ulBytes += ulSent + ulReceived;
+	ptResult->ulBytesSent = ulSent;
+	ptResult->ulBytesReceived = ulReceived;
+	ptResult->ulByteErrors = ulByteErrors;
+	ptResult->ulBitErrors = ulBitErrors;
+	ptResult->ulFirstErrorOffset = ulFirstError;
+	ptResult->ulElapsedMs = systime_get_ms() - ulTimerStart;
+
+	/* Wait until all data in the TX FIFO is sent. With flow control the
+	 * peer can stop the transmitter, so this ends with the char timeout.
+	 */
+	ulTimerChar = ticks_get();
+	do
+	{
+		ulValue  = uart_get_flags(ptState, ptUartArea);
+		ulValue &= HOSTMSK(uartfr_BUSY);
+	} while( ulValue!=0 && ticks_elapsed(ulTimerChar, ulTimeoutCharTicks)==0 );
+}
+
+
+
+/* Run a bit error rate test. The command sends a pseudo random bit
+ * sequence and checks the received data against the same sequence. This
+ * needs a loopback on the line. No data is stored, only the result is
+ * written to the receive buffer.
+ * The char timeout ends the test if the received data stops. This is not an
+ * error of the command. The missing bytes are visible in the result.
+ */
+static int command_bert(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_BERT_T *ptCmd;
+	UART_SEQ_PRBS_T tPrbs;
+	unsigned long ulSize;
+	unsigned long ulTimeoutCharUs;
+	PRBS_T tPrbsState;
+	UART_SEQ_BERT_RESULT_T tResult;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_BERT_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the BERT command left.\n");
+		}
+		iResult = -1;
+	}
+	else if( (ptState->pucRecCnt + sizeof(UART_SEQ_BERT_RESULT_T))>ptState->pucRecEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the receive data left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_BERT_T*)(ptState->pucCmdCnt);
+		tPrbs = (UART_SEQ_PRBS_T)(ptCmd->s.ucPrbs);
+		ulSize = ptCmd->s.ulSize;
+		ulTimeoutCharUs = ptCmd->s.ulTimeoutCharUs;
+
+		iResult = prbs_init(&tPrbsState, tPrbs, ptCmd->s.ulSeed);
+		if( iResult!=0 )
+		{
+			uprintf("Invalid PRBS type: %d\n", tPrbs);
+		}
+		else if( ulTimeoutCharUs==0 || ulTimeoutCharUs>TICKS_MAX_US )
+		{
+			uprintf("The char timeout must be between 1 and %dus.\n", TICKS_MAX_US);
+			iResult = -1;
+		}
+		else
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("BERT PRBS%d with %d bytes, char timeout = %dus\n", tPrbs, ulSize, ulTimeoutCharUs);
+			}
+
+			bert_transfer(ptState, ptHandle->ptUart, &tPrbsState, ulSize, ulTimeoutCharUs, &tResult);
+
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Sent %d bytes, received %d bytes in %dms.\n", tResult.ulBytesSent, tResult.ulBytesReceived, tResult.ulElapsedMs);
+				uprintf("%d byte errors, %d bit errors, first error at offset 0x%08x.\n", tResult.ulByteErrors, tResult.ulBitErrors, tResult.ulFirstErrorOffset);
+			}
+
+			/* The receive buffer has no alignment. */
+			memcpy(ptState->pucRecCnt, &tResult, sizeof(UART_SEQ_BERT_RESULT_T));
+			ptState->pucRecCnt += sizeof(UART_SEQ_BERT_RESULT_T);
+			ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_BERT_T);
+		}
+	}
+
+	return iResult;
+}
+
+
+/* Read and drop the received data until the line was idle for the char
+ * timeout. This removes the late bytes of a transfer with a wrong baud
+ * rate. A peer which never stops sending ends this after ulMaxBytes.
+ */
+static void uart_discard_until_idle(CMD_STATE_T *ptState, HOSTADEF(UART) *ptUartArea, unsigned long ulTimeoutCharUs, unsigned long ulMaxBytes)
+{
+	unsigned long ulTimeoutCharTicks;
+	unsigned long ulTimerChar;
+	unsigned long ulValue;
+	unsigned long ulDiscarded;
+
+
+	ulTimeoutCharTicks = ulTimeoutCharUs * TICKS_PER_US;
+	ulDiscarded = 0;
+	ulTimerChar = ticks_get();
+	do
+	{
+		ulValue = uart_get_flags(ptState, ptUartArea);
+		if( (ulValue & HOSTMSK(uartfr_RXFE))==0 )
+		{
+			ulValue = ptUartArea->ulUartdr;
+			++ulDiscarded;
+			ulTimerChar = ticks_get();
+		}
+	} while( ulDiscarded<ulMaxBytes && ticks_elapsed(ulTimerChar, ulTimeoutCharTicks)==0 );
+
+	ptState->ulBytes += ulDiscarded;
+}
+
+
+
+static unsigned short saturate_u16(unsigned long ulValue)
+{
+	if( ulValue>0xffffU )
+	{
+		ulValue = 0xffffU;
+	}
+
+	return (unsigned short)ulValue;
+}
+
+
+
+static int command_baud_sweep(CMD_STATE_T *ptState, const UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_BAUD_SWEEP_T *ptCmd;
+	UART_SEQ_PRBS_T tPrbs;
+	unsigned long ulFirst;
+	unsigned long ulLast;
+	unsigned long ulStep;
+	unsigned long ulSize;
+	unsigned long ulTimeoutCharUs;
+	unsigned long ulSteps;
+	unsigned long ulCnt;
+	unsigned long ulDivider;
+	unsigned char *pucRecord;
+	PRBS_T tPrbsState;
+	UART_SEQ_BERT_RESULT_T tResult;
+	UART_SEQ_BAUD_SWEEP_RECORD_T tRecord;
+	HOSTADEF(UART) *ptUartArea;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_BAUD_SWEEP_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the baud sweep command left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_BAUD_SWEEP_T*)(ptState->pucCmdCnt);
+		tPrbs = (UART_SEQ_PRBS_T)(ptCmd->s.ucPrbs);
+		ulFirst = ptCmd->s.usDividerFirst;
+		ulLast = ptCmd->s.usDividerLast;
+		ulStep = ptCmd->s.usDividerStep;
+		ulSize = ptCmd->s.usSize;
+		ulTimeoutCharUs = ptCmd->s.ulTimeoutCharUs;
+
+		/* The range can go up or down. */
+		ulSteps = 0;
+		if( ulStep!=0 )
+		{
+			if( ulFirst<=ulLast )
+			{
+				ulSteps = ((ulLast - ulFirst) / ulStep) + 1U;
+			}
+			else
+			{
+				ulSteps = ((ulFirst - ulLast) / ulStep) + 1U;
+			}
+		}
+
+		iResult = prbs_init(&tPrbsState, tPrbs, 0);
+		if( iResult!=0 )
+		{
+			uprintf("Invalid PRBS type: %d\n", tPrbs);
+		}
+		else if( ulSteps==0 || ulFirst==0 || ulLast==0 || ulSize==0 )
+		{
+			uprintf("Invalid baud sweep: dividers 0x%04x to 0x%04x in steps of %d with %d bytes.\n", ulFirst, ulLast, ulStep, ulSize);
+			iResult = -1;
+		}
+		else if( ulTimeoutCharUs==0 || ulTimeoutCharUs>TICKS_MAX_US )
+		{
+			uprintf("The char timeout must be between 1 and %dus.\n", TICKS_MAX_US);
+			iResult = -1;
+		}
+		else if( (ptState->pucRecCnt + UART_SEQ_BAUD_SWEEP_HeaderSize + ulSteps*sizeof(UART_SEQ_BAUD_SWEEP_RECORD_T))>ptState->pucRecEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the receive data left.\n");
+			}
+			iResult = -1;
+		}
+		else
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Baud sweep PRBS%d over %d dividers from 0x%04x to 0x%04x with %d bytes, char timeout = %dus\n", tPrbs, ulSteps, ulFirst, ulLast, ulSize, ulTimeoutCharUs);
+			}
+
+			ptUartArea = ptHandle->ptUart;
+
+			/* The header has the number of records. */
+			ptState->pucRecCnt[0] = (unsigned char)(ulSteps & 0xffU);
+			ptState->pucRecCnt[1] = (unsigned char)(ulSteps >> 8U);
+			pucRecord = ptState->pucRecCnt + UART_SEQ_BAUD_SWEEP_HeaderSize;
+
+			for(ulCnt=0; ulCnt<ulSteps; ++ulCnt)
+			{
+				if( ulFirst<=ulLast )
+				{
+					ulDivider = ulFirst + ulCnt*ulStep;
+				}
+				else
+				{
+					ulDivider = ulFirst - ulCnt*ulStep;
+				}
+				ptUartArea->ulUartlcr_l = ulDivider & 0xffU;
+				ptUartArea->ulUartlcr_m = ulDivider >> 8;
+
+				bert_transfer(ptState, ptUartArea, &tPrbsState, ulSize, ulTimeoutCharUs, &tResult);
+				/* Do not count late bytes of this step in the next one. */
+				uart_discard_until_idle(ptState, ptUartArea, ulTimeoutCharUs, 2U*ulSize + UART_FIFO_DEPTH);
+
+				if( ptState->ulVerbose!=0U )
+				{
+					uprintf("Divider 0x%04x: received %d bytes, %d byte errors, %d bit errors.\n", ulDivider, tResult.ulBytesReceived, tResult.ulByteErrors, tResult.ulBitErrors);
+				}
+
+				tRecord.usDivider = (unsigned short)ulDivider;
+				tRecord.usBytesReceived = saturate_u16(tResult.ulBytesReceived);
+				tRecord.usByteErrors = saturate_u16(tResult.ulByteErrors);
+				tRecord.usBitErrors = saturate_u16(tResult.ulBitErrors);
+
+				/* The receive buffer has no alignment. */
+				memcpy(pucRecord, &tRecord, sizeof(UART_SEQ_BAUD_SWEEP_RECORD_T));
+				pucRecord += sizeof(UART_SEQ_BAUD_SWEEP_RECORD_T);
+			}
+
+			/* Restore the baud rate from before the sweep. */
+			ulDivider = ptHandle->ulCurrentDeviceSpecificSpeedValue;
+			ptUartArea->ulUartlcr_l = ulDivider & 0xffU;
+			ptUartArea->ulUartlcr_m = ulDivider >> 8;
+
+			ptState->pucRecCnt = pucRecord;
+			ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_BAUD_SWEEP_T);
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Send a counter and receive it again. The RX FIFO is read until it is
+ * empty, so the bytes of one read show the fill level. This costs one poll
+ * per byte, like the normal receive of a FIFO which is not full.
+ * The elapsed time is measured with the ticks if they did not wrap around.
+ */
+static void benchmark_transfer(CMD_STATE_T *ptState, HOSTADEF(UART) *ptUartArea, unsigned long ulSize, unsigned long ulTimeoutCharUs, UART_SEQ_BENCHMARK_RESULT_T *ptResult)
+{
+	unsigned long ulTimeoutCharTicks;
+	unsigned long ulTimerStartMs;
+	unsigned long ulTickStart;
+	unsigned long ulTickLast;
+	unsigned long ulTick;
+	unsigned long ulElapsedMs;
+	unsigned long ulValue;
+	unsigned long ulSent;
+	unsigned long ulReceived;
+	unsigned long ulByteErrors;
+	unsigned long ulBusyTicks;
+	unsigned long ulFill;
+	unsigned long ulMaxFill;
+	unsigned long ulBurstEnd;
+	unsigned char ucData;
+
+
+	ulTimeoutCharTicks = ulTimeoutCharUs * TICKS_PER_US;
+
+	ulSent = 0;
+	ulReceived = 0;
+	ulByteErrors = 0;
+	ulBusyTicks = 0;
+	ulMaxFill = 0;
+	ulTimerStartMs = systime_get_ms();
+	ulTickStart = ticks_get();
+	ulTickLast = ulTickStart;
+	while( ulReceived<ulSize )
+	{
+		ulValue = uart_get_flags(ptState, ptUartArea);
+		if( (ulValue & HOSTMSK(uartfr_RXFE))==0 )
+		{
+			ulTick = ticks_get();
+			ulFill = 0;
+			do
+			{
+				ucData = uart_read_byte(ptUartArea);
+				if( ucData!=(unsigned char)ulReceived )
+				{
+					++ulByteErrors;
+				}
+				++ulReceived;
+				++ulFill;
+				ulValue = uart_get_flags(ptState, ptUartArea);
+			} while( (ulValue & HOSTMSK(uartfr_RXFE))==0 && ulReceived<ulSize );
+			uart_rx_check(ptState, ptUartArea, ptState->pucRecCnt);
+			ulTickLast = ticks_get();
+			ulBusyTicks += ulTickLast - ulTick;
+
+			if( ulFill>ulMaxFill )
+			{
+				ulMaxFill = ulFill;
+			}
+			if( ptState->iRxErrorStop!=0 )
+			{
+				break;
+			}
+		}
+		else if( (ulValue & HOSTMSK(uartfr_TXFE))!=0 && ulSent<ulSize )
+		{
+			ulTick = ticks_get();
+			ulBurstEnd = ulSent + UART_FIFO_DEPTH;
+			if( ulBurstEnd>ulSize )
+			{
+				ulBurstEnd = ulSize;
+			}
+			do
+			{
+				ptUartArea->ulUartdr = ulSent & 0xffU;
+				++ulSent;
+			} while( ulSent<ulBurstEnd );
+			ulTickLast = ticks_get();
+			ulBusyTicks += ulTickLast - ulTick;
+		}
+		else if( ticks_elapsed(ulTickLast, ulTimeoutCharTicks)!=0 )
+		{
+			uprintf("The char timeout of %dus elapsed.\n", ulTimeoutCharUs);
+			trace_event(UART_TRACE_EVENT_TimeoutChar, ptState->ulUartIndex, ptState->ucCommand, ulSent + ulReceived);
+			break;
+		}
+	}
+
+	ulElapsedMs = systime_get_ms() - ulTimerStartMs;
+	if( ulElapsedMs<(TICKS_MAX_US / 2000U) )
+	{
+		ptResult->ulElapsedUs = (ulTickLast - ulTickStart) / TICKS_PER_US;
+	}
+	else
+	{
+		ptResult->ulElapsedUs = ulElapsedMs * 1000U;
+	}
+
+	ptState->ulBytes += ulSent + ulReceived;
+	ptResult->ulBytesSent = ulSent;
+	ptResult->ulBytesReceived = ulReceived;
+	ptResult->ulByteErrors = ulByteErrors;
+	ptResult->ulBusyTicks = ulBusyTicks;
+	ptResult->ulPolls = ptState->ulPolls;
+	ptResult->ulMaxRxFill = ulMaxFill;
+
+	/* Wait until all data in the TX FIFO is sent. This ends with the char
+	 * timeout like the BERT.
+	 */
+	ulTickLast = ticks_get();
+	do
+	{
+		ulValue  = uart_get_flags(ptState, ptUartArea);
+		ulValue &= HOSTMSK(uartfr_BUSY);
+	} while( ulValue!=0 && ticks_elapsed(ulTickLast, ulTimeoutCharTicks)==0 );
+}
+
+
+
+static int command_benchmark(CMD_STATE_T *ptState, UART_HANDLE_T *ptHandle)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_BENCHMARK_T *ptCmd;
+	unsigned long ulBaudRate;
+	unsigned long ulSize;
+	unsigned long ulTimeoutCharUs;
+	UART_SEQ_BENCHMARK_RESULT_T tResult;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_BENCHMARK_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the benchmark command left.\n");
+		}
+		iResult = -1;
+	}
+	else if( (ptState->pucRecCnt + sizeof(UART_SEQ_BENCHMARK_RESULT_T))>ptState->pucRecEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the receive data left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_BENCHMARK_T*)(ptState->pucCmdCnt);
+		ulBaudRate = ptCmd->s.ulBaudRate;
+		ulSize = ptCmd->s.ulSize;
+		ulTimeoutCharUs = ptCmd->s.ulTimeoutCharUs;
+
+		if( ulTimeoutCharUs==0 || ulTimeoutCharUs>TICKS_MAX_US )
+		{
+			uprintf("The char timeout must be between 1 and %dus.\n", TICKS_MAX_US);
+			iResult = -1;
+		}
+		else
+		{
+			/* A baud rate of 0 keeps the current one. A new baud rate stays
+			 * set after the command.
+			 */
+			iResult = 0;
+			if( ulBaudRate!=0 )
+			{
+				iResult = handle_set_baud_rate(ptHandle, ulBaudRate);
+			}
+			if( iResult==0 )
+			{
+				if( ptState->ulVerbose!=0U )
+				{
+					uprintf("BENCHMARK %d bytes with %d baud, char timeout = %dus\n", ulSize, ptHandle->ulCurrentBaudRate, ulTimeoutCharUs);
+				}
+
+				benchmark_transfer(ptState, ptHandle->ptUart, ulSize, ulTimeoutCharUs, &tResult);
+				if( ptState->iRxErrorStop!=0 )
+				{
+					iResult = -1;
+				}
+				else
+				{
+					if( ptState->ulVerbose!=0U )
+					{
+						uprintf("Sent %d bytes, received %d bytes with %d errors in %dus.\n", tResult.ulBytesSent, tResult.ulBytesReceived, tResult.ulByteErrors, tResult.ulElapsedUs);
+						uprintf("%d busy ticks, %d polls, maximum RX FIFO fill %d.\n", tResult.ulBusyTicks, tResult.ulPolls, tResult.ulMaxRxFill);
+					}
+
+					/* The receive buffer has no alignment. */
+					memcpy(ptState->pucRecCnt, &tResult, sizeof(UART_SEQ_BENCHMARK_RESULT_T));
+					ptState->pucRecCnt += sizeof(UART_SEQ_BENCHMARK_RESULT_T);
+					ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_BENCHMARK_T);
+				}
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+
+/* Start a block of commands which is executed several times. The block
+ * ends with an EndRepeat command. The receive buffer is either appended in
+ * each iteration or overwritten with the data of the next iteration.
+ */
+static int command_repeat(CMD_STATE_T *ptState)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_REPEAT_T *ptCmd;
+	unsigned long ulCount;
+	UART_SEQ_REPEAT_FLAG_T tFlags;
+	CMD_REPEAT_T *ptRepeat;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_REPEAT_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the repeat command left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_REPEAT_T*)(ptState->pucCmdCnt);
+		ulCount = ptCmd->s.ulCount;
+		tFlags = (UART_SEQ_REPEAT_FLAG_T)(ptCmd->s.ucFlags);
+
+		if( ulCount==0 )
+		{
+			uprintf("The repeat count must not be 0.\n");
+			iResult = -1;
+		}
+		else if( ptState->uiRepeatDepth>=CMD_REPEAT_DEPTH )
+		{
+			uprintf("Too many nested repeat blocks. The maximum is %d.\n", CMD_REPEAT_DEPTH);
+			iResult = -1;
+		}
+		else
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("REPEAT %d times%s\n", ulCount, ((tFlags&UART_SEQ_REPEAT_FLAG_Overwrite)!=0) ? ", overwrite the received data" : "");
+			}
+
+			ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_REPEAT_T);
+
+			ptRepeat = ptState->atRepeat + ptState->uiRepeatDepth;
+			ptRepeat->pucCmdStart = ptState->pucCmdCnt;
+			ptRepeat->pucRecStart = ptState->pucRecCnt;
+			ptRepeat->ulRemaining = ulCount;
+			ptRepeat->tFlags = tFlags;
+			++ptState->uiRepeatDepth;
+
+			iResult = 0;
+		}
+	}
+
+	return iResult;
+}
+
+
+
+static int command_end_repeat(CMD_STATE_T *ptState)
+{
+	int iResult;
+	CMD_REPEAT_T *ptRepeat;
+
+
+	if( ptState->uiRepeatDepth==0 )
+	{
+		uprintf("EndRepeat without a repeat command.\n");
+		iResult = -1;
+	}
+	else
+	{
+		ptRepeat = ptState->atRepeat + ptState->uiRepeatDepth - 1U;
+		--ptRepeat->ulRemaining;
+		if( ptRepeat->ulRemaining==0 )
+		{
+			/* This was the last iteration. */
+			--ptState->uiRepeatDepth;
+		}
+		else
+		{
+			ptState->pucCmdCnt = ptRepeat->pucCmdStart;
+
+			/* Throw away the data of this iteration. Keep the position in
+			 * the received stream for the expect command.
+			 */
+			if( (ptRepeat->tFlags & UART_SEQ_REPEAT_FLAG_Overwrite)!=0 && ptState->pucRecCnt>ptRepeat->pucRecStart )
+			{
+				ptState->ulRecDiscarded += (unsigned long)(ptState->pucRecCnt - ptRepeat->pucRecStart);
+				ptState->pucRecCnt = ptRepeat->pucRecStart;
+			}
+		}
+
+		iResult = 0;
+	}
+
+	return iResult;
+}
+
+
+
+
+/* Compare the last received bytes with the data and jump if they match.
+ * The jump can leave repeat blocks. The target was already checked by
+ * sequenceValidate. A jump without data is always taken.
+ */
+static int command_jump_if(CMD_STATE_T *ptState)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_JUMP_T *ptCmd;
+	unsigned long ulDataSize;
+	UART_SEQ_JUMP_FLAG_T tFlags;
+	unsigned long ulCmdSize;
+	unsigned long ulCnt;
+	unsigned char ucDiff;
+	int iMatch;
+	const unsigned char *pucData;
+	const unsigned char *pucMask;
+	unsigned char *pucReceived;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_JUMP_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the jump header left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_JUMP_T*)(ptState->pucCmdCnt);
+		ulDataSize = ptCmd->s.usDataSize;
+		tFlags = (UART_SEQ_JUMP_FLAG_T)(ptCmd->s.ucFlags);
+
+		/* The data is followed by the optional mask. */
+		ulCmdSize = sizeof(UART_SEQ_COMMAND_JUMP_T) + ulDataSize;
+		if( (tFlags & UART_SEQ_JUMP_FLAG_Mask)!=0 )
+		{
+			ulCmdSize += ulDataSize;
+		}
+
+		if( (ptState->pucCmdCnt + ulCmdSize)>ptState->pucCmdEnd )
+		{
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("Not enough data for the complete jump command left.\n");
+			}
+			iResult = -1;
+		}
+		else if( (ptState->pucRecStart + ulDataSize)>ptState->pucRecCnt )
+		{
+			uprintf("Comparing %d bytes, but only %d bytes were received.\n", ulDataSize, (unsigned long)(ptState->pucRecCnt - ptState->pucRecStart));
+			iResult = -1;
+		}
+		else
+		{
+			pucData = ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_JUMP_T);
+			pucMask = NULL;
+			if( (tFlags & UART_SEQ_JUMP_FLAG_Mask)!=0 )
+			{
+				pucMask = pucData + ulDataSize;
+			}
+			pucReceived = ptState->pucRecCnt - ulDataSize;
+
+			iMatch = 1;
+			for(ulCnt=0; ulCnt<ulDataSize; ++ulCnt)
+			{
+				ucDiff = (unsigned char)(pucReceived[ulCnt] ^ pucData[ulCnt]);
+				if( pucMask!=NULL )
+				{
+					ucDiff &= pucMask[ulCnt];
+				}
+				if( ucDiff!=0 )
+				{
+					iMatch = 0;
+					break;
+				}
+			}
+			if( (tFlags & UART_SEQ_JUMP_FLAG_Not)!=0 )
+			{
+				iMatch = (iMatch==0) ? 1 : 0;
+			}
+
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("JUMP IF%s %d bytes%s: %s\n", ((tFlags & UART_SEQ_JUMP_FLAG_Not)!=0) ? " NOT" : "", ulDataSize, (pucMask!=NULL) ? " with mask" : "", (iMatch!=0) ? "jump" : "continue");
+			}
+
+			/* Remove the compared data from the receive buffer like the
+			 * expect command.
+			 */
+			if( (tFlags & UART_SEQ_JUMP_FLAG_Remove)!=0 )
+			{
+				ptState->pucRecCnt = pucReceived;
+				ptState->ulRecDiscarded += ulDataSize;
+			}
+
+			ptState->pucCmdCnt += ulCmdSize;
+			if( iMatch!=0 )
+			{
+				ptState->uiRepeatDepth -= ptCmd->s.ucLeave;
+				ptState->pucCmdCnt += ptCmd->s.sOffset;
+			}
+
+			iResult = 0;
+		}
+	}
+
+	return iResult;
+}
+
+
+
+
+/* Load a register from the received data. The offset is either from the
+ * start of the receive buffer or back from the end of the received data.
+ */
+static int command_register_load(CMD_STATE_T *ptState)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_REGISTER_LOAD_T *ptCmd;
+	unsigned long ulRegister;
+	unsigned long ulOffset;
+	unsigned long ulSize;
+	unsigned long ulReceived;
+	unsigned long ulCnt;
+	unsigned long ulValue;
+	UART_SEQ_REGISTER_FLAG_T tFlags;
+	const unsigned char *pucData;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_REGISTER_LOAD_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the register load command left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_REGISTER_LOAD_T*)(ptState->pucCmdCnt);
+		ulRegister = ptCmd->s.ucRegister;
+		ulOffset = ptCmd->s.usOffset;
+		ulSize = ptCmd->s.ucSize;
+		tFlags = (UART_SEQ_REGISTER_FLAG_T)(ptCmd->s.ucFlags);
+		ulReceived = (unsigned long)(ptState->pucRecCnt - ptState->pucRecStart);
+
+		/* Convert the offset to the start of the receive buffer. An offset
+		 * before the start fails like one after the end.
+		 */
+		if( (tFlags & UART_SEQ_REGISTER_FLAG_FromEnd)!=0 )
+		{
+			ulOffset = (ulOffset<=ulReceived) ? (ulReceived - ulOffset) : ulReceived;
+		}
+
+		if( ulRegister>=UART_SEQ_REGISTER_Count || ulSize<1U || ulSize>4U )
+		{
+			uprintf("Invalid register load: r%d with %d bytes.\n", ulRegister, ulSize);
+			iResult = -1;
+		}
+		else if( (ulOffset + ulSize)>ulReceived )
+		{
+			uprintf("Loading %d bytes from offset %d, but only %d bytes were received.\n", ulSize, ulOffset, ulReceived);
+			iResult = -1;
+		}
+		else
+		{
+			pucData = ptState->pucRecStart + ulOffset;
+			ulValue = 0;
+			for(ulCnt=0; ulCnt<ulSize; ++ulCnt)
+			{
+				if( (tFlags & UART_SEQ_REGISTER_FLAG_BigEndian)!=0 )
+				{
+					ulValue = (ulValue << 8U) | pucData[ulCnt];
+				}
+				else
+				{
+					ulValue |= ((unsigned long)pucData[ulCnt]) << (8U * ulCnt);
+				}
+			}
+			ptState->aulRegister[ulRegister] = ulValue;
+
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("LOAD r%d = 0x%08x\n", ulRegister, ulValue);
+			}
+
+			ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_REGISTER_LOAD_T);
+			iResult = 0;
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Set a register or add a value to it. The registers wrap around at 32
+ * bits.
+ */
+static int command_register_op(CMD_STATE_T *ptState)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_REGISTER_OP_T *ptCmd;
+	unsigned long ulRegister;
+	unsigned long ulValue;
+	UART_SEQ_REGISTER_OP_T tOperation;
+
+
+	if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_REGISTER_OP_T))>ptState->pucCmdEnd )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the register operation left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptCmd = (const UART_SEQ_COMMAND_REGISTER_OP_T*)(ptState->pucCmdCnt);
+		ulRegister = ptCmd->s.ucRegister;
+		tOperation = (UART_SEQ_REGISTER_OP_T)(ptCmd->s.ucOperation);
+		ulValue = ptCmd->s.ulValue;
+
+		iResult = 0;
+		if( ulRegister>=UART_SEQ_REGISTER_Count )
+		{
+			uprintf("Invalid register: r%d\n", ulRegister);
+			iResult = -1;
+		}
+		else
+		{
+			switch( tOperation )
+			{
+			case UART_SEQ_REGISTER_OP_Set:
+				break;
+
+			case UART_SEQ_REGISTER_OP_Add:
+				ulValue = (ptState->aulRegister[ulRegister] + ulValue) & 0xffffffffU;
+				break;
+
+			default:
+				uprintf("Invalid register operation: %d\n", tOperation);
+				iResult = -1;
+				break;
+			}
+		}
+
+		if( iResult==0 )
+		{
+			ptState->aulRegister[ulRegister] = ulValue;
+
+			if( ptState->ulVerbose!=0U )
+			{
+				uprintf("REGISTER r%d = 0x%08x\n", ulRegister, ulValue);
+			}
+
+			ptState->pucCmdCnt += sizeof(UART_SEQ_COMMAND_REGISTER_OP_T);
+		}
+	}
+
+	return iResult;
+}
+
+
+
+typedef struct UART_INSTANCE_STRUCT
+{
+	HOSTADEF(UART) * const ptArea;
+#if ASIC_TYP==ASIC_TYP_NETX10 || ASIC_TYP==ASIC_TYP_NETX50 || ASIC_TYP==ASIC_TYP_NETX56 || ASIC_TYP==ASIC_TYP_NETX6 || ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
+	HOSTMMIODEF atMMIO[4];
+#endif
+} UART_INSTANCE_T;
+
+
+
+static const UART_INSTANCE_T atUartInstances[] =
+{
+#if ASIC_TYP==ASIC_TYP_NETX10
+	{
+		.ptArea = (NX10_UART_AREA_T * const)Addr_NX10_uart0,
+		.atMMIO =
+		{
+			NX10_MMIO_CFG_uart0_rxd,
+			NX10_MMIO_CFG_uart0_txd,
+			NX10_MMIO_CFG_uart0_rtsn,
+			NX10_MMIO_CFG_uart0_ctsn
+		}
+	},
+
+	{
+		.ptArea = (NX10_UART_AREA_T * const)Addr_NX10_uart1,
+		.atMMIO =
+		{
+			NX10_MMIO_CFG_uart1_rxd,
+			NX10_MMIO_CFG_uart1_txd,
+			NX10_MMIO_CFG_uart1_rtsn,
+			NX10_MMIO_CFG_uart1_ctsn
+		}
+	}
+
+#elif ASIC_TYP==ASIC_TYP_NETX50
+	{
+		.ptArea = (NX50_UART_AREA_T * const)Addr_NX50_uart0,
+		.atMMIO =
+		{
+			NX50_MMIO_CFG_uart0_rxd,
+			NX50_MMIO_CFG_uart0_txd,
+			NX50_MMIO_CFG_uart0_rts,
+			NX50_MMIO_CFG_uart0_cts
+		}
+	},
+
+	{
+		.ptArea = (NX50_UART_AREA_T * const)Addr_NX50_uart1,
+		.atMMIO =
+		{
+			NX50_MMIO_CFG_uart1_rxd,
+			NX50_MMIO_CFG_uart1_txd,
+			NX50_MMIO_CFG_uart1_rts,
+			NX50_MMIO_CFG_uart1_cts
+		}
+	},
+
+	{
+		.ptArea = (NX50_UART_AREA_T * const)Addr_NX50_uart2,
+		.atMMIO =
+		{
+			NX50_MMIO_CFG_uart2_rxd,
+			NX50_MMIO_CFG_uart2_txd,
+			NX50_MMIO_CFG_uart2_rts,
+			NX50_MMIO_CFG_uart2_cts
+		}
+	}
+
+#elif ASIC_TYP==ASIC_TYP_NETX56
+	{
+		.ptArea = (NX56_UART_AREA_T * const)Addr_NX56_uart0,
+		.atMMIO =
+		{
+			NX56_MMIO_CFG_uart0_rxd,
+			NX56_MMIO_CFG_uart0_txd,
+			NX56_MMIO_CFG_uart0_rtsn,
+			NX56_MMIO_CFG_uart0_ctsn
+		}
+	},
+
+	{
+		.ptArea = (NX56_UART_AREA_T * const)Addr_NX56_uart1,
+		.atMMIO =
+		{
+			NX56_MMIO_CFG_uart1_rxd,
+			NX56_MMIO_CFG_uart1_txd,
+			NX56_MMIO_CFG_uart1_rtsn,
+			NX56_MMIO_CFG_uart1_ctsn
+		}
+	},
+
+	{
+		.ptArea = (NX56_UART_AREA_T * const)Addr_NX56_uart2,
+		.atMMIO =
+		{
+			NX56_MMIO_CFG_uart2_rxd,
+			NX56_MMIO_CFG_uart2_txd,
+			NX56_MMIO_CFG_uart2_rtsn,
+			NX56_MMIO_CFG_uart2_ctsn
+		}
+	}
+
+#elif ASIC_TYP==ASIC_TYP_NETX6
+	{
+		.ptArea = (NX6_UART_AREA_T * const)Addr_NX6_uart0,
+		.atMMIO =
+		{
+			NX6_MMIO_CFG_uart0_rxd,
+			NX6_MMIO_CFG_uart0_txd,
+			NX6_MMIO_CFG_uart0_rtsn,
+			NX6_MMIO_CFG_uart0_ctsn
+		}
+	},
+
+	{
+		.ptArea = (NX6_UART_AREA_T * const)Addr_NX6_uart1,
+		.atMMIO =
+		{
+			NX6_MMIO_CFG_uart1_rxd,
+			NX6_MMIO_CFG_uart1_txd,
+			NX6_MMIO_CFG_uart1_rtsn,
+			NX6_MMIO_CFG_uart1_ctsn
+		}
+	},
+
+	{
+		.ptArea = (NX6_UART_AREA_T * const)Addr_NX6_uart2,
+		.atMMIO =
+		{
+			NX6_MMIO_CFG_uart2_rxd,
+			NX6_MMIO_CFG_uart2_txd,
+			NX6_MMIO_CFG_uart2_rtsn,
+			NX6_MMIO_CFG_uart2_ctsn
+		}
+	}
+
+#elif ASIC_TYP==ASIC_TYP_NETX500
+	{
+		.ptArea = (NX500_UART_AREA_T * const)Addr_NX500_uart0
+	},
+
+	{
+		.ptArea = (NX500_UART_AREA_T * const)Addr_NX500_uart1
+	},
+
+	{
+		.ptArea = (NX500_UART_AREA_T * const)Addr_NX500_uart2
+	}
+
+#elif ASIC_TYP==ASIC_TYP_NETX4000_RELAXED || ASIC_TYP==ASIC_TYP_NETX4000
+	{
+		.ptArea = (HOSTADEF(UART) * const)HOSTADDR(uart0),
+		.atMMIO =
+		{
+			HOSTMMIO(UART0_RXD),
+			HOSTMMIO(UART0_TXD),
+			HOSTMMIO(UART0_RTSN),
+			HOSTMMIO(UART0_CTSN)
+		}
+	},
+
+	{
+		.ptArea = (HOSTADEF(UART) * const)HOSTADDR(uart1),
+		.atMMIO =
+		{
+			HOSTMMIO(UART1_RXD),
+			HOSTMMIO(UART1_TXD),
+			HOSTMMIO(UART1_RTSN),
+			HOSTMMIO(UART1_CTSN)
+		}
+	},
+
+	{
+		.ptArea = (HOSTADEF(UART) * const)HOSTADDR(uart2),
+		.atMMIO =
+		{
+			HOSTMMIO(UART2_RXD),
+			HOSTMMIO(UART2_TXD),
+			HOSTMMIO(UART2_RTSN),
+			HOSTMMIO(UART2_CTSN)
+		}
+	}
+
+#elif ASIC_TYP==ASIC_TYP_NETX90_MPW
+	{
+		.ptArea = (NX90MPW_UART_AREA_T * const)Addr_NX90MPW_uart_com
+	}
+
+#elif ASIC_TYP==ASIC_TYP_NETX90
+	{
+		.ptArea = (NX90_UART_AREA_T * const)Addr_NX90_uart
+	}
+
+#elif ASIC_TYP==ASIC_TYP_NETX90_MPW_APP || ASIC_TYP==ASIC_TYP_NETX90_APP
+	{
+		.ptArea = (NX90_UART_AREA_T * const)Addr_NX90_uart_app
+	},
+
+	{
+		.ptArea = (NX90_UART_AREA_T * const)Addr_NX90_uart_xpic_app
+	}
+
+#elif ASIC_TYP==ASIC_TYP_HOSTSIM
+	{
+		.ptArea = (HOSTADEF(UART) * const)HOSTADDR(uart0)
+	},
+
+	{
+		.ptArea = (HOSTADEF(UART) * const)HOSTADDR(uart1)
+	},
+
+	{
+		.ptArea = (HOSTADEF(UART) * const)HOSTADDR(uart2)
+	}
+
+#else
+#       error "Unsupported ASIC_TYPE!"
+
+#endif
+};
+
+
+
+#if ASIC_TYP==ASIC_TYP_NETX10 || ASIC_TYP==ASIC_TYP_NETX50 || ASIC_TYP==ASIC_TYP_NETX56 || ASIC_TYP==ASIC_TYP_NETX6 || ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
+static const char *apcPinOrder[4] =
+{
+	"RX",
+	"TX",
+	"RTS",
+	"CTS"
+};
+#endif
+
+
+
+static TEST_RESULT_T processCommandOpen(unsigned long ulVerbose, UART_PARAMETER_OPEN_T *ptParameter)
+{
+	TEST_RESULT_T tResult;
+	int iResult;
+	unsigned long ulCore;
+	UART_HANDLE_T *ptHandle;
+	const UART_INSTANCE_T *ptUartInstance;
+	HOSTADEF(UART) *ptUartArea;
+	unsigned long ulValue;
+	unsigned long ulBaudRate;
+	unsigned long ulFlowControl;
+	unsigned long ulTimeoutCtsMs;
+	BAUDRATE_SETTING_T tSetting;
+#if ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
+	unsigned long ulPortControl;
+#endif
+#if ASIC_TYP==ASIC_TYP_NETX10 || ASIC_TYP==ASIC_TYP_NETX50 || ASIC_TYP==ASIC_TYP_NETX56 || ASIC_TYP==ASIC_TYP_NETX6 || ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
+	unsigned int uiCnt;
+	const char *pcName;
+	HOSTDEF(ptAsicCtrlArea);
+	HOSTDEF(ptMmioCtrlArea);
+#elif ASIC_TYP==ASIC_TYP_NETX500
+	HOSTDEF(ptGpioArea);
+	unsigned int uiIdx;
+#endif
+
+	/* Start a new trace. */
+	if( ptParameter->sizTrace!=0 )
+	{
+		trace_init((UART_TRACE_T*)(ptParameter->ptTrace), ptParameter->sizTrace);
+	}
+
+	/* Check the parameter. */
+	tResult = TEST_RESULT_ERROR;
+	ulCore = ptParameter->ulUartCore;
+
+	ulFlowControl = ptParameter->ulFlowControl;
+	ulTimeoutCtsMs = ptParameter->ulTimeoutCtsMs;
+
+	/* Is the core number valid? */
+	if( ulCore>=(sizeof(atUartInstances)/sizeof(atUartInstances[0])) )
+	{
+		uprintf("The UART core number %d is invalid on the host %s.\n", ulCore, HOSTNAME);
+	}
+	else if( (ulFlowControl & ~((unsigned long)UART_FLOW_CONTROL_Cts))!=0 )
+	{
+		uprintf("Invalid flow control flags: 0x%08x\n", ulFlowControl);
+	}
+	else if( (ulFlowControl & UART_FLOW_CONTROL_Cts)!=0 && ulTimeoutCtsMs==0 )
+	{
+		uprintf("The CTS timeout is required.\n");
+	}
+	else if( uart_rx_error_actions_check(ptParameter->ulRxErrorActions)!=0 )
+	{
+		uprintf("Invalid receive error actions: 0x%08x\n", ptParameter->ulRxErrorActions);
+	}
+	else if( ptParameter->ulLoopback>1U )
+	{
+		uprintf("Invalid loopback mode: %d\n", ptParameter->ulLoopback);
+	}
+	else
+	{
+		ptUartInstance = atUartInstances + ulCore;
+
+		/* Get the UART area. */
+		ptUartArea = ptUartInstance->ptArea;
+
+		/* Disable the UART. */
+		ptUartArea->ulUartcr = 0;
+
+		/* Use baud rate mode 2. */
+		ptUartArea->ulUartcr_2 = HOSTMSK(uartcr_2_Baud_Rate_Mode);
+
+		/* Set the baud rate. */
+		ulBaudRate = ptParameter->ulBaudRate;
+		iResult = uart_set_baud_rate(ptUartArea, ulBaudRate, ptParameter->ulMaxErrorPpm, &tSetting);
+
+		/* Return the real baud rate also for a rejected baud rate. */
+		ptParameter->ulAchievedBaudRate = tSetting.ulAchievedBaudRate;
+		ptParameter->lBaudRateErrorPpm = tSetting.lErrorPpm;
+
+		if( iResult==0 )
+		{
+			/* Set the UART to 8N1, FIFO enabled. */
+			ulValue  = HOSTMSK(uartlcr_h_WLEN);
+			ulValue |= HOSTMSK(uartlcr_h_FEN);
+			ptUartArea->ulUartlcr_h = ulValue;
+
+			/* Disable all drivers. */
+			ptUartArea->ulUartdrvout = 0;
+
+			/* Set up the hardware handshake. The automatic RTS mode is
+			 * the transmit enable for RS-485, so it is not used.
+			 */
+			ulValue = 0;
+			if( (ulFlowControl & UART_FLOW_CONTROL_Cts)!=0 )
+			{
+				ulValue |= HOSTMSK(uartrts_CTS_ctr);
+			}
+			else
+			{
+				ulTimeoutCtsMs = 0;
+			}
+			ptUartArea->ulUartrts = ulValue;
+
+			/* Enable the UART. */
+			ulValue = HOSTMSK(uartcr_uartEN);
+			if( ptParameter->ulLoopback!=0 )
+			{
+				ulValue |= HOSTMSK(uartcr_LBE);
+			}
+			ptUartArea->ulUartcr = ulValue;
+
+			if( ulVerbose!=0 )
+			{
+				/* Setup the UART. */
+				uprintf("Setup UART %d with %d baud (native 0x%04x, %d ppm).\n", ulCore, ulBaudRate, tSetting.ulDivider, tSetting.lErrorPpm);
+				if( (ulFlowControl & UART_FLOW_CONTROL_Cts)!=0 )
+				{
+					uprintf("  TX waits for CTS at most %dms.\n", ulTimeoutCtsMs);
+				}
+				if( ptParameter->ulLoopback!=0 )
+				{
+					uprintf("  The internal loopback connects TX with RX.\n");
+				}
+			}
+#if ASIC_TYP==ASIC_TYP_NETX10 || ASIC_TYP==ASIC_TYP_NETX50 || ASIC_TYP==ASIC_TYP_NETX56 || ASIC_TYP==ASIC_TYP_NETX6 || ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
+			for(uiCnt=0; uiCnt<4; uiCnt++)
+			{
+				ulValue = ptParameter->aucMMIO[uiCnt];
+#       if ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
+				ulPortControl = ptParameter->ausPortcontrol[uiCnt];
+#       endif
+
+				if( ulVerbose!=0 )
+				{
+					pcName = apcPinOrder[uiCnt];
+
+					if( ulValue!=0xff )
+					{
+#       if ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
+						if( ulPortControl!=PORTCONTROL_SKIP )
+						{
+							uprintf("  %s = MMIO%d with port control 0x%04x\n", pcName, ulValue, ulPortControl);
+						}
+						else
+						{
+							uprintf("  %s = MMIO%d without port control\n", pcName, ulValue);
+						}
+#       else
+						uprintf("  %s = MMIO%d\n", pcName, ulValue);
+#       endif
+					}
+					else
+					{
+						uprintf("  %s without MMIO\n", pcName);
+					}
+				}
+
+				if( ulValue!=0xff )
+				{
+					ptAsicCtrlArea->ulAsic_ctrl_access_key = ptAsicCtrlArea->ulAsic_ctrl_access_key;    /* @suppress("Assignment to itself") */
+					ptMmioCtrlArea->aulMmio_cfg[ulValue] = ptUartInstance->atMMIO[uiCnt];
+				}
+			}
+#       if ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
+			portcontrol_apply_mmio(ptParameter->aucMMIO, ptParameter->ausPortcontrol, 4);
+#       endif
+#elif ASIC_TYP==ASIC_TYP_NETX500
+			uiIdx = uiUartUnit << 2;
+			ptGpioArea->aulGpio_cfg[uiIdx+0] = 2;
+			ptGpioArea->aulGpio_cfg[uiIdx+1] = 2;
+			ptGpioArea->aulGpio_cfg[uiIdx+2] = 2;
+			ptGpioArea->aulGpio_cfg[uiIdx+3] = 2;
+#endif
+
+			/* Enable the drivers. */
+			ulValue = HOSTMSK(uartdrvout_DRVTX);
+			ptUartArea->ulUartdrvout = ulValue;
+
+			/* Fill the handle. */
+			ptHandle = (UART_HANDLE_T*)ptParameter->ptHandle;
+			ptHandle->ptUart = ptUartArea;
+			ptHandle->ulUartIndex = ulCore;
+			ptHandle->ulCurrentBaudRate = ulBaudRate;
+			ptHandle->ulCurrentDeviceSpecificSpeedValue = tSetting.ulDivider;
+			ptHandle->ulAchievedBaudRate = tSetting.ulAchievedBaudRate;
+			ptHandle->lBaudRateErrorPpm = tSetting.lErrorPpm;
+			ptHandle->ulMaxErrorPpm = ptParameter->ulMaxErrorPpm;
+			ptHandle->ulRxErrorActions = ptParameter->ulRxErrorActions;
+			ptHandle->ulTimeoutCtsMs = ulTimeoutCtsMs;
+
+			/* Do not count old errors in the first sequence. */
+			ptUartArea->ulUartrsr = 0;
+
+			tResult = TEST_RESULT_OK;
+		}
+	}
+
+	return tResult;
+}
+
+
+
+/* Get the size of a command including the opcode. The command must be
+ * complete. The commands check their parameters again when they run.
+ */
+static int sequence_get_command_size(const unsigned char *pucCmd, const unsigned char *pucEnd, unsigned long *pulSize)
+{
+	int iResult;
+	const unsigned char *pucHeader;
+	const unsigned char *pucPattern;
+	unsigned long ulSize;
+	unsigned long ulCnt;
+	unsigned long ulPatterns;
+
+
+	iResult = 0;
+	pucHeader = pucCmd + 1U;
+	ulSize = 0;
+	switch( (UART_SEQ_COMMAND_T)(*pucCmd) )
+	{
+	case UART_SEQ_COMMAND_Clean:
+	case UART_SEQ_COMMAND_EndRepeat:
+		break;
+
+	case UART_SEQ_COMMAND_Send:
+		ulSize = sizeof(UART_SEQ_COMMAND_WRITE_T);
+		if( (pucHeader + ulSize)<=pucEnd )
+		{
+			ulSize += ((const UART_SEQ_COMMAND_WRITE_T*)pucHeader)->s.usDataSize;
+		}
+		break;
+
+	case UART_SEQ_COMMAND_Receive:
+		ulSize = sizeof(UART_SEQ_COMMAND_READ_T);
+		break;
+
+	case UART_SEQ_COMMAND_SendLong:
+		ulSize = sizeof(UART_SEQ_COMMAND_WRITE_LONG_T);
+		if( (pucHeader + ulSize)<=pucEnd )
+		{
+			/* Compare the 32 bit size before the addition, which can wrap around. */
+			ulCnt = ((const UART_SEQ_COMMAND_WRITE_LONG_T*)pucHeader)->s.ulDataSize;
+			if( ulCnt>(unsigned long)(pucEnd - pucHeader) - ulSize )
+			{
+				iResult = -1;
+			}
+			else
+			{
+				ulSize += ulCnt;
+			}
+		}
+		break;
+
+	case UART_SEQ_COMMAND_ReceiveLong:
+		ulSize = sizeof(UART_SEQ_COMMAND_READ_LONG_T);
+		break;
+
+	case UART_SEQ_COMMAND_BaudRate:
+		ulSize = sizeof(UART_SEQ_COMMAND_BAUDRATE_T);
+		break;
+
+	case UART_SEQ_COMMAND_Delay:
+		ulSize = sizeof(UART_SEQ_COMMAND_DELAY_T);
+		break;
+
+	case UART_SEQ_COMMAND_Transceive:
+		ulSize = sizeof(UART_SEQ_COMMAND_TRANSCEIVE_T);
+		if( (pucHeader + ulSize)<=pucEnd )
+		{
+			ulSize += ((const UART_SEQ_COMMAND_TRANSCEIVE_T*)pucHeader)->s.usSendSize;
+		}
+		break;
+
+	case UART_SEQ_COMMAND_Expect:
+		ulSize = sizeof(UART_SEQ_COMMAND_EXPECT_T);
+		if( (pucHeader + ulSize)<=pucEnd )
+		{
+			ulCnt = ((const UART_SEQ_COMMAND_EXPECT_T*)pucHeader)->s.usDataSize;
+			if( (((const UART_SEQ_COMMAND_EXPECT_T*)pucHeader)->s.ucFlags & UART_SEQ_EXPECT_FLAG_Mask)!=0 )
+			{
+				ulCnt *= 2U;
+			}
+			ulSize += ulCnt;
+		}
+		break;
+
+	case UART_SEQ_COMMAND_ReceiveUntil:
+		ulSize = sizeof(UART_SEQ_COMMAND_RECEIVE_UNTIL_T);
+		if( (pucHeader + ulSize)<=pucEnd )
+		{
+			ulPatterns = ((const UART_SEQ_COMMAND_RECEIVE_UNTIL_T*)pucHeader)->s.ucPatterns;
+			pucPattern = pucHeader + ulSize;
+			for(ulCnt=0; ulCnt<ulPatterns; ++ulCnt)
+			{
+				if( pucPattern>=pucEnd )
+				{
+					iResult = -1;
+					break;
+				}
+				pucPattern += 1U + pucPattern[0];
+			}
+			ulSize = (unsigned long)(pucPattern - pucHeader);
+		}
+		break;
+
+	case UART_SEQ_COMMAND_ReceiveIdle:
+		ulSize = sizeof(UART_SEQ_COMMAND_RECEIVE_IDLE_T);
+		break;
+
+	case UART_SEQ_COMMAND_ReceiveUs:
+	case UART_SEQ_COMMAND_ReceiveTimestamps:
+		ulSize = sizeof(UART_SEQ_COMMAND_READ_US_T);
+		break;
+
+	case UART_SEQ_COMMAND_DelayUs:
+		ulSize = sizeof(UART_SEQ_COMMAND_DELAY_US_T);
+		break;
+
+	case UART_SEQ_COMMAND_Repeat:
+		ulSize = sizeof(UART_SEQ_COMMAND_REPEAT_T);
+		break;
+
+	case UART_SEQ_COMMAND_Bert:
+		ulSize = sizeof(UART_SEQ_COMMAND_BERT_T);
+		break;
+
+	case UART_SEQ_COMMAND_BaudSweep:
+		ulSize = sizeof(UART_SEQ_COMMAND_BAUD_SWEEP_T);
+		break;
+
+	case UART_SEQ_COMMAND_AutoBaud:
+		ulSize = sizeof(UART_SEQ_COMMAND_AUTOBAUD_T);
+		break;
+
+	case UART_SEQ_COMMAND_Benchmark:
+		ulSize = sizeof(UART_SEQ_COMMAND_BENCHMARK_T);
+		break;
+
+	case UART_SEQ_COMMAND_JumpIf:
+		ulSize = sizeof(UART_SEQ_COMMAND_JUMP_T);
+		if( (pucHeader + ulSize)<=pucEnd )
+		{
+			ulCnt = ((const UART_SEQ_COMMAND_JUMP_T*)pucHeader)->s.usDataSize;
+			if( (((const UART_SEQ_COMMAND_JUMP_T*)pucHeader)->s.ucFlags & UART_SEQ_JUMP_FLAG_Mask)!=0 )
+			{
+				ulCnt *= 2U;
+			}
+			ulSize += ulCnt;
+		}
+		break;
+
+	case UART_SEQ_COMMAND_RegisterLoad:
+		ulSize = sizeof(UART_SEQ_COMMAND_REGISTER_LOAD_T);
+		break;
+
+	case UART_SEQ_COMMAND_RegisterOp:
+		ulSize = sizeof(UART_SEQ_COMMAND_REGISTER_OP_T);
+		break;
+
+	case UART_SEQ_COMMAND_SendRegisters:
+		ulSize = sizeof(UART_SEQ_COMMAND_SEND_REGISTERS_T);
+		if( (pucHeader + ulSize)<=pucEnd )
+		{
+			ulSize += ((const UART_SEQ_COMMAND_SEND_REGISTERS_T*)pucHeader)->s.ucPlaceholders * sizeof(UART_SEQ_PLACEHOLDER_T);
+			ulSize += ((const UART_SEQ_COMMAND_SEND_REGISTERS_T*)pucHeader)->s.usDataSize;
+		}
+		break;
+
+	case UART_SEQ_COMMAND_CrcAppend:
+		ulSize = sizeof(UART_SEQ_COMMAND_CRC_APPEND_T);
+		break;
+
+	case UART_SEQ_COMMAND_CrcVerify:
+		ulSize = sizeof(UART_SEQ_COMMAND_CRC_VERIFY_T);
+		break;
+
+	case UART_SEQ_COMMAND_SendPattern:
+		ulSize = sizeof(UART_SEQ_COMMAND_SEND_PATTERN_T);
+		if( (pucHeader + ulSize)<=pucEnd && ((const UART_SEQ_COMMAND_SEND_PATTERN_T*)pucHeader)->s.ucPattern==UART_SEQ_PATTERN_Block )
+		{
+			ulSize += ((const UART_SEQ_COMMAND_SEND_PATTERN_T*)pucHeader)->s.usBlockSize;
+		}
+		break;
+
+	default:
+		iResult = -1;
+		break;
+	}
+
+	/* Compare the sizes, as the size can move the pointer around. All other
+	 * sizes are sums of 16 bit values and can not wrap around.
+	 */
+	if( iResult==0 && ulSize>(unsigned long)(pucEnd - pucHeader) )
+	{
+		iResult = -1;
+	}
+	*pulSize = 1U + ulSize;
+
+	return iResult;
+}
+
+
+
+/* The position in a sequence with the open repeat blocks. A block is
+ * identified by its first command.
+ */
+typedef struct SEQ_WALK_STRUCT
+{
+	const unsigned char *pucCmd;
+	unsigned int uiDepth;
+	const unsigned char *apucBlock[CMD_REPEAT_DEPTH];
+} SEQ_WALK_T;
+
+
+
+/* Move to the next command and follow the repeat blocks. */
+static int sequence_walk_step(const CMD_STATE_T *ptState, SEQ_WALK_T *ptWalk)
+{
+	int iResult;
+	unsigned long ulSize;
+	unsigned char ucCommand;
+
+
+	ucCommand = ptWalk->pucCmd[0];
+	iResult = sequence_get_command_size(ptWalk->pucCmd, ptState->pucCmdEnd, &ulSize);
+	if( iResult!=0 )
+	{
+		uprintf("The command 0x%02x at offset %d is invalid or incomplete.\n", ucCommand, (unsigned long)(ptWalk->pucCmd - ptState->pucCmdStart));
+	}
+	else
+	{
+		ptWalk->pucCmd += ulSize;
+		if( ucCommand==UART_SEQ_COMMAND_Repeat )
+		{
+			if( ptWalk->uiDepth>=CMD_REPEAT_DEPTH )
+			{
+				uprintf("Too many nested repeat blocks. The maximum is %d.\n", CMD_REPEAT_DEPTH);
+				iResult = -1;
+			}
+			else
+			{
+				ptWalk->apucBlock[ptWalk->uiDepth] = ptWalk->pucCmd;
+				++ptWalk->uiDepth;
+			}
+		}
+		else if( ucCommand==UART_SEQ_COMMAND_EndRepeat )
+		{
+			if( ptWalk->uiDepth==0 )
+			{
+				uprintf("EndRepeat without a repeat command.\n");
+				iResult = -1;
+			}
+			else
+			{
+				--ptWalk->uiDepth;
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Check the target of a jump. It must be the start of a command or the end
+ * of the sequence. The jump can leave repeat blocks, but it must not enter
+ * one. Otherwise EndRepeat would not find its repeat command.
+ */
+static int sequence_check_jump(const CMD_STATE_T *ptState, const SEQ_WALK_T *ptJump, const unsigned char *pucJump)
+{
+	int iResult;
+	const UART_SEQ_COMMAND_JUMP_T *ptCmd;
+	const unsigned char *pucTarget;
+	unsigned long ulOffset;
+	long lTarget;
+	unsigned int uiLeave;
+	unsigned int uiCnt;
+	SEQ_WALK_T tTarget;
+
+
+	ptCmd = (const UART_SEQ_COMMAND_JUMP_T*)(pucJump + 1U);
+	ulOffset = (unsigned long)(pucJump - ptState->pucCmdStart);
+	uiLeave = ptCmd->s.ucLeave;
+
+	/* The offset is relative to the end of the jump command. */
+	lTarget = (long)(ptJump->pucCmd - ptState->pucCmdStart) + ptCmd->s.sOffset;
+
+	iResult = -1;
+	if( lTarget<0 || lTarget>(long)(ptState->pucCmdEnd - ptState->pucCmdStart) )
+	{
+		uprintf("The jump at offset %d points outside the sequence.\n", ulOffset);
+	}
+	else if( uiLeave>ptJump->uiDepth )
+	{
+		uprintf("The jump at offset %d leaves %d repeat blocks, but it is only in %d.\n", ulOffset, uiLeave, ptJump->uiDepth);
+	}
+	else
+	{
+		pucTarget = ptState->pucCmdStart + lTarget;
+
+		tTarget.pucCmd = ptState->pucCmdStart;
+		tTarget.uiDepth = 0;
+		iResult = 0;
+		while( iResult==0 && tTarget.pucCmd<pucTarget )
+		{
+			iResult = sequence_walk_step(ptState, &tTarget);
+		}
+		if( iResult==0 )
+		{
+			if( tTarget.pucCmd!=pucTarget )
+			{
+				uprintf("The jump at offset %d does not point to the start of a command.\n", ulOffset);
+				iResult = -1;
+			}
+			else
+			{
+				/* All blocks around the target must also be around the jump. */
+				if( tTarget.uiDepth>ptJump->uiDepth )
+				{
+					iResult = -1;
+				}
+				else
+				{
+					for(uiCnt=0; uiCnt<tTarget.uiDepth; ++uiCnt)
+					{
+						if( tTarget.apucBlock[uiCnt]!=ptJump->apucBlock[uiCnt] )
+						{
+							iResult = -1;
+							break;
+						}
+					}
+				}
+
+				if( iResult!=0 )
+				{
+					uprintf("The jump at offset %d enters a repeat block.\n", ulOffset);
+				}
+				else if( tTarget.uiDepth!=(ptJump->uiDepth - uiLeave) )
+				{
+					uprintf("The jump at offset %d must leave %d repeat blocks, but it leaves %d.\n", ulOffset, ptJump->uiDepth - tTarget.uiDepth, uiLeave);
+					iResult = -1;
+				}
+			}
+		}
+	}
+
+	return iResult;
+}
+
+
+
+/* Check the complete sequence before it runs. All commands must be
+ * complete, the repeat blocks must be balanced and all jumps must have a
+ * valid target. This is the only check of the jump targets.
+ */
+static int sequenceValidate(const CMD_STATE_T *ptState)
+{
+	int iResult;
+	const unsigned char *pucCmd;
+	SEQ_WALK_T tWalk;
+
+
+	tWalk.pucCmd = ptState->pucCmdStart;
+	tWalk.uiDepth = 0;
+	iResult = 0;
+	while( iResult==0 && tWalk.pucCmd<ptState->pucCmdEnd )
+	{
+		pucCmd = tWalk.pucCmd;
+		iResult = sequence_walk_step(ptState, &tWalk);
+		if( iResult==0 && pucCmd[0]==UART_SEQ_COMMAND_JumpIf )
+		{
+			iResult = sequence_check_jump(ptState, &tWalk, pucCmd);
+		}
+	}
+	if( iResult==0 && tWalk.uiDepth!=0 )
+	{
+		uprintf("The sequence ends in a repeat block. EndRepeat is missing.\n");
+		iResult = -1;
+	}
+
+	return iResult;
+}
+
+
+
+static int sequenceStateInit(CMD_STATE_T *ptState, unsigned long ulVerbose, const UART_PARAMETER_RUN_SEQUENCE_T *ptParameter)
+{
+	int iResult;
+	unsigned long ulTelemetrySize;
+	unsigned int uiCnt;
+
+
+	/* Get the verbose flag. */
+	ptState->ulVerbose = ulVerbose;
+	ptState->ulUartIndex = ((const UART_HANDLE_T*)(ptParameter->ptHandle))->ulUartIndex;
+
+	ptState->pucCmdStart = ptParameter->pucCommand;
+	ptState->pucCmdCnt = ptParameter->pucCommand;
+	ptState->pucCmdEnd = ptState->pucCmdCnt + ptParameter->sizCommand;
+	ptState->pucRecStart = ptParameter->pucReceivedData;
+	ptState->pucRecCnt = ptParameter->pucReceivedData;
+	ptState->pucRecEnd = ptState->pucRecCnt + ptParameter->sizReceivedDataMax;
+	ptState->ulRecDiscarded = 0;
+	ptState->ulExpectMismatches = 0;
+	ptState->ulExpectFirstMismatch = 0xffffffffU;
+	ptState->uiRepeatDepth = 0;
+	ptState->ulPolls = 0;
+	ptState->ulBytes = 0;
+	ptState->ulTelemetryMax = ptParameter->ulTelemetryMax;
+	ptState->ulTelemetryRecords = 0;
+	ptState->ulRxErrorActions = ((const UART_HANDLE_T*)(ptParameter->ptHandle))->ulRxErrorActions;
+	for(uiCnt=0; uiCnt<UART_RX_ERROR_COUNT; ++uiCnt)
+	{
+		ptState->aulRxErrors[uiCnt] = 0;
+	}
+	ptState->ulRxErrorFirstOffset = 0xffffffffU;
+	ptState->iRxErrorStop = 0;
+	for(uiCnt=0; uiCnt<UART_SEQ_REGISTER_Count; ++uiCnt)
+	{
+		ptState->aulRegister[uiCnt] = 0;
+	}
+	ptState->ulTxHistory = 0;
+	if( ptState->ulVerbose!=0U )
+	{
+		uprintf("Running command [0x%08x, 0x%08x[ with a receive buffer of %d bytes [0x%08x, 0x%08x[.\n",
+		        (unsigned long)ptState->pucCmdCnt,
+		        (unsigned long)ptState->pucCmdEnd,
+		        ptParameter->sizReceivedDataMax,
+		        (unsigned long)ptState->pucRecCnt,
+		        (unsigned long)ptState->pucRecEnd
+		);
+	}
+
+	trace_event(UART_TRACE_EVENT_SequenceStart, ptState->ulUartIndex, 0, ptParameter->sizCommand);
+
+	/* Cut the telemetry records from the end of the receive buffer. All
+	 * commands see the smaller buffer.
+	 */
+	iResult = 0;
+	ulTelemetrySize = ptState->ulTelemetryMax * sizeof(UART_SEQ_TELEMETRY_RECORD_T);
+	if( ptState->ulTelemetryMax>(ptParameter->sizReceivedDataMax / sizeof(UART_SEQ_TELEMETRY_RECORD_T)) )
+	{
+		uprintf("The receive buffer has no space for %d telemetry records.\n", ptState->ulTelemetryMax);
+		iResult = -1;
+	}
+	else
+	{
+		ptState->pucRecEnd -= ulTelemetrySize;
+		ptState->pucTelemetry = ptState->pucRecEnd;
+
+		iResult = sequenceValidate(ptState);
+	}
+
+	return iResult;
+}
+
+
+
+/* Start the trace and the telemetry of a command. The opcode is already
+ * consumed.
+ */
+static void sequenceCommandStart(CMD_STATE_T *ptState, unsigned char ucCommand)
+{
+	trace_event(UART_TRACE_EVENT_CommandStart, ptState->ulUartIndex, ucCommand, (unsigned long)(ptState->pucCmdCnt - 1U - ptState->pucCmdStart));
+
+	ptState->ulPolls = 0;
+	ptState->ulBytes = 0;
+	ptState->ucCommand = ucCommand;
+	if( ptState->ulTelemetryMax!=0 )
+	{
+		ptState->ulTelemetryStart = ticks_get();
+	}
+}
+
+
+
+/* Write the trace and the telemetry record of a finished command. */
+static void sequenceCommandEnd(CMD_STATE_T *ptState, int iResult)
+{
+	UART_SEQ_TELEMETRY_RECORD_T tRecord;
+
+
+	trace_event(UART_TRACE_EVENT_CommandEnd, ptState->ulUartIndex, ptState->ucCommand | ((iResult==0) ? 0U : 0x100U), ptState->ulBytes);
+
+	if( ptState->ulTelemetryMax!=0 )
+	{
+		if( ptState->ulTelemetryRecords<ptState->ulTelemetryMax )
+		{
+			tRecord.ucCommand = ptState->ucCommand;
+			tRecord.ucStatus = (iResult==0) ? 0U : 1U;
+			tRecord.usReserved = 0;
+			tRecord.ulBytes = ptState->ulBytes;
+			tRecord.ulTicks = ticks_get() - ptState->ulTelemetryStart;
+			tRecord.ulPolls = ptState->ulPolls;
+			memcpy(ptState->pucTelemetry + ptState->ulTelemetryRecords * sizeof(UART_SEQ_TELEMETRY_RECORD_T), &tRecord, sizeof(UART_SEQ_TELEMETRY_RECORD_T));
+		}
+		++ptState->ulTelemetryRecords;
+	}
+}
+
+
+
+/* Write the results of a sequence to the parameter. */
+static int sequenceStateFinish(CMD_STATE_T *ptState, int iResult, UART_PARAMETER_RUN_SEQUENCE_T *ptParameter)
+{
+	unsigned int uiDataSize;
+	unsigned int uiCnt;
+	const UART_HANDLE_T *ptHandle;
+
+
+	if( iResult==0 && ptState->uiRepeatDepth!=0 )
+	{
+		uprintf("The sequence ends in a repeat block. EndRepeat is missing.\n");
+		iResult = -1;
+	}
+
+	/* The result of the compare and the telemetry are also valid for a
+	 * failed sequence.
+	 */
+	ptParameter->ulExpectMismatches = ptState->ulExpectMismatches;
+	ptParameter->ulExpectFirstMismatch = ptState->ulExpectFirstMismatch;
+	ptParameter->ulTelemetryRecords = ptState->ulTelemetryRecords;
+	for(uiCnt=0; uiCnt<UART_RX_ERROR_COUNT; ++uiCnt)
+	{
+		ptParameter->aulRxErrors[uiCnt] = ptState->aulRxErrors[uiCnt];
+	}
+	ptParameter->ulRxErrorFirstOffset = ptState->ulRxErrorFirstOffset;
+
+	/* Return the baud rate after the last BaudRate command. */
+	ptHandle = (const UART_HANDLE_T*)(ptParameter->ptHandle);
+	ptParameter->ulAchievedBaudRate = ptHandle->ulAchievedBaudRate;
+	ptParameter->lBaudRateErrorPpm = ptHandle->lBaudRateErrorPpm;
+
+	if( iResult==0 )
+	{
+		/* Set the size of the result data. */
+		uiDataSize = (unsigned int)(ptState->pucRecCnt-ptParameter->pucReceivedData);
+		if( uiDataSize<=ptParameter->sizReceivedDataMax )
+		{
+			ptParameter->sizReceivedData = uiDataSize;
+		}
+		else
+		{
+			iResult = -1;
+		}
+	}
+
+	trace_event(UART_TRACE_EVENT_SequenceEnd, ptState->ulUartIndex, (iResult==0) ? 0U : 1U, (unsigned long)(ptState->pucRecCnt - ptState->pucRecStart));
+
+	return iResult;
+}
+
+
+
+static int processCommandSequence(unsigned long ulVerbose, UART_PARAMETER_RUN_SEQUENCE_T *ptParameter)
+{
+	int iResult;
+	CMD_STATE_T tState;
+	unsigned char ucData;
+	UART_SEQ_COMMAND_T tCmd;
+	UART_HANDLE_T *ptHandle;
+
+
+	/* Get the handle. */
+	ptHandle = (UART_HANDLE_T*)(ptParameter->ptHandle);
+
+	/* Loop over all commands. An empty command is OK. */
+	iResult = sequenceStateInit(&tState, ulVerbose, ptParameter);
+	while( iResult==0 && tState.pucCmdCnt<tState.pucCmdEnd )
+	{
+		/* Get the next command. */
+		iResult = -1;
+		ucData = *(tState.pucCmdCnt++);
+		tCmd = (UART_SEQ_COMMAND_T)ucData;
+		switch( tCmd )
+		{
+		case UART_SEQ_COMMAND_Clean:
+		case UART_SEQ_COMMAND_Send:
+		case UART_SEQ_COMMAND_Receive:
+		case UART_SEQ_COMMAND_BaudRate:
+		case UART_SEQ_COMMAND_Delay:
+		case UART_SEQ_COMMAND_Transceive:
+		case UART_SEQ_COMMAND_Expect:
+		case UART_SEQ_COMMAND_ReceiveUntil:
+		case UART_SEQ_COMMAND_ReceiveIdle:
+		case UART_SEQ_COMMAND_ReceiveUs:
+		case UART_SEQ_COMMAND_DelayUs:
+		case UART_SEQ_COMMAND_Repeat:
+		case UART_SEQ_COMMAND_EndRepeat:
+		case UART_SEQ_COMMAND_Bert:
+		case UART_SEQ_COMMAND_ReceiveTimestamps:
+		case UART_SEQ_COMMAND_BaudSweep:
+		case UART_SEQ_COMMAND_AutoBaud:
+		case UART_SEQ_COMMAND_Benchmark:
+		case UART_SEQ_COMMAND_JumpIf:
+		case UART_SEQ_COMMAND_RegisterLoad:
+		case UART_SEQ_COMMAND_RegisterOp:
+		case UART_SEQ_COMMAND_SendRegisters:
+		case UART_SEQ_COMMAND_CrcAppend:
+		case UART_SEQ_COMMAND_CrcVerify:
+		case UART_SEQ_COMMAND_SendPattern:
+		case UART_SEQ_COMMAND_SendLong:
+		case UART_SEQ_COMMAND_ReceiveLong:
+			iResult = 0;
+			break;
+		}
+		if( iResult!=0 )
+		{
+			uprintf("Invalid command: 0x%02x\n", ucData);
+			break;
+		}
+		else
+		{
+			sequenceCommandStart(&tState, ucData);
+			switch( tCmd )
+			{
+			case UART_SEQ_COMMAND_Clean:
+				iResult = command_clean(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_Send:
+				iResult = command_send(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_Receive:
+				iResult = command_receive(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_BaudRate:
+				iResult = command_baudrate(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_Delay:
+				iResult = command_delay(&tState);
+				break;
+
+			case UART_SEQ_COMMAND_Transceive:
+				iResult = command_transceive(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_Expect:
+				iResult = command_expect(&tState);
+				break;
+
+			case UART_SEQ_COMMAND_ReceiveUntil:
+				iResult = command_receive_until(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_ReceiveIdle:
+				iResult = command_receive_idle(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_ReceiveUs:
+				iResult = command_receive_us(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_DelayUs:
+				iResult = command_delay_us(&tState);
+				break;
+
+			case UART_SEQ_COMMAND_Repeat:
+				iResult = command_repeat(&tState);
+				break;
+
+			case UART_SEQ_COMMAND_EndRepeat:
+				iResult = command_end_repeat(&tState);
+				break;
+
+			case UART_SEQ_COMMAND_Bert:
+				iResult = command_bert(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_ReceiveTimestamps:
+				iResult = command_receive_timestamps(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_BaudSweep:
+				iResult = command_baud_sweep(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_AutoBaud:
+				iResult = command_autobaud(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_Benchmark:
+				iResult = command_benchmark(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_JumpIf:
+				iResult = command_jump_if(&tState);
+				break;
+
+			case UART_SEQ_COMMAND_RegisterLoad:
+				iResult = command_register_load(&tState);
+				break;
+
+			case UART_SEQ_COMMAND_RegisterOp:
+				iResult = command_register_op(&tState);
+				break;
+
+			case UART_SEQ_COMMAND_SendRegisters:
+				iResult = command_send_registers(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_CrcAppend:
+				iResult = command_crc_append(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_CrcVerify:
+				iResult = command_crc_verify(&tState);
+				break;
+
+			case UART_SEQ_COMMAND_SendPattern:
+				iResult = command_send_pattern(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_SendLong:
+				iResult = command_send_long(&tState, ptHandle);
+				break;
+
+			case UART_SEQ_COMMAND_ReceiveLong:
+				iResult = command_receive_long(&tState, ptHandle);
+				break;
+			}
+			sequenceCommandEnd(&tState, iResult);
+			if( iResult!=0 )
+			{
+				if( tState.ulVerbose!=0U )
+				{
+					uprintf("The command failed. Stopping execution of the sequence.\n");
+				}
+				break;
+			}
+		}
+	}
+
+	iResult = sequenceStateFinish(&tState, iResult, ptParameter);
+
+	return iResult;
+}
+
+
+
+/* The parallel mode runs one sequence on each of several UARTs. A simple
+ * round robin scheduler gives each sequence one step in turn. A step never
+ * waits for the UART. It moves one FIFO burst, checks a timer or starts the
+ * next command. The other UARTs keep running while one waits for data.
+ *
+ * Only the commands which move data or wait for a time are split into
+ * steps. The commands which need no UART or finish at once are executed
+ * with the functions of the normal mode. All other commands are not
+ * supported. The sequences are checked for them before the first one starts.
+ */
+#define SEQ_TASKS_MAX (sizeof(atUartInstances)/sizeof(atUartInstances[0]))
+
+typedef enum SEQ_TASK_STATE_ENUM
+{
+	SEQ_TASK_STATE_Next = 0,
+	SEQ_TASK_STATE_Transfer = 1,
+	SEQ_TASK_STATE_Delay = 2,
+	SEQ_TASK_STATE_ReceiveUntil = 3,
+	SEQ_TASK_STATE_ReceiveIdle = 4,
+	SEQ_TASK_STATE_Done = 5,
+	SEQ_TASK_STATE_Error = 6
+} SEQ_TASK_STATE_T;
+
+
+typedef struct SEQ_TASK_STRUCT
+{
+	SEQ_TASK_STATE_T tState;
+	CMD_STATE_T tCmdState;
+	UART_HANDLE_T *ptHandle;
+	UART_PARAMETER_RUN_SEQUENCE_T *ptParameter;
+
+	/* The size of the running command including the send data. */
+	unsigned long ulCmdSize;
+
+	/* The data of a running transfer. */
+	const unsigned char *pucTxCnt;
+	const unsigned char *pucTxEnd;
+	unsigned char *pucRxCnt;
+	unsigned char *pucRxEnd;
+	/* The receive status of a receive until command is checked up to here. */
+	unsigned char *pucRxChecked;
+
+	/* The timers count in ticks for the microsecond commands and in
+	 * milliseconds for all others. A timeout of 0 is disabled. The char
+	 * timer of a receive idle command measures the idle gap and always
+	 * counts in ticks.
+	 */
+	int iTicks;
+	unsigned long ulTimeoutTotal;
+	unsigned long ulTimeoutChar;
+	unsigned long ulTimerTotal;
+	unsigned long ulTimerChar;
+
+	/* The automaton of a running receive until command. */
+	PATTERN_MATCH_T tMatch;
+} SEQ_TASK_T;
+
+static SEQ_TASK_T atSeqTasks[SEQ_TASKS_MAX];
+
+
+
+static unsigned long seq_task_timer_get(const SEQ_TASK_T *ptTask)
+{
+	unsigned long ulTimer;
+
+
+	if( ptTask->iTicks!=0 )
+	{
+		ulTimer = ticks_get();
+	}
+	else
+	{
+		ulTimer = systime_get_ms();
+	}
+
+	return ulTimer;
+}
+
+
+
+static int seq_task_timer_elapsed(const SEQ_TASK_T *ptTask, unsigned long ulStart, unsigned long ulDuration)
+{
+	int iElapsed;
+
+
+	if( ptTask->iTicks!=0 )
+	{
+		iElapsed = ticks_elapsed(ulStart, ulDuration);
+	}
+	else
+	{
+		iElapsed = systime_elapsed(ulStart, ulDuration);
+	}
+
+	return iElapsed;
+}
+
+
+
+/* Set up a transfer. The send data follows the command, the receive data
+ * is appended to the receive buffer.
+ */
+static int seq_task_start_transfer(SEQ_TASK_T *ptTask, unsigned long ulCmdSize, unsigned long ulSendSize, unsigned long ulReceiveSize)
+{
+	int iResult;
+	CMD_STATE_T *ptState;
+
+
+	/* The caller checked the header. Compare the sizes, as a 32 bit size
+	 * can move the pointers around.
+	 */
+	ptState = &(ptTask->tCmdState);
+	if( ulSendSize>((unsigned long)(ptState->pucCmdEnd - ptState->pucCmdCnt) - ulCmdSize) )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the complete command left.\n");
+		}
+		iResult = -1;
+	}
+	else if( ulReceiveSize>(unsigned long)(ptState->pucRecEnd - ptState->pucRecCnt) )
+	{
+		if( ptState->ulVerbose!=0U )
+		{
+			uprintf("Not enough data for the receive data left.\n");
+		}
+		iResult = -1;
+	}
+	else
+	{
+		ptTask->ulCmdSize = ulCmdSize + ulSendSize;
+		ptTask->pucTxCnt = ptState->pucCmdCnt + ulCmdSize;
+		ptTask->pucTxEnd = ptTask->pucTxCnt + ulSendSize;
+		ptTask->pucRxCnt = ptState->pucRecCnt;
+		ptTask->pucRxEnd = ptState->pucRecCnt + ulReceiveSize;
+		ptTask->ulTimerTotal = seq_task_timer_get(ptTask);
+		ptTask->ulTimerChar = ptTask->ulTimerTotal;
+		ptTask->tState = SEQ_TASK_STATE_Transfer;
+		iResult = 0;
+	}
+
+	return iResult;
+}
+
+
+
+/* Get the next command of a sequence. Transfers and delays are only set up
+ * here, all other commands are executed completely.
+ */
+static int seq_task_step_next(SEQ_TASK_T *ptTask)
+{
+	int iResult;
+	CMD_STATE_T *ptState;
+	unsigned char ucData;
+	UART_SEQ_COMMAND_T tCmd;
+	const UART_SEQ_COMMAND_WRITE_T *ptCmdWrite;
+	const UART_SEQ_COMMAND_READ_T *ptCmdRead;
+	const UART_SEQ_COMMAND_READ_US_T *ptCmdReadUs;
+	const UART_SEQ_COMMAND_WRITE_LONG_T *ptCmdWriteLong;
+	const UART_SEQ_COMMAND_READ_LONG_T *ptCmdReadLong;
+	const UART_SEQ_COMMAND_TRANSCEIVE_T *ptCmdTransceive;
+	const UART_SEQ_COMMAND_RECEIVE_UNTIL_T *ptCmdReceiveUntil;
+	const UART_SEQ_COMMAND_RECEIVE_IDLE_T *ptCmdReceiveIdle;
+	const UART_SEQ_COMMAND_DELAY_T *ptCmdDelay;
+	const UART_SEQ_COMMAND_DELAY_US_T *ptCmdDelayUs;
+	const unsigned char *pucCmdNext;
+
+
+	ptState = &(ptTask->tCmdState);
+	if( ptState->pucCmdCnt>=ptState->pucCmdEnd )
+	{
+		ptTask->tState = SEQ_TASK_STATE_Done;
+		iResult = 0;
+	}
+	else
+	{
+		iResult = -1;
+		ucData = *(ptState->pucCmdCnt++);
+		tCmd = (UART_SEQ_COMMAND_T)ucData;
+		sequenceCommandStart(ptState, ucData);
+		ptTask->iTicks = 0;
+		ptTask->ulTimeoutTotal = 0;
+		ptTask->ulTimeoutChar = 0;
+		switch( tCmd )
+		{
+		case UART_SEQ_COMMAND_Clean:
+			iResult = command_clean(ptState, ptTask->ptHandle);
+			break;
+
+		case UART_SEQ_COMMAND_Send:
+			if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_WRITE_T))<=ptState->pucCmdEnd )
+			{
+				ptCmdWrite = (const UART_SEQ_COMMAND_WRITE_T*)(ptState->pucCmdCnt);
+				/* A send has no timeouts, but CTS can stop it. */
+				ptTask->ulTimeoutChar = ptTask->ptHandle->ulTimeoutCtsMs;
+				iResult = seq_task_start_transfer(ptTask, sizeof(UART_SEQ_COMMAND_WRITE_T), ptCmdWrite->s.usDataSize, 0);
+			}
+			break;
+
+		case UART_SEQ_COMMAND_Receive:
+			if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_READ_T))<=ptState->pucCmdEnd )
+			{
+				ptCmdRead = (const UART_SEQ_COMMAND_READ_T*)(ptState->pucCmdCnt);
+				ptTask->ulTimeoutTotal = ptCmdRead->s.usTimeoutTotalMs;
+				ptTask->ulTimeoutChar = ptCmdRead->s.usTimeoutCharMs;
+				iResult = seq_task_start_transfer(ptTask, sizeof(UART_SEQ_COMMAND_READ_T), 0, ptCmdRead->s.usDataSize);
+			}
+			break;
+
+		case UART_SEQ_COMMAND_SendLong:
+			if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_WRITE_LONG_T))<=ptState->pucCmdEnd )
+			{
+				ptCmdWriteLong = (const UART_SEQ_COMMAND_WRITE_LONG_T*)(ptState->pucCmdCnt);
+				ptTask->ulTimeoutChar = ptTask->ptHandle->ulTimeoutCtsMs;
+				iResult = seq_task_start_transfer(ptTask, sizeof(UART_SEQ_COMMAND_WRITE_LONG_T), ptCmdWriteLong->s.ulDataSize, 0);
+			}
+			break;
+
+		case UART_SEQ_COMMAND_ReceiveLong:
+			if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_READ_LONG_T))<=ptState->pucCmdEnd )
+			{
+				ptCmdReadLong = (const UART_SEQ_COMMAND_READ_LONG_T*)(ptState->pucCmdCnt);
+				ptTask->ulTimeoutTotal = ptCmdReadLong->s.ulTimeoutTotalMs;
+				ptTask->ulTimeoutChar = ptCmdReadLong->s.ulTimeoutCharMs;
+				iResult = seq_task_start_transfer(ptTask, sizeof(UART_SEQ_COMMAND_READ_LONG_T), 0, ptCmdReadLong->s.ulDataSize);
+			}
+			break;
+
+		case UART_SEQ_COMMAND_ReceiveUs:
+			if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_READ_US_T))<=ptState->pucCmdEnd )
+			{
+				ptCmdReadUs = (const UART_SEQ_COMMAND_READ_US_T*)(ptState->pucCmdCnt);
+				if( ptCmdReadUs->s.ulTimeoutTotalUs>TICKS_MAX_US || ptCmdReadUs->s.ulTimeoutCharUs>TICKS_MAX_US )
+				{
+					uprintf("The timeouts must not exceed %dus.\n", TICKS_MAX_US);
+				}
+				else
+				{
+					ptTask->iTicks = 1;
+					ptTask->ulTimeoutTotal = ptCmdReadUs->s.ulTimeoutTotalUs * TICKS_PER_US;
+					ptTask->ulTimeoutChar = ptCmdReadUs->s.ulTimeoutCharUs * TICKS_PER_US;
+					iResult = seq_task_start_transfer(ptTask, sizeof(UART_SEQ_COMMAND_READ_US_T), 0, ptCmdReadUs->s.usDataSize);
+				}
+			}
+			break;
+
+		case UART_SEQ_COMMAND_Transceive:
+			if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_TRANSCEIVE_T))<=ptState->pucCmdEnd )
+			{
+				ptCmdTransceive = (const UART_SEQ_COMMAND_TRANSCEIVE_T*)(ptState->pucCmdCnt);
+				ptTask->ulTimeoutTotal = ptCmdTransceive->s.usTimeoutTotalMs;
+				ptTask->ulTimeoutChar = ptCmdTransceive->s.usTimeoutCharMs;
+				iResult = seq_task_start_transfer(ptTask, sizeof(UART_SEQ_COMMAND_TRANSCEIVE_T), ptCmdTransceive->s.usSendSize, ptCmdTransceive->s.usReceiveSize);
+			}
+			break;
+
+		case UART_SEQ_COMMAND_ReceiveUntil:
+			iResult = receive_until_prepare(ptState, &(ptTask->tMatch), &pucCmdNext);
+			if( iResult==0 )
+			{
+				/* The header is written when the command ends. */
+				ptCmdReceiveUntil = (const UART_SEQ_COMMAND_RECEIVE_UNTIL_T*)(ptState->pucCmdCnt);
+				ptTask->ulTimeoutTotal = ptCmdReceiveUntil->s.usTimeoutTotalMs;
+				ptTask->ulTimeoutChar = ptCmdReceiveUntil->s.usTimeoutCharMs;
+				ptTask->ulCmdSize = (unsigned long)(pucCmdNext - ptState->pucCmdCnt);
+				ptTask->pucRxCnt = ptState->pucRecCnt + UART_SEQ_RECEIVE_UNTIL_HeaderSize;
+				ptTask->pucRxEnd = ptTask->pucRxCnt + ptCmdReceiveUntil->s.usDataSize;
+				ptTask->pucRxChecked = ptTask->pucRxCnt;
+				ptTask->ulTimerTotal = seq_task_timer_get(ptTask);
+				ptTask->ulTimerChar = ptTask->ulTimerTotal;
+				ptTask->tState = SEQ_TASK_STATE_ReceiveUntil;
+			}
+			break;
+
+		case UART_SEQ_COMMAND_ReceiveIdle:
+			if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_RECEIVE_IDLE_T))<=ptState->pucCmdEnd )
+			{
+				/* The char timer measures the idle gap in ticks. */
+				ptCmdReceiveIdle = (const UART_SEQ_COMMAND_RECEIVE_IDLE_T*)(ptState->pucCmdCnt);
+				if( receive_idle_gap_check(ptCmdReceiveIdle->s.usIdleGapMs)==0 )
+				{
+					ptTask->ulTimeoutTotal = ptCmdReceiveIdle->s.usTimeoutTotalMs;
+					ptTask->ulTimeoutChar = ptCmdReceiveIdle->s.usIdleGapMs * 1000U * TICKS_PER_US;
+					iResult = seq_task_start_transfer(ptTask, sizeof(UART_SEQ_COMMAND_RECEIVE_IDLE_T), 0, ptCmdReceiveIdle->s.usDataSize);
+					if( iResult==0 )
+					{
+						ptTask->tState = SEQ_TASK_STATE_ReceiveIdle;
+					}
+				}
+			}
+			break;
+
+		case UART_SEQ_COMMAND_Delay:
+			if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_DELAY_T))<=ptState->pucCmdEnd )
+			{
+				ptCmdDelay = (const UART_SEQ_COMMAND_DELAY_T*)(ptState->pucCmdCnt);
+				ptTask->ulCmdSize = sizeof(UART_SEQ_COMMAND_DELAY_T);
+				ptTask->ulTimeoutTotal = ptCmdDelay->s.ulDelayInMs;
+				ptTask->ulTimerTotal = seq_task_timer_get(ptTask);
+				ptTask->tState = SEQ_TASK_STATE_Delay;
+				iResult = 0;
+			}
+			break;
+
+		case UART_SEQ_COMMAND_DelayUs:
+			if( (ptState->pucCmdCnt + sizeof(UART_SEQ_COMMAND_DELAY_US_T))<=ptState->pucCmdEnd )
+			{
+				ptCmdDelayUs = (const UART_SEQ_COMMAND_DELAY_US_T*)(ptState->pucCmdCnt);
+				if( ptCmdDelayUs->s.ulDelayInUs>TICKS_MAX_US )
+				{
+					uprintf("The delay must not exceed %dus.\n", TICKS_MAX_US);
+				}
+				else
+				{
+					ptTask->iTicks = 1;
+					ptTask->ulCmdSize = sizeof(UART_SEQ_COMMAND_DELAY_US_T);
+					ptTask->ulTimeoutTotal = ptCmdDelayUs->s.ulDelayInUs * TICKS_PER_US;
+					ptTask->ulTimerTotal = seq_task_timer_get(ptTask);
+					ptTask->tState = SEQ_TASK_STATE_Delay;
+					iResult = 0;
+				}
+			}
+			break;
+
+		case UART_SEQ_COMMAND_BaudRate:
+			iResult = command_baudrate(ptState, ptTask->ptHandle);
+			break;
+
+		case UART_SEQ_COMMAND_Expect:
+			iResult = command_expect(ptState);
+			break;
+
+		case UART_SEQ_COMMAND_Repeat:
+			iResult = command_repeat(ptState);
+			break;
+
+		case UART_SEQ_COMMAND_EndRepeat:
+			iResult = command_end_repeat(ptState);
+			break;
+
+		case UART_SEQ_COMMAND_JumpIf:
+			iResult = command_jump_if(ptState);
+			break;
+
+		case UART_SEQ_COMMAND_RegisterLoad:
+			iResult = command_register_load(ptState);
+			break;
+
+		case UART_SEQ_COMMAND_RegisterOp:
+			iResult = command_register_op(ptState);
+			break;
+
+		case UART_SEQ_COMMAND_CrcVerify:
+			iResult = command_crc_verify(ptState);
+			break;
 
-	{
-		.ptArea = (NX56_UART_AREA_T * const)Addr_NX56_uart1,
-		.atMMIO =
-		{
-			NX56_MMIO_CFG_uart1_rxd,
-			NX56_MMIO_CFG_uart1_txd,
-			NX56_MMIO_CFG_uart1_rtsn,
-			NX56_MMIO_CFG_uart1_ctsn
-		}
-	},
+		case UART_SEQ_COMMAND_Bert:
+		case UART_SEQ_COMMAND_ReceiveTimestamps:
+		case UART_SEQ_COMMAND_BaudSweep:
+		case UART_SEQ_COMMAND_AutoBaud:
+		case UART_SEQ_COMMAND_Benchmark:
+		case UART_SEQ_COMMAND_SendRegisters:
+		case UART_SEQ_COMMAND_CrcAppend:
+		case UART_SEQ_COMMAND_SendPattern:
+			uprintf("The command 0x%02x is not supported in the parallel mode.\n", ucData);
+			break;
 
-	{
-		.ptArea = (NX56_UART_AREA_T * const)Addr_NX56_uart2,
-		.atMMIO =
-		{
-			NX56_MMIO_CFG_uart2_rxd,
-			NX56_MMIO_CFG_uart2_txd,
-			NX56_MMIO_CFG_uart2_rtsn,
-			NX56_MMIO_CFG_uart2_ctsn
+		default:
+			uprintf("Invalid command: 0x%02x\n", ucData);
+			break;
 		}
 	}
 
-#elif ASIC_TYP==ASIC_TYP_NETX6
-	{
-		.ptArea = (NX6_UART_AREA_T * const)Addr_NX6_uart0,
-		.atMMIO =
-		{
-			NX6_MMIO_CFG_uart0_rxd,
-			NX6_MMIO_CFG_uart0_txd,
-			NX6_MMIO_CFG_uart0_rtsn,
-			NX6_MMIO_CFG_uart0_ctsn
-		}
-	},
+	return iResult;
+}
 
-	{
-		.ptArea = (NX6_UART_AREA_T * const)Addr_NX6_uart1,
-		.atMMIO =
-		{
-			NX6_MMIO_CFG_uart1_rxd,
-			NX6_MMIO_CFG_uart1_txd,
-			NX6_MMIO_CFG_uart1_rtsn,
-			NX6_MMIO_CFG_uart1_ctsn
-		}
-	},
 
-	{
-		.ptArea = (NX6_UART_AREA_T * const)Addr_NX6_uart2,
-		.atMMIO =
-		{
-			NX6_MMIO_CFG_uart2_rxd,
-			NX6_MMIO_CFG_uart2_txd,
-			NX6_MMIO_CFG_uart2_rtsn,
-			NX6_MMIO_CFG_uart2_ctsn
-		}
-	}
 
-#elif ASIC_TYP==ASIC_TYP_NETX500
-	{
-		.ptArea = (NX500_UART_AREA_T * const)Addr_NX500_uart0
-	},
+/* Check the timeouts of a running command. */
+static int seq_task_check_timeouts(SEQ_TASK_T *ptTask)
+{
+	int iResult;
 
-	{
-		.ptArea = (NX500_UART_AREA_T * const)Addr_NX500_uart1
-	},
 
+	iResult = 0;
+	if( ptTask->ulTimeoutTotal!=0 && seq_task_timer_elapsed(ptTask, ptTask->ulTimerTotal, ptTask->ulTimeoutTotal)!=0 )
 	{
-		.ptArea = (NX500_UART_AREA_T * const)Addr_NX500_uart2
+		uprintf("UART%d: The total timeout elapsed.\n", ptTask->ptHandle->ulUartIndex);
+		trace_event(UART_TRACE_EVENT_TimeoutTotal, ptTask->tCmdState.ulUartIndex, ptTask->tCmdState.ucCommand, ptTask->tCmdState.ulBytes);
+		iResult = -1;
+	}
+	else if( ptTask->ulTimeoutChar!=0 && seq_task_timer_elapsed(ptTask, ptTask->ulTimerChar, ptTask->ulTimeoutChar)!=0 )
+	{
+		uprintf("UART%d: The char timeout elapsed.\n", ptTask->ptHandle->ulUartIndex);
+		trace_event(UART_TRACE_EVENT_TimeoutChar, ptTask->tCmdState.ulUartIndex, ptTask->tCmdState.ucCommand, ptTask->tCmdState.ulBytes);
+		iResult = -1;
 	}
 
-#elif ASIC_TYP==ASIC_TYP_NETX4000_RELAXED || ASIC_TYP==ASIC_TYP_NETX4000
+	return iResult;
+}
+
+
+
+/* Move at most one FIFO burst. The RX FIFO has priority. The timers are
+ * only checked if there was nothing to do.
+ */
+static int seq_task_step_transfer(SEQ_TASK_T *ptTask)
+{
+	int iResult;
+	unsigned long ulValue;
+	HOSTADEF(UART) *ptUartArea;
+	CMD_STATE_T *ptState;
+
+
+	iResult = 0;
+	ptUartArea = ptTask->ptHandle->ptUart;
+	ulValue = uart_get_flags(&(ptTask->tCmdState), ptUartArea);
+	if( (ulValue & HOSTMSK(uartfr_RXFE))==0 && ptTask->pucRxCnt<ptTask->pucRxEnd )
 	{
-		.ptArea = (HOSTADEF(UART) * const)HOSTADDR(uart0),
-		.atMMIO =
+		ptTask->pucRxCnt = uart_read_fifo(&(ptTask->tCmdState), ptUartArea, ulValue, ptTask->pucRxCnt, ptTask->pucRxEnd);
+		if( ptTask->tCmdState.iRxErrorStop!=0 )
 		{
-			HOSTMMIO(UART0_RXD),
-			HOSTMMIO(UART0_TXD),
-			HOSTMMIO(UART0_RTSN),
-			HOSTMMIO(UART0_CTSN)
+			iResult = -1;
 		}
-	},
-
-	{
-		.ptArea = (HOSTADEF(UART) * const)HOSTADDR(uart1),
-		.atMMIO =
+		else if( ptTask->ulTimeoutChar!=0 )
 		{
-			HOSTMMIO(UART1_RXD),
-			HOSTMMIO(UART1_TXD),
-			HOSTMMIO(UART1_RTSN),
-			HOSTMMIO(UART1_CTSN)
+			ptTask->ulTimerChar = seq_task_timer_get(ptTask);
 		}
-	},
-
+	}
+	else if( (ulValue & HOSTMSK(uartfr_TXFE))!=0 && ptTask->pucTxCnt<ptTask->pucTxEnd )
 	{
-		.ptArea = (HOSTADEF(UART) * const)HOSTADDR(uart2),
-		.atMMIO =
+		ptTask->pucTxCnt = uart_write_fifo(&(ptTask->tCmdState), ptUartArea, ptTask->pucTxCnt, ptTask->pucTxEnd);
+		if( ptTask->ulTimeoutChar!=0 )
 		{
-			HOSTMMIO(UART2_RXD),
-			HOSTMMIO(UART2_TXD),
-			HOSTMMIO(UART2_RTSN),
-			HOSTMMIO(UART2_CTSN)
+			ptTask->ulTimerChar = seq_task_timer_get(ptTask);
 		}
 	}
-
-#elif ASIC_TYP==ASIC_TYP_NETX90_MPW
+	else if( ptTask->pucTxCnt>=ptTask->pucTxEnd && ptTask->pucRxCnt>=ptTask->pucRxEnd && (ulValue & HOSTMSK(uartfr_BUSY))==0 )
 	{
-		.ptArea = (NX90MPW_UART_AREA_T * const)Addr_NX90MPW_uart_com
+		/* All data is transferred and the TX FIFO is empty. */
+		ptState = &(ptTask->tCmdState);
+		ptState->pucCmdCnt += ptTask->ulCmdSize;
+		ptState->pucRecCnt = ptTask->pucRxCnt;
+		ptTask->tState = SEQ_TASK_STATE_Next;
 	}
-
-#elif ASIC_TYP==ASIC_TYP_NETX90
+	else
 	{
-		.ptArea = (NX90_UART_AREA_T * const)Addr_NX90_uart
+		iResult = seq_task_check_timeouts(ptTask);
 	}
 
-#elif ASIC_TYP==ASIC_TYP_NETX90_MPW_APP || ASIC_TYP==ASIC_TYP_NETX90_APP
-	{
-		.ptArea = (NX90_UART_AREA_T * const)Addr_NX90_uart_app
-	},
+	return iResult;
+}
 
-	{
-		.ptArea = (NX90_UART_AREA_T * const)Addr_NX90_uart_xpic_app
-	}
 
-#else
-#       error "Unsupported ASIC_TYPE!"
 
-#endif
-};
+/* Check the receive status of the bytes which were received since the
+ * last check.
+ */
+static int seq_task_rx_check(SEQ_TASK_T *ptTask)
+{
+	int iResult;
 
 
+	iResult = 0;
+	if( ptTask->pucRxChecked!=ptTask->pucRxCnt )
+	{
+		uart_rx_check(&(ptTask->tCmdState), ptTask->ptHandle->ptUart, ptTask->pucRxChecked);
+		ptTask->pucRxChecked = ptTask->pucRxCnt;
+		if( ptTask->tCmdState.iRxErrorStop!=0 )
+		{
+			iResult = -1;
+		}
+	}
 
-#if ASIC_TYP==ASIC_TYP_NETX10 || ASIC_TYP==ASIC_TYP_NETX50 || ASIC_TYP==ASIC_TYP_NETX56 || ASIC_TYP==ASIC_TYP_NETX6 || ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
-static const char *apcPinOrder[4] =
-{
-	"RX",
-	"TX",
-	"RTS",
-	"CTS"
-};
-#endif
+	return iResult;
+}
 
 
 
-static TEST_RESULT_T processCommandOpen(unsigned long ulVerbose, UART_PARAMETER_OPEN_T *ptParameter)
+/* Receive one byte of a receive until command and feed it to the
+ * automaton. The command ends with a match or a full buffer. The receive
+ * status is checked when the FIFO is empty and at the end.
+ */
+static int seq_task_step_receive_until(SEQ_TASK_T *ptTask)
 {
-	TEST_RESULT_T tResult;
 	int iResult;
-	unsigned long ulCore;
-	UART_HANDLE_T *ptHandle;
-	const UART_INSTANCE_T *ptUartInstance;
-	HOSTADEF(UART) *ptUartArea;
 	unsigned long ulValue;
-	unsigned long ulBaudRate;
-	unsigned long ulCurrentDeviceSpecificSpeedValue;
-#if ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
-	unsigned long ulPortControl;
-#endif
-#if ASIC_TYP==ASIC_TYP_NETX10 || ASIC_TYP==ASIC_TYP_NETX50 || ASIC_TYP==ASIC_TYP_NETX56 || ASIC_TYP==ASIC_TYP_NETX6 || ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
-	unsigned int uiCnt;
-	const char *pcName;
-	HOSTDEF(ptAsicCtrlArea);
-	HOSTDEF(ptMmioCtrlArea);
-#elif ASIC_TYP==ASIC_TYP_NETX500
-	HOSTDEF(ptGpioArea);
-	unsigned int uiIdx;
-#endif
+	unsigned int uiMatch;
+	HOSTADEF(UART) *ptUartArea;
+	CMD_STATE_T *ptState;
 
-	/* Check the parameter. */
-	tResult = TEST_RESULT_ERROR;
-	ulCore = ptParameter->ulUartCore;
 
-	/* Is the core number valid? */
-	if( ulCore>=(sizeof(atUartInstances)/sizeof(atUartInstances[0])) )
+	iResult = 0;
+	ptState = &(ptTask->tCmdState);
+	ptUartArea = ptTask->ptHandle->ptUart;
+	if( ptTask->pucRxCnt>=ptTask->pucRxEnd )
 	{
-		uprintf("The UART core number %d is invalid on the host %s.\n", ulCore, HOSTNAME);
+		iResult = seq_task_rx_check(ptTask);
+		if( iResult==0 )
+		{
+			receive_until_finish(ptState, UART_SEQ_RECEIVE_UNTIL_NoMatch, ptTask->pucRxCnt, ptState->pucCmdCnt + ptTask->ulCmdSize);
+			ptTask->tState = SEQ_TASK_STATE_Next;
+		}
 	}
 	else
 	{
-		ptUartInstance = atUartInstances + ulCore;
-
-		/* Get the UART area. */
-		ptUartArea = ptUartInstance->ptArea;
-
-		/* Disable the UART. */
-		ptUartArea->ulUartcr = 0;
-
-		/* Use baud rate mode 2. */
-		ptUartArea->ulUartcr_2 = HOSTMSK(uartcr_2_Baud_Rate_Mode);
-
-		/* Set the baud rate. */
-		ulBaudRate = ptParameter->ulBaudRate;
-		iResult = getDeviceSpecificBaudRate(ulBaudRate, &ulCurrentDeviceSpecificSpeedValue);
-		if( iResult!=0 )
-		{
-			uprintf("Failed to set the baud rate to %d.\n", ulBaudRate);
-		}
-		else
+		ulValue = uart_get_flags(ptState, ptUartArea);
+		if( (ulValue & HOSTMSK(uartfr_RXFE))==0 )
 		{
-			ptUartArea->ulUartlcr_l = ulCurrentDeviceSpecificSpeedValue & 0xffU;
-			ptUartArea->ulUartlcr_m = ulCurrentDeviceSpecificSpeedValue >> 8;
-
-			/* Set the UART to 8N1, FIFO enabled. */
-			ulValue  = HOSTMSK(uartlcr_h_WLEN);
-			ulValue |= HOSTMSK(uartlcr_h_FEN);
-			ptUartArea->ulUartlcr_h = ulValue;
-
-			/* Disable all drivers. */
-			ptUartArea->ulUartdrvout = 0;
-
-			/* Disable RTS/CTS mode. */
-			ptUartArea->ulUartrts = 0;
-
-			/* Enable the UART. */
-			ptUartArea->ulUartcr = HOSTMSK(uartcr_uartEN);
-
-			if( ulVerbose!=0 )
+			ulValue = uart_read_byte(ptUartArea);
+			*(ptTask->pucRxCnt++) = (unsigned char)ulValue;
+			++ptState->ulBytes;
+			if( ptTask->ulTimeoutChar!=0 )
 			{
-				/* Setup the UART. */
-				uprintf("Setup UART %d with %d baud (native 0x%04x).\n", ulCore, ulBaudRate, ulCurrentDeviceSpecificSpeedValue);
+				ptTask->ulTimerChar = seq_task_timer_get(ptTask);
 			}
-#if ASIC_TYP==ASIC_TYP_NETX10 || ASIC_TYP==ASIC_TYP_NETX50 || ASIC_TYP==ASIC_TYP_NETX56 || ASIC_TYP==ASIC_TYP_NETX6 || ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
-			for(uiCnt=0; uiCnt<4; uiCnt++)
-			{
-				ulValue = ptParameter->aucMMIO[uiCnt];
-#       if ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
-				ulPortControl = ptParameter->ausPortcontrol[uiCnt];
-#       endif
-
-				if( ulVerbose!=0 )
-				{
-					pcName = apcPinOrder[uiCnt];
-
-					if( ulValue!=0xff )
-					{
-#       if ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
-						if( ulPortControl!=PORTCONTROL_SKIP )
-						{
-							uprintf("  %s = MMIO%d with port control 0x%04x\n", pcName, ulValue, ulPortControl);
-						}
-						else
-						{
-							uprintf("  %s = MMIO%d without port control\n", pcName, ulValue);
-						}
-#       else
-						uprintf("  %s = MMIO%d\n", pcName, ulValue);
-#       endif
-					}
-					else
-					{
-						uprintf("  %s without MMIO\n", pcName);
-					}
-				}
 
-				if( ulValue!=0xff )
-				{
-					ptAsicCtrlArea->ulAsic_ctrl_access_key = ptAsicCtrlArea->ulAsic_ctrl_access_key;    /* @suppress("Assignment to itself") */
-					ptMmioCtrlArea->aulMmio_cfg[ulValue] = ptUartInstance->atMMIO[uiCnt];
-				}
-			}
-#       if ASIC_TYP==ASIC_TYP_NETX4000 || ASIC_TYP==ASIC_TYP_NETX4000_RELAXED
-			portcontrol_apply_mmio(ptParameter->aucMMIO, ptParameter->ausPortcontrol, 4);
-#       endif
-#elif ASIC_TYP==ASIC_TYP_NETX500
-			uiIdx = uiUartUnit << 2;
-			ptGpioArea->aulGpio_cfg[uiIdx+0] = 2;
-			ptGpioArea->aulGpio_cfg[uiIdx+1] = 2;
-			ptGpioArea->aulGpio_cfg[uiIdx+2] = 2;
-			ptGpioArea->aulGpio_cfg[uiIdx+3] = 2;
-#endif
+			uiMatch = pattern_match_step(&(ptTask->tMatch), (unsigned char)ulValue);
+			if( uiMatch!=0 )
+			{
+				iResult = seq_task_rx_check(ptTask);
+				if( iResult==0 )
+				{
+					receive_until_finish(ptState, (UART_SEQ_RECEIVE_UNTIL_T)(uiMatch - 1U), ptTask->pucRxCnt, ptState->pucCmdCnt + ptTask->ulCmdSize);
+					ptTask->tState = SEQ_TASK_STATE_Next;
+				}
+			}
+		}
+		else if( ptTask->pucRxChecked!=ptTask->pucRxCnt )
+		{
+			iResult = seq_task_rx_check(ptTask);
+		}
+		else
+		{
+			iResult = seq_task_check_timeouts(ptTask);
+		}
+	}
 
-			/* Enable the drivers. */
-			ulValue = HOSTMSK(uartdrvout_DRVTX);
-			ptUartArea->ulUartdrvout = ulValue;
+	return iResult;
+}
 
-			/* Fill the handle. */
-			ptHandle = (UART_HANDLE_T*)ptParameter->ptHandle;
-			ptHandle->ptUart = ptUartArea;
-			ptHandle->ulUartIndex = ulCore;
-			ptHandle->ulCurrentBaudRate = ulBaudRate;
-			ptHandle->ulCurrentDeviceSpecificSpeedValue = ulCurrentDeviceSpecificSpeedValue;
 
-			tResult = TEST_RESULT_OK;
+
+/* Move one FIFO burst of a receive idle command. The command ends with a
+ * full buffer or after the idle gap, which starts with the first byte. The
+ * idle gap is measured in ticks.
+ */
+static int seq_task_step_receive_idle(SEQ_TASK_T *ptTask)
+{
+	int iResult;
+	unsigned long ulValue;
+	HOSTADEF(UART) *ptUartArea;
+	CMD_STATE_T *ptState;
+
+
+	iResult = 0;
+	ptState = &(ptTask->tCmdState);
+	ptUartArea = ptTask->ptHandle->ptUart;
+	ulValue = uart_get_flags(ptState, ptUartArea);
+	if( (ulValue & HOSTMSK(uartfr_RXFE))==0 && ptTask->pucRxCnt<ptTask->pucRxEnd )
+	{
+		ptTask->pucRxCnt = uart_read_fifo(ptState, ptUartArea, ulValue, ptTask->pucRxCnt, ptTask->pucRxEnd);
+		if( ptState->iRxErrorStop!=0 )
+		{
+			iResult = -1;
 		}
+		else
+		{
+			ptTask->ulTimerChar = ticks_get();
+		}
+	}
+	else if( ptTask->pucRxCnt>=ptTask->pucRxEnd || (ptTask->pucRxCnt!=ptState->pucRecCnt && ticks_elapsed(ptTask->ulTimerChar, ptTask->ulTimeoutChar)!=0) )
+	{
+		ptState->pucCmdCnt += ptTask->ulCmdSize;
+		ptState->pucRecCnt = ptTask->pucRxCnt;
+		ptTask->tState = SEQ_TASK_STATE_Next;
+	}
+	else if( ptTask->ulTimeoutTotal!=0 && seq_task_timer_elapsed(ptTask, ptTask->ulTimerTotal, ptTask->ulTimeoutTotal)!=0 )
+	{
+		uprintf("UART%d: The total timeout elapsed.\n", ptTask->ptHandle->ulUartIndex);
+		trace_event(UART_TRACE_EVENT_TimeoutTotal, ptState->ulUartIndex, ptState->ucCommand, ptState->ulBytes);
+		iResult = -1;
 	}
 
-	return tResult;
+	return iResult;
 }
 
 
 
-static int processCommandSequence(unsigned long ulVerbose, UART_PARAMETER_RUN_SEQUENCE_T *ptParameter)
+static int seq_task_step(SEQ_TASK_T *ptTask)
 {
 	int iResult;
-	CMD_STATE_T tState;
-	unsigned char ucData;
-	UART_SEQ_COMMAND_T tCmd;
-	unsigned int uiDataSize;
-	UART_HANDLE_T *ptHandle;
 
 
-	/* An empty command is OK. */
 	iResult = 0;
+	switch( ptTask->tState )
+	{
+	case SEQ_TASK_STATE_Next:
+		iResult = seq_task_step_next(ptTask);
+		break;
 
-	/* Get the verbose flag. */
-	tState.ulVerbose = ulVerbose;
+	case SEQ_TASK_STATE_Transfer:
+		iResult = seq_task_step_transfer(ptTask);
+		break;
 
-	/* Get the handle. */
-	ptHandle = (UART_HANDLE_T*)(ptParameter->ptHandle);
+	case SEQ_TASK_STATE_ReceiveUntil:
+		iResult = seq_task_step_receive_until(ptTask);
+		break;
+
+	case SEQ_TASK_STATE_ReceiveIdle:
+		iResult = seq_task_step_receive_idle(ptTask);
+		break;
+
+	case SEQ_TASK_STATE_Delay:
+		if( seq_task_timer_elapsed(ptTask, ptTask->ulTimerTotal, ptTask->ulTimeoutTotal)!=0 )
+		{
+			ptTask->tCmdState.pucCmdCnt += ptTask->ulCmdSize;
+			ptTask->tState = SEQ_TASK_STATE_Next;
+		}
+		break;
+
+	case SEQ_TASK_STATE_Done:
+	case SEQ_TASK_STATE_Error:
+		break;
+	}
 
-	/* Loop over all commands. */
-	tState.pucCmdCnt = ptParameter->pucCommand;
-	tState.pucCmdEnd = tState.pucCmdCnt + ptParameter->sizCommand;
-	tState.pucRecCnt = ptParameter->pucReceivedData;
-	tState.pucRecEnd = tState.pucRecCnt + ptParameter->sizReceivedDataMax;
-	if( tState.ulVerbose!=0U )
+	/* The command is finished if the task waits for the next command or
+	 * the step failed.
+	 */
+	if( iResult!=0 || ptTask->tState==SEQ_TASK_STATE_Next )
 	{
-		uprintf("Running command [0x%08x, 0x%08x[ with a receive buffer of %d bytes [0x%08x, 0x%08x[.\n",
-		        (unsigned long)tState.pucCmdCnt,
-		        (unsigned long)tState.pucCmdEnd,
-		        ptParameter->sizReceivedDataMax,
-		        (unsigned long)tState.pucRecCnt,
-		        (unsigned long)tState.pucRecEnd
-		);
+		sequenceCommandEnd(&(ptTask->tCmdState), iResult);
 	}
 
-	while( tState.pucCmdCnt<tState.pucCmdEnd )
+	return iResult;
+}
+
+
+
+/* Reject the commands which are not supported in the parallel mode. The
+ * sequence was already validated, so all command sizes are known.
+ */
+static int seq_task_check_commands(const CMD_STATE_T *ptState)
+{
+	int iResult;
+	const unsigned char *pucCmd;
+	unsigned long ulSize;
+
+
+	iResult = 0;
+	pucCmd = ptState->pucCmdStart;
+	while( iResult==0 && pucCmd<ptState->pucCmdEnd )
 	{
-		/* Get the next command. */
-		iResult = -1;
-		ucData = *(tState.pucCmdCnt++);
-		tCmd = (UART_SEQ_COMMAND_T)ucData;
-		switch( tCmd )
+		switch( (UART_SEQ_COMMAND_T)(pucCmd[0]) )
 		{
-		case UART_SEQ_COMMAND_Clean:
-		case UART_SEQ_COMMAND_Send:
-		case UART_SEQ_COMMAND_Receive:
-		case UART_SEQ_COMMAND_BaudRate:
-		case UART_SEQ_COMMAND_Delay:
-			iResult = 0;
+		case UART_SEQ_COMMAND_Bert:
+		case UART_SEQ_COMMAND_ReceiveTimestamps:
+		case UART_SEQ_COMMAND_BaudSweep:
+		case UART_SEQ_COMMAND_AutoBaud:
+		case UART_SEQ_COMMAND_Benchmark:
+		case UART_SEQ_COMMAND_SendRegisters:
+		case UART_SEQ_COMMAND_CrcAppend:
+		case UART_SEQ_COMMAND_SendPattern:
+			uprintf("The command 0x%02x at offset %d is not supported in the parallel mode.\n", pucCmd[0], (unsigned long)(pucCmd - ptState->pucCmdStart));
+			iResult = -1;
 			break;
-		}
-		if( iResult!=0 )
-		{
-			uprintf("Invalid command: 0x%02x\n", ucData);
+
+		default:
+			iResult = sequence_get_command_size(pucCmd, ptState->pucCmdEnd, &ulSize);
+			pucCmd += ulSize;
 			break;
 		}
-		else
-		{
-			switch( tCmd )
-			{
-			case UART_SEQ_COMMAND_Clean:
-				iResult = command_clean(&tState, ptHandle);
-				break;
+	}
 
-			case UART_SEQ_COMMAND_Send:
-				iResult = command_send(&tState, ptHandle);
-				break;
+	return iResult;
+}
 
-			case UART_SEQ_COMMAND_Receive:
-				iResult = command_receive(&tState, ptHandle);
-				break;
 
-			case UART_SEQ_COMMAND_BaudRate:
-				iResult = command_baudrate(&tState, ptHandle);
-				break;
 
-			case UART_SEQ_COMMAND_Delay:
-				iResult = command_delay(&tState);
-				break;
-			}
-			if( iResult!=0 )
+static int processCommandSequences(unsigned long ulVerbose, UART_PARAMETER_RUN_SEQUENCES_T *ptParameter)
+{
+	int iResult;
+	unsigned int uiSequences;
+	unsigned int uiCnt;
+	unsigned int uiOther;
+	unsigned int uiRunning;
+	UART_PARAMETER_RUN_SEQUENCE_T *ptSequences;
+	SEQ_TASK_T *ptTask;
+
+
+	iResult = 0;
+	uiSequences = ptParameter->sizSequences;
+	ptSequences = (UART_PARAMETER_RUN_SEQUENCE_T*)(ptParameter->ptSequences);
+	if( uiSequences==0 || uiSequences>SEQ_TASKS_MAX )
+	{
+		uprintf("The number of sequences must be between 1 and %d.\n", SEQ_TASKS_MAX);
+		iResult = -1;
+	}
+	else
+	{
+		/* Each UART can only run one sequence. */
+		for(uiCnt=0; uiCnt<uiSequences; ++uiCnt)
+		{
+			for(uiOther=uiCnt+1U; uiOther<uiSequences; ++uiOther)
 			{
-				if( tState.ulVerbose!=0U )
+				if( ((UART_HANDLE_T*)(ptSequences[uiCnt].ptHandle))->ptUart==((UART_HANDLE_T*)(ptSequences[uiOther].ptHandle))->ptUart )
 				{
-					uprintf("The command failed. Stopping execution of the sequence.\n");
+					uprintf("The sequences %d and %d use the same UART.\n", uiCnt, uiOther);
+					iResult = -1;
 				}
-				break;
 			}
 		}
 	}
 
 	if( iResult==0 )
 	{
-		/* Set the size of the result data. */
-		uiDataSize = (unsigned int)(tState.pucRecCnt-ptParameter->pucReceivedData);
-		if( uiDataSize<=ptParameter->sizReceivedDataMax )
+		for(uiCnt=0; uiCnt<uiSequences; ++uiCnt)
 		{
-			ptParameter->sizReceivedData = uiDataSize;
+			ptTask = atSeqTasks + uiCnt;
+			ptTask->tState = SEQ_TASK_STATE_Next;
+			ptTask->ptHandle = (UART_HANDLE_T*)(ptSequences[uiCnt].ptHandle);
+			ptTask->ptParameter = ptSequences + uiCnt;
+			if( sequenceStateInit(&(ptTask->tCmdState), ulVerbose, ptTask->ptParameter)!=0 || seq_task_check_commands(&(ptTask->tCmdState))!=0 )
+			{
+				ptTask->tState = SEQ_TASK_STATE_Error;
+				iResult = -1;
+			}
 		}
-		else
+
+		/* Start no sequence if one of them is invalid. */
+		if( iResult!=0 )
 		{
-			iResult = -1;
+			uprintf("A sequence is invalid. No sequence was started.\n");
+			for(uiCnt=0; uiCnt<uiSequences; ++uiCnt)
+			{
+				atSeqTasks[uiCnt].tState = SEQ_TASK_STATE_Error;
+			}
+		}
+
+		/* Step all sequences until each one is done or failed. A failed
+		 * sequence does not stop the others.
+		 */
+		do
+		{
+			uiRunning = 0;
+			for(uiCnt=0; uiCnt<uiSequences; ++uiCnt)
+			{
+				ptTask = atSeqTasks + uiCnt;
+				if( ptTask->tState<SEQ_TASK_STATE_Done )
+				{
+					iResult = seq_task_step(ptTask);
+					if( iResult!=0 )
+					{
+						uprintf("The command of sequence %d failed. Stopping execution of the sequence.\n", uiCnt);
+						ptTask->tState = SEQ_TASK_STATE_Error;
+					}
+					else
+					{
+						++uiRunning;
+					}
+				}
+			}
+		} while( uiRunning!=0 );
+
+		/* The result is only OK if all sequences are OK. */
+		iResult = 0;
+		for(uiCnt=0; uiCnt<uiSequences; ++uiCnt)
+		{
+			ptTask = atSeqTasks + uiCnt;
+			if( sequenceStateFinish(&(ptTask->tCmdState), (ptTask->tState==SEQ_TASK_STATE_Done) ? 0 : -1, ptTask->ptParameter)!=0 )
+			{
+				iResult = -1;
+			}
 		}
 	}
 
@@ -950,6 +5816,7 @@ static int processCommandSequence(unsigned long ulVerbose, UART_PARAMETER_RUN_SE
 static TEST_RESULT_T processCommandClose(unsigned long ulVerbose, UART_PARAMETER_CLOSE_T *ptParameter)
 {
 	unsigned long ulValue;
+	unsigned long ulTimer;
 	UART_HANDLE_T *ptHandle;
 	HOSTADEF(UART) *ptUartArea;
 
@@ -968,10 +5835,17 @@ static TEST_RESULT_T processCommandClose(unsigned long ulVerbose, UART_PARAMETER
 	{
 		uprintf("Waiting until all data in the TX FIFO is sent...\n");
 	}
+	ulTimer = systime_get_ms();
 	do
 	{
 		ulValue  = ptUartArea->ulUartfr;
 		ulValue &= HOSTMSK(uartfr_BUSY);
+		if( ptHandle->ulTimeoutCtsMs!=0 && systime_elapsed(ulTimer, ptHandle->ulTimeoutCtsMs)!=0 )
+		{
+			/* CTS stopped the transmitter. Drop the rest of the data. */
+			uprintf("The transmitter waited %dms for CTS.\n", ptHandle->ulTimeoutCtsMs);
+			break;
+		}
 	} while( ulValue!=0 );
 	if( ulVerbose!=0 )
 	{
@@ -998,36 +5872,28 @@ static TEST_RESULT_T processCommandClose(unsigned long ulVerbose, UART_PARAMETER
 
 
 
-TEST_RESULT_T test(UART_PARAMETER_T *ptTestParams)
+static TEST_RESULT_T processCommand(UART_PARAMETER_T *ptParameter)
 {
 	TEST_RESULT_T tResult;
 	int iResult;
 	unsigned long ulVerbose;
 	UART_CMD_T tCmd;
 
-	systime_init();
-
-	/* Set the verbose mode. */
-	ulVerbose = ptTestParams->ulVerbose;
-	if( ulVerbose!=0 )
-	{
-		uprintf("\f. *** UART test by doc_bacardi@users.sourceforge.net ***\n");
-		uprintf("V" VERSION_ALL "\n\n");
-
-		/* Get the test parameter. */
-		uprintf(". Parameters: 0x%08x\n", (unsigned long)ptTestParams);
-		uprintf(".    Verbose: 0x%08x\n", ptTestParams->ulVerbose);
-	}
 
-	tCmd = (UART_CMD_T)(ptTestParams->ulCommand);
+	ulVerbose = ptParameter->ulVerbose;
+	tCmd = (UART_CMD_T)(ptParameter->ulCommand);
 	tResult = TEST_RESULT_ERROR;
 	switch(tCmd)
 	{
 	case UART_CMD_Open:
 	case UART_CMD_RunSequence:
 	case UART_CMD_Close:
+	case UART_CMD_RunSequences:
 		tResult = TEST_RESULT_OK;
 		break;
+
+	case UART_CMD_Serve:
+		break;
 	}
 	if( tResult!=TEST_RESULT_OK )
 	{
@@ -1038,11 +5904,11 @@ TEST_RESULT_T test(UART_PARAMETER_T *ptTestParams)
 		switch(tCmd)
 		{
 		case UART_CMD_Open:
-			tResult = processCommandOpen(ulVerbose, &(ptTestParams->uParameter.tOpen));
+			tResult = processCommandOpen(ulVerbose, &(ptParameter->uParameter.tOpen));
 			break;
 
 		case UART_CMD_RunSequence:
-			iResult = processCommandSequence(ulVerbose, &(ptTestParams->uParameter.tRunSequence));
+			iResult = processCommandSequence(ulVerbose, &(ptParameter->uParameter.tRunSequence));
 			if( iResult!=0 )
 			{
 				tResult = TEST_RESULT_ERROR;
@@ -1050,7 +5916,18 @@ TEST_RESULT_T test(UART_PARAMETER_T *ptTestParams)
 			break;
 
 		case UART_CMD_Close:
-			tResult = processCommandClose(ulVerbose, &(ptTestParams->uParameter.tClose));
+			tResult = processCommandClose(ulVerbose, &(ptParameter->uParameter.tClose));
+			break;
+
+		case UART_CMD_RunSequences:
+			iResult = processCommandSequences(ulVerbose, &(ptParameter->uParameter.tRunSequences));
+			if( iResult!=0 )
+			{
+				tResult = TEST_RESULT_ERROR;
+			}
+			break;
+
+		case UART_CMD_Serve:
 			break;
 		}
 	}
@@ -1067,4 +5944,104 @@ TEST_RESULT_T test(UART_PARAMETER_T *ptTestParams)
 	return tResult;
 }
 
+
+
+/* The parameters in the mailbox are not volatile. The barrier completes all
+ * accesses to them before the request is processed and before the
+ * acknowledge is written. The host simulation needs only a compiler barrier.
+ */
+#if ASIC_TYP==ASIC_TYP_HOSTSIM
+#       define MAILBOX_BARRIER() __asm__ __volatile__ ("" : : : "memory")
+#else
+#       define MAILBOX_BARRIER() __asm__ __volatile__ ("dmb" : : : "memory")
+#endif
+
+static TEST_RESULT_T processCommandServe(unsigned long ulVerbose, UART_PARAMETER_SERVE_T *ptParameter)
+{
+	UART_MAILBOX_T *ptMailbox;
+	unsigned long ulRequest;
+	TEST_RESULT_T tResult;
+
+
+	ptMailbox = (UART_MAILBOX_T*)(ptParameter->ptMailbox);
+
+	if( ulVerbose!=0 )
+	{
+		uprintf("Serving requests from the mailbox at 0x%08x.\n", (unsigned long)ptMailbox);
+	}
+
+	/* The mailbox is in the parameter area. The host writes it over the
+	 * debug interface while the loop is running.
+	 */
+	while(1)
+	{
+		ulRequest = ptMailbox->ulRequest;
+		if( ulRequest!=ptMailbox->ulAcknowledge )
+		{
+			/* Read the parameters only after the request. */
+			MAILBOX_BARRIER();
+
+			if( ptMailbox->tParameter.ulCommand==UART_CMD_Serve )
+			{
+				ptMailbox->ulResult = TEST_RESULT_OK;
+				MAILBOX_BARRIER();
+				ptMailbox->ulAcknowledge = ulRequest;
+				break;
+			}
+
+			tResult = processCommand(&(ptMailbox->tParameter));
+			ptMailbox->ulResult = tResult;
+
+			/* Write all results before the acknowledge. */
+			MAILBOX_BARRIER();
+			ptMailbox->ulAcknowledge = ulRequest;
+		}
+	}
+
+	if( ulVerbose!=0 )
+	{
+		uprintf("Leaving the server mode.\n");
+	}
+
+	return TEST_RESULT_OK;
+}
+
+
+
+TEST_RESULT_T test(UART_PARAMETER_T *ptTestParams)
+{
+	TEST_RESULT_T tResult;
+	unsigned long ulVerbose;
+
+
+	systime_init();
+	ticks_init();
+
+	/* Set the verbose mode. */
+	ulVerbose = ptTestParams->ulVerbose;
+	if( ulVerbose!=0 )
+	{
+		uprintf("\f. *** UART test by doc_bacardi@users.sourceforge.net ***\n");
+		uprintf("V" VERSION_ALL "\n\n");
+
+		/* Get the test parameter. */
+		uprintf(". Parameters: 0x%08x\n", (unsigned long)ptTestParams);
+		uprintf(".    Verbose: 0x%08x\n", ptTestParams->ulVerbose);
+	}
+
+	/* The server mode keeps running and takes all further commands from
+	 * the mailbox. This skips the setup above for each command.
+	 */
+	if( (UART_CMD_T)(ptTestParams->ulCommand)==UART_CMD_Serve )
+	{
+		tResult = processCommandServe(ulVerbose, &(ptTestParams->uParameter.tServe));
+	}
+	else
+	{
+		tResult = processCommand(ptTestParams);
+	}
+
+	return tResult;
+}
+
 /*-----------------------------------*/
@@ -0,0 +1,171 @@
+#include "pattern_match.h"
+
+
+
+static unsigned int pattern_match_get_child(const PATTERN_MATCH_T *ptMatch, unsigned int uiState, unsigned char ucData)
+{
+	unsigned int uiChild;
+
+
+	/* State 0 is the root, so it is never a child. */
+	uiChild = ptMatch->aucFirstChild[uiState];
+	while( uiChild!=0 && ptMatch->aucChar[uiChild]!=ucData )
+	{
+		uiChild = ptMatch->aucNextSibling[uiChild];
+	}
+
+	return uiChild;
+}
+
+
+
+void pattern_match_init(PATTERN_MATCH_T *ptMatch)
+{
+	/* Start with the root state only. */
+	ptMatch->uiStates = 1;
+	ptMatch->uiCurrentState = 0;
+	ptMatch->aucChar[0] = 0;
+	ptMatch->aucFirstChild[0] = 0;
+	ptMatch->aucNextSibling[0] = 0;
+	ptMatch->aucFail[0] = 0;
+	ptMatch->aucMatch[0] = 0;
+}
+
+
+
+int pattern_match_add(PATTERN_MATCH_T *ptMatch, const unsigned char *pucPattern, size_t sizPattern, unsigned int uiPatternIndex)
+{
+	int iResult;
+	const unsigned char *pucCnt;
+	const unsigned char *pucEnd;
+	unsigned int uiState;
+	unsigned int uiChild;
+
+
+	iResult = 0;
+	if( sizPattern==0 || uiPatternIndex>=PATTERN_MATCH_MAX_PATTERNS )
+	{
+		iResult = -1;
+	}
+	else
+	{
+		uiState = 0;
+		pucCnt = pucPattern;
+		pucEnd = pucPattern + sizPattern;
+		while( pucCnt<pucEnd )
+		{
+			uiChild = pattern_match_get_child(ptMatch, uiState, *pucCnt);
+			if( uiChild==0 )
+			{
+				if( ptMatch->uiStates>=PATTERN_MATCH_MAX_STATES )
+				{
+					iResult = -1;
+					break;
+				}
+
+				/* Add a new state as the first child. */
+				uiChild = ptMatch->uiStates++;
+				ptMatch->aucChar[uiChild] = *pucCnt;
+				ptMatch->aucFirstChild[uiChild] = 0;
+				ptMatch->aucNextSibling[uiChild] = ptMatch->aucFirstChild[uiState];
+				ptMatch->aucFail[uiChild] = 0;
+				ptMatch->aucMatch[uiChild] = 0;
+				ptMatch->aucFirstChild[uiState] = (unsigned char)uiChild;
+			}
+			uiState = uiChild;
+			++pucCnt;
+		}
+
+		/* Keep the first pattern if two are equal. */
+		if( iResult==0 && ptMatch->aucMatch[uiState]==0 )
+		{
+			ptMatch->aucMatch[uiState] = (unsigned char)(uiPatternIndex + 1U);
+		}
+	}
+
+	return iResult;
+}
+
+
+
+void pattern_match_compile(PATTERN_MATCH_T *ptMatch)
+{
+	unsigned char aucQueue[PATTERN_MATCH_MAX_STATES];
+	unsigned int uiQueueRead;
+	unsigned int uiQueueWrite;
+	unsigned int uiState;
+	unsigned int uiChild;
+	unsigned int uiFail;
+	unsigned int uiNext;
+
+
+	/* Set the failure links in breadth-first order. The children of the root fail to the root. */
+	uiQueueRead = 0;
+	uiQueueWrite = 0;
+	uiChild = ptMatch->aucFirstChild[0];
+	while( uiChild!=0 )
+	{
+		ptMatch->aucFail[uiChild] = 0;
+		aucQueue[uiQueueWrite++] = (unsigned char)uiChild;
+		uiChild = ptMatch->aucNextSibling[uiChild];
+	}
+
+	while( uiQueueRead<uiQueueWrite )
+	{
+		uiState = aucQueue[uiQueueRead++];
+
+		uiChild = ptMatch->aucFirstChild[uiState];
+		while( uiChild!=0 )
+		{
+			/* Follow the failure links of the parent until the character continues a known prefix. */
+			uiFail = ptMatch->aucFail[uiState];
+			while( 1 )
+			{
+				uiNext = pattern_match_get_child(ptMatch, uiFail, ptMatch->aucChar[uiChild]);
+				if( uiNext!=0 || uiFail==0 )
+				{
+					break;
+				}
+				uiFail = ptMatch->aucFail[uiFail];
+			}
+			ptMatch->aucFail[uiChild] = (unsigned char)uiNext;
+
+			/* A state also matches all patterns which are a suffix of it. */
+			if( ptMatch->aucMatch[uiChild]==0 )
+			{
+				ptMatch->aucMatch[uiChild] = ptMatch->aucMatch[uiNext];
+			}
+
+			aucQueue[uiQueueWrite++] = (unsigned char)uiChild;
+			uiChild = ptMatch->aucNextSibling[uiChild];
+		}
+	}
+
+	ptMatch->uiCurrentState = 0;
+}
+
+
+
+/* Feed one byte to the automaton. The result is the number of the matching
+ * pattern plus 1, or 0 if no pattern ends with this byte.
+ */
+unsigned int pattern_match_step(PATTERN_MATCH_T *ptMatch, unsigned char ucData)
+{
+	unsigned int uiState;
+	unsigned int uiNext;
+
+
+	uiState = ptMatch->uiCurrentState;
+	while( 1 )
+	{
+		uiNext = pattern_match_get_child(ptMatch, uiState, ucData);
+		if( uiNext!=0 || uiState==0 )
+		{
+			break;
+		}
+		uiState = ptMatch->aucFail[uiState];
+	}
+	ptMatch->uiCurrentState = uiNext;
+
+	return ptMatch->aucMatch[uiNext];
+}
@@ -0,0 +1,36 @@
+#include <stddef.h>
+
+#ifndef __PATTERN_MATCH_H__
+#define __PATTERN_MATCH_H__
+
+
+/* The automaton finds any of several byte patterns in a stream. It is an
+ * Aho-Corasick automaton without the complete transition table. The
+ * transitions are stored as a tree of siblings, which keeps the memory small
+ * for the few short patterns of a receive command.
+ */
+
+#define PATTERN_MATCH_MAX_PATTERNS 8
+#define PATTERN_MATCH_MAX_STATES   65
+
+
+typedef struct PATTERN_MATCH_STRUCT
+{
+	unsigned int uiStates;
+	unsigned int uiCurrentState;
+	unsigned char aucChar[PATTERN_MATCH_MAX_STATES];
+	unsigned char aucFirstChild[PATTERN_MATCH_MAX_STATES];
+	unsigned char aucNextSibling[PATTERN_MATCH_MAX_STATES];
+	unsigned char aucFail[PATTERN_MATCH_MAX_STATES];
+	/* The number of the pattern ending in this state plus 1, or 0 for none. */
+	unsigned char aucMatch[PATTERN_MATCH_MAX_STATES];
+} PATTERN_MATCH_T;
+
+
+void pattern_match_init(PATTERN_MATCH_T *ptMatch);
+int pattern_match_add(PATTERN_MATCH_T *ptMatch, const unsigned char *pucPattern, size_t sizPattern, unsigned int uiPatternIndex);
+void pattern_match_compile(PATTERN_MATCH_T *ptMatch);
+unsigned int pattern_match_step(PATTERN_MATCH_T *ptMatch, unsigned char ucData);
+
+
+#endif  /* __PATTERN_MATCH_H__ */
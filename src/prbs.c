@@ -0,0 +1,78 @@
+#include "prbs.h"
+
+
+
+int prbs_init(PRBS_T *ptPrbs, UART_SEQ_PRBS_T tType, unsigned long ulSeed)
+{
+	int iResult;
+	unsigned int uiTapLow;
+
+
+	iResult = 0;
+	switch( tType )
+	{
+	case UART_SEQ_PRBS_7:
+		uiTapLow = 6;
+		break;
+
+	case UART_SEQ_PRBS_15:
+		uiTapLow = 14;
+		break;
+
+	case UART_SEQ_PRBS_23:
+		uiTapLow = 18;
+		break;
+
+	case UART_SEQ_PRBS_31:
+		uiTapLow = 28;
+		break;
+
+	default:
+		iResult = -1;
+		uiTapLow = 0;
+		break;
+	}
+
+	if( iResult==0 )
+	{
+		ptPrbs->uiTapHigh = (unsigned int)tType;
+		ptPrbs->uiTapLow = uiTapLow;
+		ptPrbs->ulMask = 0xffffffffU >> (32U - (unsigned int)tType);
+
+		/* The state must not be 0. This would only generate zeros. */
+		ulSeed &= ptPrbs->ulMask;
+		if( ulSeed==0 )
+		{
+			ulSeed = ptPrbs->ulMask;
+		}
+		ptPrbs->ulState = ulSeed;
+	}
+
+	return iResult;
+}
+
+
+
+/* Get the next 8 bits of the sequence. The first bit is the LSB, which is
+ * also the first bit on the UART line.
+ */
+unsigned char prbs_get_byte(PRBS_T *ptPrbs)
+{
+	unsigned long ulState;
+	unsigned long ulBit;
+	unsigned long ulData;
+	unsigned int uiCnt;
+
+
+	ulState = ptPrbs->ulState;
+	ulData = 0;
+	for(uiCnt=0; uiCnt<8; ++uiCnt)
+	{
+		ulBit = ((ulState >> (ptPrbs->uiTapHigh - 1U)) ^ (ulState >> (ptPrbs->uiTapLow - 1U))) & 1U;
+		ulState = ((ulState << 1U) | ulBit) & ptPrbs->ulMask;
+		ulData |= ulBit << uiCnt;
+	}
+	ptPrbs->ulState = ulState;
+
+	return (unsigned char)ulData;
+}
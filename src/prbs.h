@@ -0,0 +1,27 @@
+#include "interface.h"
+
+#ifndef __PRBS_H__
+#define __PRBS_H__
+
+
+/* A pseudo random bit sequence from a linear feedback shift register.
+ * The polynomials are the ones from ITU-T O.150:
+ *   PRBS7:  x^7 + x^6 + 1
+ *   PRBS15: x^15 + x^14 + 1
+ *   PRBS23: x^23 + x^18 + 1
+ *   PRBS31: x^31 + x^28 + 1
+ */
+typedef struct PRBS_STRUCT
+{
+	unsigned long ulState;
+	unsigned long ulMask;
+	unsigned int uiTapHigh;
+	unsigned int uiTapLow;
+} PRBS_T;
+
+
+int prbs_init(PRBS_T *ptPrbs, UART_SEQ_PRBS_T tType, unsigned long ulSeed);
+unsigned char prbs_get_byte(PRBS_T *ptPrbs);
+
+
+#endif  /* __PRBS_H__ */
@@ -0,0 +1,71 @@
+#include "ticks.h"
+
+#include "systime.h"
+
+
+
+void ticks_init(void)
+{
+#if ASIC_TYP==ASIC_TYP_NETX4000_RELAXED || ASIC_TYP==ASIC_TYP_NETX4000
+	unsigned long ulValue;
+
+
+	/* Enable all counters of the performance monitor in PMCR. */
+	__asm__ __volatile__ ("mrc p15, 0, %0, c9, c12, 0" : "=r" (ulValue));
+	ulValue |= 1U;
+	__asm__ __volatile__ ("mcr p15, 0, %0, c9, c12, 0" : : "r" (ulValue));
+
+	/* Enable the cycle counter in PMCNTENSET. */
+	ulValue = 0x80000000U;
+	__asm__ __volatile__ ("mcr p15, 0, %0, c9, c12, 1" : : "r" (ulValue));
+
+#elif ASIC_TYP==ASIC_TYP_NETX90_MPW || ASIC_TYP==ASIC_TYP_NETX90 || ASIC_TYP==ASIC_TYP_NETX90_MPW_APP || ASIC_TYP==ASIC_TYP_NETX90_APP
+	/* Enable the trace unit in the DEMCR register with the TRCENA bit. */
+	*((volatile unsigned long*)0xe000edfcU) |= 0x01000000U;
+
+	/* Start the cycle counter in the DWT_CTRL register with the CYCCNTENA bit. */
+	*((volatile unsigned long*)0xe0001000U) |= 0x00000001U;
+#endif
+}
+
+
+
+/* Check if a duration in ticks elapsed since the start. */
+int ticks_elapsed(unsigned long ulStart, unsigned long ulDuration)
+{
+	unsigned long ulDiff;
+	int iElapsed;
+
+
+	/* The unsigned subtraction also works if the counter wrapped around. */
+	ulDiff = ticks_get() - ulStart;
+	iElapsed = 0;
+	if( ulDiff>=ulDuration )
+	{
+		iElapsed = 1;
+	}
+
+	return iElapsed;
+}
+
+
+
+void ticks_delay_us(unsigned long ulDelayUs)
+{
+	unsigned long ulStart;
+
+
+	/* Wait the complete milliseconds with the systime. This keeps the
+	 * duration in ticks below the wrap around.
+	 */
+	if( ulDelayUs>=1000U )
+	{
+		systime_delay_ms(ulDelayUs / 1000U);
+		ulDelayUs %= 1000U;
+	}
+
+	ulStart = ticks_get();
+	while( ticks_elapsed(ulStart, ulDelayUs * TICKS_PER_US)==0 )
+	{
+	}
+}
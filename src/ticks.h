@@ -0,0 +1,58 @@
+#include "asic_types.h"
+
+#ifndef __TICKS_H__
+#define __TICKS_H__
+
+
+/* The ticks are a free-running 32 bit counter in the CPU core. Reading it
+ * does not leave the core, so it is much cheaper than the SYSTIME unit.
+ *
+ * The counter wraps around after 2^32 ticks. This is about 7 seconds on the
+ * netX4000 and about 42 seconds on the netX90. Longer times must use the
+ * "systime" functions.
+ */
+
+#if ASIC_TYP==ASIC_TYP_NETX4000_RELAXED || ASIC_TYP==ASIC_TYP_NETX4000
+/* The Cortex-R7 cycle counter of the performance monitor runs with 600MHz. */
+#       define TICKS_PER_US 600UL
+
+static inline unsigned long ticks_get(void)
+{
+	unsigned long ulValue;
+
+
+	__asm__ __volatile__ ("mrc p15, 0, %0, c9, c13, 0" : "=r" (ulValue));
+	return ulValue;
+}
+
+#elif ASIC_TYP==ASIC_TYP_NETX90_MPW || ASIC_TYP==ASIC_TYP_NETX90 || ASIC_TYP==ASIC_TYP_NETX90_MPW_APP || ASIC_TYP==ASIC_TYP_NETX90_APP
+/* The Cortex-M4 DWT cycle counter runs with 100MHz. */
+#       define TICKS_PER_US 100UL
+#       define TICKS_DWT_CYCCNT (*((volatile unsigned long*)0xe0001004U))
+
+static inline unsigned long ticks_get(void)
+{
+	return TICKS_DWT_CYCCNT;
+}
+
+#elif ASIC_TYP==ASIC_TYP_HOSTSIM
+/* The host simulation counts nanoseconds of the virtual clock. */
+#       define TICKS_PER_US 1000UL
+
+unsigned long ticks_get(void);
+
+#else
+#       error "Unsupported ASIC_TYPE!"
+#endif
+
+
+/* This is the longest time in microseconds which can be measured with the ticks. */
+#define TICKS_MAX_US (0xffffffffUL / TICKS_PER_US)
+
+
+void ticks_init(void);
+int ticks_elapsed(unsigned long ulStart, unsigned long ulDuration);
+void ticks_delay_us(unsigned long ulDelayUs);
+
+
+#endif  /* __TICKS_H__ */
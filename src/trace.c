@@ -0,0 +1,56 @@
+#include "trace.h"
+
+#include <stddef.h>
+
+#include "ticks.h"
+
+
+static UART_TRACE_T *s_ptTrace;
+
+
+
+/* Set up a new trace in the buffer. The buffer must have space for the
+ * header and at least one entry, or the trace is disabled.
+ */
+void trace_init(UART_TRACE_T *ptTrace, unsigned long sizTrace)
+{
+	unsigned long ulEntries;
+
+
+	s_ptTrace = NULL;
+	if( ptTrace!=NULL && sizTrace>sizeof(UART_TRACE_T) )
+	{
+		ulEntries = (sizTrace - sizeof(UART_TRACE_T)) / sizeof(UART_TRACE_ENTRY_T);
+		if( ulEntries!=0 )
+		{
+			ptTrace->ulWriteCount = 0;
+			ptTrace->ulEntries = ulEntries;
+			s_ptTrace = ptTrace;
+		}
+	}
+}
+
+
+
+void trace_event(UART_TRACE_EVENT_T tEvent, unsigned long ulUart, unsigned long ulParameter, unsigned long ulValue)
+{
+	UART_TRACE_T *ptTrace;
+	UART_TRACE_ENTRY_T *ptEntry;
+	unsigned long ulWriteCount;
+
+
+	ptTrace = s_ptTrace;
+	if( ptTrace!=NULL )
+	{
+		ulWriteCount = ptTrace->ulWriteCount;
+		ptEntry = ptTrace->atEntries + (ulWriteCount % ptTrace->ulEntries);
+		ptEntry->ucEvent = (uint8_t)tEvent;
+		ptEntry->ucUart = (uint8_t)ulUart;
+		ptEntry->usParameter = (uint16_t)ulParameter;
+		ptEntry->ulValue = ulValue;
+		ptEntry->ulTicks = ticks_get();
+
+		/* Count the entry after it is complete. */
+		ptTrace->ulWriteCount = ulWriteCount + 1U;
+	}
+}
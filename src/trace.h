@@ -0,0 +1,16 @@
+#include "interface.h"
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+
+/* Write events to the trace ring buffer. This is much cheaper than
+ * "uprintf", so it can be used in the transfer loops. Without a buffer
+ * the events are dropped.
+ */
+
+void trace_init(UART_TRACE_T *ptTrace, unsigned long sizTrace);
+void trace_event(UART_TRACE_EVENT_T tEvent, unsigned long ulUart, unsigned long ulParameter, unsigned long ulValue);
+
+
+#endif  /* __TRACE_H__ */
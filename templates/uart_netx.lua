@@ -6,14 +6,114 @@ function UartNetx:_init(tLog)
   self.UART_CMD_Open = ${UART_CMD_Open}
   self.UART_CMD_RunSequence = ${UART_CMD_RunSequence}
   self.UART_CMD_Close = ${UART_CMD_Close}
+  self.UART_CMD_Serve = ${UART_CMD_Serve}
+  self.UART_CMD_RunSequences = ${UART_CMD_RunSequences}
 
   self.UART_SEQ_COMMAND_Clean = ${UART_SEQ_COMMAND_Clean}
   self.UART_SEQ_COMMAND_Send = ${UART_SEQ_COMMAND_Send}
   self.UART_SEQ_COMMAND_Receive = ${UART_SEQ_COMMAND_Receive}
   self.UART_SEQ_COMMAND_BaudRate = ${UART_SEQ_COMMAND_BaudRate}
   self.UART_SEQ_COMMAND_Delay = ${UART_SEQ_COMMAND_Delay}
-
+  self.UART_SEQ_COMMAND_Transceive = ${UART_SEQ_COMMAND_Transceive}
+  self.UART_SEQ_COMMAND_Expect = ${UART_SEQ_COMMAND_Expect}
+  self.UART_SEQ_COMMAND_ReceiveUntil = ${UART_SEQ_COMMAND_ReceiveUntil}
+  self.UART_SEQ_COMMAND_ReceiveIdle = ${UART_SEQ_COMMAND_ReceiveIdle}
+  self.UART_SEQ_COMMAND_ReceiveUs = ${UART_SEQ_COMMAND_ReceiveUs}
+  self.UART_SEQ_COMMAND_DelayUs = ${UART_SEQ_COMMAND_DelayUs}
+  self.UART_SEQ_COMMAND_Repeat = ${UART_SEQ_COMMAND_Repeat}
+  self.UART_SEQ_COMMAND_EndRepeat = ${UART_SEQ_COMMAND_EndRepeat}
+  self.UART_SEQ_COMMAND_Bert = ${UART_SEQ_COMMAND_Bert}
+  self.UART_SEQ_COMMAND_ReceiveTimestamps = ${UART_SEQ_COMMAND_ReceiveTimestamps}
+  self.UART_SEQ_COMMAND_BaudSweep = ${UART_SEQ_COMMAND_BaudSweep}
+  self.UART_SEQ_COMMAND_AutoBaud = ${UART_SEQ_COMMAND_AutoBaud}
+  self.UART_SEQ_COMMAND_Benchmark = ${UART_SEQ_COMMAND_Benchmark}
+  self.UART_SEQ_COMMAND_JumpIf = ${UART_SEQ_COMMAND_JumpIf}
+  self.UART_SEQ_COMMAND_RegisterLoad = ${UART_SEQ_COMMAND_RegisterLoad}
+  self.UART_SEQ_COMMAND_RegisterOp = ${UART_SEQ_COMMAND_RegisterOp}
+  self.UART_SEQ_COMMAND_SendRegisters = ${UART_SEQ_COMMAND_SendRegisters}
+  self.UART_SEQ_COMMAND_CrcAppend = ${UART_SEQ_COMMAND_CrcAppend}
+  self.UART_SEQ_COMMAND_CrcVerify = ${UART_SEQ_COMMAND_CrcVerify}
+  self.UART_SEQ_COMMAND_SendPattern = ${UART_SEQ_COMMAND_SendPattern}
+  self.UART_SEQ_COMMAND_SendLong = ${UART_SEQ_COMMAND_SendLong}
+  self.UART_SEQ_COMMAND_ReceiveLong = ${UART_SEQ_COMMAND_ReceiveLong}
+
+  self.UART_FLOW_CONTROL_Cts = ${UART_FLOW_CONTROL_Cts}
+
+  self.UART_RX_ERROR_Overrun = ${UART_RX_ERROR_Overrun}
+  self.UART_RX_ERROR_Framing = ${UART_RX_ERROR_Framing}
+  self.UART_RX_ERROR_Parity = ${UART_RX_ERROR_Parity}
+  self.UART_RX_ERROR_Break = ${UART_RX_ERROR_Break}
+  self.UART_RX_ERROR_ACTION_Continue = ${UART_RX_ERROR_ACTION_Continue}
+  self.UART_RX_ERROR_ACTION_Mark = ${UART_RX_ERROR_ACTION_Mark}
+  self.UART_RX_ERROR_ACTION_Stop = ${UART_RX_ERROR_ACTION_Stop}
+
+  self.UART_SEQ_EXPECT_FLAG_Mask = ${UART_SEQ_EXPECT_FLAG_Mask}
+  self.UART_SEQ_EXPECT_FLAG_Stop = ${UART_SEQ_EXPECT_FLAG_Stop}
+
+  self.UART_SEQ_REPEAT_FLAG_Overwrite = ${UART_SEQ_REPEAT_FLAG_Overwrite}
+
+  self.UART_SEQ_JUMP_FLAG_Mask = ${UART_SEQ_JUMP_FLAG_Mask}
+  self.UART_SEQ_JUMP_FLAG_Not = ${UART_SEQ_JUMP_FLAG_Not}
+  self.UART_SEQ_JUMP_FLAG_Remove = ${UART_SEQ_JUMP_FLAG_Remove}
+
+  self.UART_SEQ_REGISTER_Count = ${UART_SEQ_REGISTER_Count}
+  self.UART_SEQ_REGISTER_FLAG_BigEndian = ${UART_SEQ_REGISTER_FLAG_BigEndian}
+  self.UART_SEQ_REGISTER_FLAG_FromEnd = ${UART_SEQ_REGISTER_FLAG_FromEnd}
+  self.UART_SEQ_REGISTER_OP_Set = ${UART_SEQ_REGISTER_OP_Set}
+  self.UART_SEQ_REGISTER_OP_Add = ${UART_SEQ_REGISTER_OP_Add}
+
+  self.UART_SEQ_PATTERN_Fill = ${UART_SEQ_PATTERN_Fill}
+  self.UART_SEQ_PATTERN_Counter = ${UART_SEQ_PATTERN_Counter}
+  self.UART_SEQ_PATTERN_Block = ${UART_SEQ_PATTERN_Block}
+
+  self.UART_SEQ_CRC_Modbus = ${UART_SEQ_CRC_Modbus}
+  self.UART_SEQ_CRC_Ccitt = ${UART_SEQ_CRC_Ccitt}
+  self.UART_SEQ_CRC_Crc32 = ${UART_SEQ_CRC_Crc32}
+  self.UART_SEQ_CRC_HistorySize = ${UART_SEQ_CRC_HistorySize}
+  self.UART_SEQ_CRC_FLAG_Remove = ${UART_SEQ_CRC_FLAG_Remove}
+  self.UART_SEQ_CRC_FLAG_Stop = ${UART_SEQ_CRC_FLAG_Stop}
+  self.UART_SEQ_CRC_FLAG_Status = ${UART_SEQ_CRC_FLAG_Status}
+
+  self.UART_SEQ_PRBS_7 = ${UART_SEQ_PRBS_7}
+  self.UART_SEQ_PRBS_15 = ${UART_SEQ_PRBS_15}
+  self.UART_SEQ_PRBS_23 = ${UART_SEQ_PRBS_23}
+  self.UART_SEQ_PRBS_31 = ${UART_SEQ_PRBS_31}
+  self.UART_SEQ_BERT_RESULT_SIZE = ${SIZEOF_UART_SEQ_BERT_RESULT_STRUCT}
+
+  self.UART_SEQ_BAUD_SWEEP_HeaderSize = ${UART_SEQ_BAUD_SWEEP_HeaderSize}
+  self.UART_SEQ_BAUD_SWEEP_RECORD_SIZE = ${SIZEOF_UART_SEQ_BAUD_SWEEP_RECORD_STRUCT}
+  self.UART_SEQ_AUTOBAUD_EdgesMax = ${UART_SEQ_AUTOBAUD_EdgesMax}
+  self.UART_SEQ_AUTOBAUD_RESULT_SIZE = ${SIZEOF_UART_SEQ_AUTOBAUD_RESULT_STRUCT}
+  self.UART_SEQ_BENCHMARK_RESULT_SIZE = ${SIZEOF_UART_SEQ_BENCHMARK_RESULT_STRUCT}
+
+  self.UART_SEQ_RECEIVE_IDLE_GapMinMs = ${UART_SEQ_RECEIVE_IDLE_GapMinMs}
+
+  self.UART_SEQ_RECEIVE_UNTIL_HeaderSize = ${UART_SEQ_RECEIVE_UNTIL_HeaderSize}
+  self.UART_SEQ_RECEIVE_UNTIL_NoMatch = ${UART_SEQ_RECEIVE_UNTIL_NoMatch}
+
+  self.UART_SEQ_RECEIVE_TIMESTAMPS_HeaderSize = ${UART_SEQ_RECEIVE_TIMESTAMPS_HeaderSize}
+  self.UART_SEQ_RECEIVE_TIMESTAMPS_DeltaSizeMax = ${UART_SEQ_RECEIVE_TIMESTAMPS_DeltaSizeMax}
+
+  self.UART_PARAMETER_SIZE = ${SIZEOF_UART_PARAMETER_STRUCT}
   self.UART_HANDLE_SIZE = ${SIZEOF_UART_HANDLE_STRUCT}
+  self.UART_MAILBOX_SIZE = ${SIZEOF_UART_MAILBOX_STRUCT}
+  self.UART_RUN_SEQUENCE_SIZE = ${SIZEOF_UART_PARAMETER_RUN_SEQUENCE_STRUCT}
+  self.UART_SEQ_TELEMETRY_RECORD_SIZE = ${SIZEOF_UART_SEQ_TELEMETRY_RECORD_STRUCT}
+
+  self.UART_TRACE_EVENT_SequenceStart = ${UART_TRACE_EVENT_SequenceStart}
+  self.UART_TRACE_EVENT_SequenceEnd = ${UART_TRACE_EVENT_SequenceEnd}
+  self.UART_TRACE_EVENT_CommandStart = ${UART_TRACE_EVENT_CommandStart}
+  self.UART_TRACE_EVENT_CommandEnd = ${UART_TRACE_EVENT_CommandEnd}
+  self.UART_TRACE_EVENT_TimeoutTotal = ${UART_TRACE_EVENT_TimeoutTotal}
+  self.UART_TRACE_EVENT_TimeoutChar = ${UART_TRACE_EVENT_TimeoutChar}
+  self.UART_TRACE_EVENT_RxError = ${UART_TRACE_EVENT_RxError}
+  self.UART_TRACE_HEADER_SIZE = ${SIZEOF_UART_TRACE_STRUCT}
+  self.UART_TRACE_ENTRY_SIZE = ${SIZEOF_UART_TRACE_ENTRY_STRUCT}
+  -- This is the size of the trace buffer in the netX RAM. It is part of the
+  -- parameter area, which has only 4KiB for everything.
+  self.UART_TRACE_SIZE = 1024
+  -- There is one handle for each UART unit.
+  self.UART_HANDLE_SLOTS = 4
 
   self.romloader = require 'romloader'
   self.lpeg = require 'lpeglabel'
@@ -43,8 +143,34 @@ function UartNetx:__create_macro_grammar()
   local CleanCommand = lpeg.V('CleanCommand')
   local ReceiveCommand = lpeg.V('ReceiveCommand')
   local SendCommand = lpeg.V('SendCommand')
+  local SendPatternCommand = lpeg.V('SendPatternCommand')
+  local SendBlockCommand = lpeg.V('SendBlockCommand')
   local BaudRateCommand = lpeg.V('BaudRateCommand')
   local DelayCommand = lpeg.V('DelayCommand')
+  local TransceiveCommand = lpeg.V('TransceiveCommand')
+  local ExpectCommand = lpeg.V('ExpectCommand')
+  local ReceiveUntilCommand = lpeg.V('ReceiveUntilCommand')
+  local ReceiveIdleCommand = lpeg.V('ReceiveIdleCommand')
+  local ReceiveUsCommand = lpeg.V('ReceiveUsCommand')
+  local ReceiveTimestampsCommand = lpeg.V('ReceiveTimestampsCommand')
+  local DelayUsCommand = lpeg.V('DelayUsCommand')
+  local RepeatCommand = lpeg.V('RepeatCommand')
+  local EndCommand = lpeg.V('EndCommand')
+  local BertCommand = lpeg.V('BertCommand')
+  local BaudSweepCommand = lpeg.V('BaudSweepCommand')
+  local AutoBaudCommand = lpeg.V('AutoBaudCommand')
+  local BenchmarkCommand = lpeg.V('BenchmarkCommand')
+  local LabelCommand = lpeg.V('LabelCommand')
+  local JumpIfCommand = lpeg.V('JumpIfCommand')
+  local JumpCommand = lpeg.V('JumpCommand')
+  local Label = lpeg.V('Label')
+  local LoadCommand = lpeg.V('LoadCommand')
+  local RegisterCommand = lpeg.V('RegisterCommand')
+  local Register = lpeg.V('Register')
+  local RegisterRef = lpeg.V('RegisterRef')
+  local SendData = lpeg.V('SendData')
+  local CrcAppendCommand = lpeg.V('CrcAppendCommand')
+  local CrcVerifyCommand = lpeg.V('CrcVerifyCommand')
   local Command = lpeg.V('Command')
   local Comment = lpeg.V('Comment')
   local Statement = lpeg.V('Statement')
@@ -60,14 +186,20 @@ function UartNetx:__create_macro_grammar()
     -- A comment starts with a hash and covers the complete line.
     Comment = lpeg.P('#') * (1 - lpeg.S("\r\n"))^0;
 
-    -- A command is one of the 5 possible commands.
-    Command = lpeg.Ct(Space * (CleanCommand + SendCommand + ReceiveCommand + BaudRateCommand + DelayCommand) * Comment^-1 * Space);
+    -- A command is one of the possible commands.
+    Command = lpeg.Ct(Space * (CleanCommand + SendPatternCommand + SendBlockCommand + SendCommand + ReceiveUntilCommand + ReceiveIdleCommand + ReceiveUsCommand + ReceiveTimestampsCommand + ReceiveCommand + BaudRateCommand + DelayUsCommand + DelayCommand + TransceiveCommand + ExpectCommand + RepeatCommand + EndCommand + BertCommand + BaudSweepCommand + AutoBaudCommand + BenchmarkCommand + LabelCommand + JumpIfCommand + JumpCommand + LoadCommand + RegisterCommand + CrcAppendCommand + CrcVerifyCommand) * Comment^-1 * Space);
 
     -- A clean command has no parameter.
     CleanCommand = lpeg.Cg(lpeg.P("clean"), 'cmd');
 
-    -- A send command has a data definition as parameters.
-    SendCommand = lpeg.Cg(lpeg.P("send"), 'cmd') * Space * Data;
+    -- A send command has a data definition as parameters. The data can also contain registers.
+    SendCommand = lpeg.Cg(lpeg.P("send"), 'cmd') * Space * SendData;
+
+    -- A send_fill or send_counter command has the value, the number of bytes in one block and an optional number of blocks.
+    SendPatternCommand = lpeg.Cg(lpeg.P("send_fill") + lpeg.P("send_counter"), 'cmd') * Space * lpeg.Cg(Integer, 'value') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'length') * (Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'count'))^-1;
+
+    -- A send_block command has a data definition and the number of blocks.
+    SendBlockCommand = lpeg.Cg(lpeg.P("send_block"), 'cmd') * Space * lpeg.Cg(Data, 'data') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'count');
 
     -- A receive command has a length parameter, a total timeout and a char timeout.
     ReceiveCommand = lpeg.Cg(lpeg.P("receive"), 'cmd') * Space * lpeg.Cg(Integer, 'length') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_total') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_char');
@@ -78,6 +210,79 @@ function UartNetx:__create_macro_grammar()
     -- A delay command has the delay in milliseconds as the parameter.
     DelayCommand = lpeg.Cg(lpeg.P("delay"), 'cmd') * Space * lpeg.Cg(Integer, 'delay'); 
 
+    -- A transceive command has a data definition, the receive length, a total timeout and a char timeout.
+    TransceiveCommand = lpeg.Cg(lpeg.P("transceive"), 'cmd') * Space * Data * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'length') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_total') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_char');
+
+    -- An expect command has a data definition, an optional mask and an optional "stop" flag.
+    ExpectCommand = lpeg.Cg(lpeg.P("expect"), 'cmd') * Space * lpeg.Cg(Data, 'data') * (Space * lpeg.P(',') * Space * lpeg.Cg(Data, 'mask'))^-1 * (Space * lpeg.P(',') * Space * lpeg.Cg(lpeg.P("stop"), 'stop'))^-1;
+
+    -- A receive until command has the maximum length, a total timeout, a char timeout and a list of patterns.
+    ReceiveUntilCommand = lpeg.Cg(lpeg.P("receive_until"), 'cmd') * Space * lpeg.Cg(Integer, 'length') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_total') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_char') * Space * lpeg.P(',') * Space * lpeg.Cg(lpeg.Ct(Data * (Space * lpeg.P(',') * Space * Data)^0), 'patterns');
+
+    -- A receive idle command has the maximum length, a total timeout and the idle gap which ends the command.
+    -- The netX measures the gap in microseconds. It must be at least 2 milliseconds.
+    ReceiveIdleCommand = lpeg.Cg(lpeg.P("receive_idle"), 'cmd') * Space * lpeg.Cg(Integer, 'length') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_total') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'idle_gap');
+
+    -- A receive_us command is a receive command with the timeouts in microseconds.
+    ReceiveUsCommand = lpeg.Cg(lpeg.P("receive_us"), 'cmd') * Space * lpeg.Cg(Integer, 'length') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_total') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_char');
+
+    -- A receive_ts command is a receive_us command which also stores the arrival time of each byte.
+    ReceiveTimestampsCommand = lpeg.Cg(lpeg.P("receive_ts"), 'cmd') * Space * lpeg.Cg(Integer, 'length') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_total') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_char');
+
+    -- A delay_us command has the delay in microseconds as the parameter.
+    DelayUsCommand = lpeg.Cg(lpeg.P("delay_us"), 'cmd') * Space * lpeg.Cg(Integer, 'delay');
+
+    -- A repeat command starts a block which ends with "end". It has the number of iterations and an optional mode for the received data.
+    RepeatCommand = lpeg.Cg(lpeg.P("repeat"), 'cmd') * Space * lpeg.Cg(Integer, 'count') * (Space * lpeg.P(',') * Space * lpeg.Cg(lpeg.P("append") + lpeg.P("overwrite"), 'mode'))^-1;
+
+    -- An end command closes the last repeat block.
+    EndCommand = lpeg.Cg(lpeg.P("end"), 'cmd');
+
+    -- A BERT command has the PRBS type, the number of bytes, a char timeout in microseconds and an optional seed.
+    BertCommand = lpeg.Cg(lpeg.P("bert"), 'cmd') * Space * lpeg.Cg(lpeg.P("prbs7") + lpeg.P("prbs15") + lpeg.P("prbs23") + lpeg.P("prbs31"), 'prbs') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'length') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_char') * (Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'seed'))^-1;
+
+    -- A baud sweep command has the PRBS type, the first and last divider, the step between the dividers, the number of bytes for each divider and a char timeout in microseconds.
+    BaudSweepCommand = lpeg.Cg(lpeg.P("baudsweep"), 'cmd') * Space * lpeg.Cg(lpeg.P("prbs7") + lpeg.P("prbs15") + lpeg.P("prbs23") + lpeg.P("prbs31"), 'prbs') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'first') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'last') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'step') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'length') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_char');
+
+    -- An autobaud command has the number of falling edges to measure and a total timeout. The DUT must send the sync byte 0x55.
+    AutoBaudCommand = lpeg.Cg(lpeg.P("autobaud"), 'cmd') * Space * lpeg.Cg(Integer, 'edges') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_total');
+
+    -- A benchmark command has the number of bytes, the baud rate (0 keeps the current one) and a char timeout in microseconds. It needs a loopback.
+    BenchmarkCommand = lpeg.Cg(lpeg.P("benchmark"), 'cmd') * Space * lpeg.Cg(Integer, 'length') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'baudrate') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'timeout_char');
+
+    -- A label command marks the position of the next command as a jump target.
+    LabelCommand = lpeg.Cg(lpeg.P("label"), 'cmd') * Space * lpeg.Cg(Label, 'label');
+
+    -- A jumpif command has a data definition, an optional mask, the label of the target and an optional "remove" flag. "jumpifnot" jumps if the data does not match.
+    JumpIfCommand = lpeg.Cg(lpeg.P("jumpifnot") + lpeg.P("jumpif"), 'cmd') * Space * lpeg.Cg(Data, 'data') * (Space * lpeg.P(',') * Space * lpeg.Cg(Data, 'mask'))^-1 * Space * lpeg.P(',') * Space * lpeg.Cg(Label, 'label') * (Space * lpeg.P(',') * Space * lpeg.Cg(lpeg.P("remove"), 'remove'))^-1;
+
+    -- A jump command always jumps to the label.
+    JumpCommand = lpeg.Cg(lpeg.P("jump"), 'cmd') * Space * lpeg.Cg(Label, 'label');
+
+    -- A label starts with a letter or an underscore.
+    Label = (lpeg.R('az', 'AZ') + lpeg.P('_')) * (lpeg.R('az', 'AZ', '09') + lpeg.P('_'))^0;
+
+    -- A load command has the register, the offset in the receive buffer, the number of bytes, an optional byte order and an optional "from_end" flag which counts the offset back from the end of the received data.
+    LoadCommand = lpeg.Cg(lpeg.P("load"), 'cmd') * Space * lpeg.Cg(Register, 'register') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'offset') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'size') * (Space * lpeg.P(',') * Space * lpeg.Cg(lpeg.P("be") + lpeg.P("le"), 'byteorder'))^-1 * (Space * lpeg.P(',') * Space * lpeg.Cg(lpeg.P("from_end"), 'from_end'))^-1;
+
+    -- A set or add command has the register and the value.
+    RegisterCommand = lpeg.Cg(lpeg.P("set") + lpeg.P("add"), 'cmd') * Space * lpeg.Cg(Register, 'register') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'value');
+
+    -- A crc_append command has the CRC type and the number of the last sent bytes.
+    CrcAppendCommand = lpeg.Cg(lpeg.P("crc_append"), 'cmd') * Space * lpeg.Cg(lpeg.P("modbus") + lpeg.P("ccitt") + lpeg.P("crc32"), 'crc') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'length');
+
+    -- A crc_verify command has the CRC type, the size of the received frame with the CRC and optional "remove", "stop" and "status" flags.
+    CrcVerifyCommand = lpeg.Cg(lpeg.P("crc_verify"), 'cmd') * Space * lpeg.Cg(lpeg.P("modbus") + lpeg.P("ccitt") + lpeg.P("crc32"), 'crc') * Space * lpeg.P(',') * Space * lpeg.Cg(Integer, 'length') * lpeg.Cg(lpeg.Ct((Space * lpeg.P(',') * Space * lpeg.C(lpeg.P("remove") + lpeg.P("stop") + lpeg.P("status")))^0), 'flags');
+
+    -- A register is an "r" followed by the number.
+    Register = lpeg.P('r') * lpeg.R('09')^1;
+
+    -- A register in the data has the number of bytes and an optional byte order, e.g. "r0:2be".
+    RegisterRef = Register * lpeg.P(':') * lpeg.R('14') * (lpeg.P("be") + lpeg.P("le"))^-1;
+
+    -- The data of a send command can also contain registers.
+    SendData = lpeg.Ct(lpeg.P('{') * Space * (lpeg.Cg(QuotedString) + lpeg.Cg(RegisterRef) + lpeg.Cg(Integer)) * Space * (lpeg.P(',') * Space * (lpeg.Cg(QuotedString) + lpeg.Cg(RegisterRef) + lpeg.Cg(Integer)))^0 * Space * lpeg.P('}'));
+
     -- A data definition is a list of comma separated integers or strings surrounded by curly brackets. 
     Data = lpeg.Ct(lpeg.P('{') * Space * (lpeg.Cg(QuotedString) + lpeg.Cg(Integer)) * Space * (lpeg.P(',') * Space * (lpeg.Cg(QuotedString) + lpeg.Cg(Integer)))^0 * Space * lpeg.P('}'));
 
@@ -122,6 +327,11 @@ function UartNetx:initialize(tPlugin)
   -- Get the binary for the ASIC.
   local tAsicTyp = tPlugin:GetChiptyp()
   local strBinary = astrBinaryName[tAsicTyp]
+  -- The telemetry measures the time in CPU cycles.
+  local atTicksPerUs = {
+    ['4000'] = 600,
+    ['90'] = 100
+  }
   if strBinary==nil then
     local strMsg = string.format('No binary for chip type %s.', tAsicTyp)
     tLog.error(strMsg)
@@ -136,7 +346,8 @@ function UartNetx:initialize(tPlugin)
 
   return {
     plugin = tPlugin,
-    attr = aAttr
+    attr = aAttr,
+    ulTicksPerUs = atTicksPerUs[strBinary]
   }
 end
 
@@ -161,6 +372,22 @@ end
 
 
 
+-- Parse a number and check the maximum. strName is the name of the value
+-- in the error message.
+function UartNetx:__parseNumberMax(strNumber, ulMax, uiCommandCnt, strName)
+  local tLog = self.tLog
+
+  local ulValue = self:__parseNumber(strNumber)
+  if ulValue>ulMax then
+    tLog.error('The %s of command %d is %d, but the maximum is %d.', strName, uiCommandCnt, ulValue, ulMax)
+    error(string.format('Invalid %s.', strName))
+  end
+
+  return ulValue
+end
+
+
+
 function UartNetx:__uint16_to_bytes(usData)
   local ucB1 = math.floor(usData/256)
   local ucB0 = usData - 256*ucB1
@@ -183,12 +410,123 @@ end
 
 
 
+function UartNetx:__uint32_list_to_string(aulData)
+  local astrData = {}
+  for _, ulData in ipairs(aulData) do
+    table.insert(astrData, string.char(self:__uint32_to_bytes(ulData)))
+  end
+
+  return table.concat(astrData)
+end
+
+
+
+function UartNetx:__bytes_to_uint32(strData, uiOffset)
+  local ucB0, ucB1, ucB2, ucB3 = string.byte(strData, uiOffset+1, uiOffset+4)
+
+  return ucB0 + 0x00000100*ucB1 + 0x00010000*ucB2 + 0x01000000*ucB3
+end
+
+
+
+function UartNetx:__uint32_to_int32(ulData)
+  if ulData>=0x80000000 then
+    ulData = ulData - 0x100000000
+  end
+
+  return ulData
+end
+
+
+
+function UartNetx:__parseRegister(strRegister, uiCommandCnt)
+  local tLog = self.tLog
+
+  local uiRegister = tonumber(string.sub(strRegister, 2))
+  if uiRegister>=self.UART_SEQ_REGISTER_Count then
+    tLog.error('Command %d uses the register %s, but there are only %d registers.', uiCommandCnt, strRegister, self.UART_SEQ_REGISTER_Count)
+    error('Invalid register.')
+  end
+
+  return uiRegister
+end
+
+
+
+-- Parse a data definition. Registers are only allowed if atPlaceholders is
+-- a table. One placeholder is added for each register then and the data has
+-- 0 at its position.
+function UartNetx:__parseData(atRawData, uiCommandCnt, atPlaceholders)
+  local tLog = self.tLog
+
+  -- Collect the data.
+  local astrData = {}
+  local astrReplace = {
+    ['\\"'] = '"',
+    ["\\'"] = "'",
+    ['\\a'] = '\a',
+    ['\\b'] = '\b',
+    ['\\f'] = '\f',
+    ['\\n'] = '\n',
+    ['\\r'] = '\r',
+    ['\\t'] = '\t',
+    ['\\v'] = '\v'
+  }
+  for uiDataElement, strData in ipairs(atRawData) do
+    if string.sub(strData, 1, 1)=='"' or string.sub(strData, 1, 1)=="'" then
+      -- Unquote the string.
+      strData = string.sub(strData, 2, -2)
+      -- Unescape the string.
+      strData = string.gsub(strData, '(\\["\'abfnrtv])', astrReplace)
+      table.insert(astrData, strData)
+    elseif string.sub(strData, 1, 1)=='r' then
+      -- A register like "r0:2be".
+      if atPlaceholders==nil then
+        tLog.error('Data element %d of command %d is a register, but this command has no registers.', uiDataElement, uiCommandCnt)
+        error('Invalid data.')
+      end
+      local strRegister, strSize, strByteOrder = string.match(strData, '^(r%d+):(%d)(%a*)$')
+      local uiSize = tonumber(strSize)
+      local ucFlags = 0
+      if strByteOrder=='be' then
+        ucFlags = ucFlags + self.UART_SEQ_REGISTER_FLAG_BigEndian
+      end
+      table.insert(atPlaceholders, {
+        offset = string.len(table.concat(astrData)),
+        register = self:__parseRegister(strRegister, uiCommandCnt),
+        size = uiSize,
+        flags = ucFlags
+      })
+      table.insert(astrData, string.rep(string.char(0), uiSize))
+    else
+      local uiData = self:__parseNumber(strData)
+      if uiData<0 or uiData>255 then
+        tLog.error('Data element %d of command %d exceeds the 8 bit range: %d.', uiDataElement, uiCommandCnt, uiData)
+        error('Invalid data.')
+      end
+      table.insert(astrData, string.char(uiData))
+    end
+  end
+
+  return table.concat(astrData)
+end
+
+
+
 function UartNetx:parseMacro(strMacro)
   local lpeg = self.lpeg
   local tLog = self.tLog
   local pl = self.pl
 
+  -- The expect command removes data from the receive buffer. Keep track of
+  -- the current fill level and the maximum.
+  local uiReadData = 0
   local uiExpectedReadData = 0
+  -- This is the stack of the open repeat blocks.
+  local atRepeat = {}
+  -- The jumps are completed when all labels are known.
+  local atLabels = {}
+  local atJumps = {}
   local tResult = lpeg.match(self.tGrammarMacro, strMacro)
   if tResult==nil then
     error('Failed to parse the macro...')
@@ -197,6 +535,20 @@ function UartNetx:parseMacro(strMacro)
 
     -- Collect the merged commands here.
     local astrMacro = {}
+    local function getMacroSize()
+      local sizMacro = 0
+      for _, strPart in ipairs(astrMacro) do
+        sizMacro = sizMacro + string.len(strPart)
+      end
+      return sizMacro
+    end
+    local function getOpenBlocks()
+      local atBlocks = {}
+      for uiCnt, tRepeat in ipairs(atRepeat) do
+        atBlocks[uiCnt] = tRepeat
+      end
+      return atBlocks
+    end
 
     for uiCommandCnt, tRawCommand in ipairs(tResult) do
       local strCmd = tRawCommand.cmd
@@ -206,65 +558,553 @@ function UartNetx:parseMacro(strMacro)
         ))
 
       elseif strCmd=='receive' then
-        -- Create a new receive command.
-        local ucLen0, ucLen1 = self:__uint16_to_bytes(self:__parseNumber(tRawCommand.length))
-        local ucTT0, ucTT1 = self:__uint16_to_bytes(self:__parseNumber(tRawCommand.timeout_total))
-        local ucTC0, ucTC1 = self:__uint16_to_bytes(self:__parseNumber(tRawCommand.timeout_char))
+        -- Create a new receive command. Values above 16 bit need the
+        -- extended command.
+        local uiLength = self:__parseNumber(tRawCommand.length)
+        local ulTimeoutTotal = self:__parseNumber(tRawCommand.timeout_total)
+        local ulTimeoutChar = self:__parseNumber(tRawCommand.timeout_char)
+        if uiLength>0xffff or ulTimeoutTotal>0xffff or ulTimeoutChar>0xffff then
+          local ucLen0, ucLen1, ucLen2, ucLen3 = self:__uint32_to_bytes(uiLength)
+          local ucTT0, ucTT1, ucTT2, ucTT3 = self:__uint32_to_bytes(ulTimeoutTotal)
+          local ucTC0, ucTC1, ucTC2, ucTC3 = self:__uint32_to_bytes(ulTimeoutChar)
+          table.insert(astrMacro, string.char(
+            self.UART_SEQ_COMMAND_ReceiveLong,
+            ucLen0, ucLen1, ucLen2, ucLen3,
+            ucTT0, ucTT1, ucTT2, ucTT3,
+            ucTC0, ucTC1, ucTC2, ucTC3
+          ))
+        else
+          local ucLen0, ucLen1 = self:__uint16_to_bytes(uiLength)
+          local ucTT0, ucTT1 = self:__uint16_to_bytes(ulTimeoutTotal)
+          local ucTC0, ucTC1 = self:__uint16_to_bytes(ulTimeoutChar)
+          table.insert(astrMacro, string.char(
+            self.UART_SEQ_COMMAND_Receive,
+            ucLen0, ucLen1,
+            ucTT0, ucTT1,
+            ucTC0, ucTC1
+          ))
+        end
+        uiReadData = uiReadData + uiLength
+        uiExpectedReadData = math.max(uiExpectedReadData, uiReadData)
+
+      elseif strCmd=='receive_idle' then
+        -- Create a new receive idle command.
+        local uiLength = self:__parseNumberMax(tRawCommand.length, 0xffff, uiCommandCnt, 'length')
+        local ucLen0, ucLen1 = self:__uint16_to_bytes(uiLength)
+        local ucTT0, ucTT1 = self:__uint16_to_bytes(self:__parseNumberMax(tRawCommand.timeout_total, 0xffff, uiCommandCnt, 'total timeout'))
+        local usIdleGap = self:__parseNumberMax(tRawCommand.idle_gap, 0xffff, uiCommandCnt, 'idle gap')
+        if usIdleGap<self.UART_SEQ_RECEIVE_IDLE_GapMinMs then
+          tLog.error('The idle gap of command %d is %d, but the minimum is %d.', uiCommandCnt, usIdleGap, self.UART_SEQ_RECEIVE_IDLE_GapMinMs)
+          error('Invalid idle gap.')
+        end
+        local ucIG0, ucIG1 = self:__uint16_to_bytes(usIdleGap)
         table.insert(astrMacro, string.char(
-          self.UART_SEQ_COMMAND_Receive,
+          self.UART_SEQ_COMMAND_ReceiveIdle,
           ucLen0, ucLen1,
           ucTT0, ucTT1,
-          ucTC0, ucTC1
+          ucIG0, ucIG1
         ))
-        uiExpectedReadData = uiExpectedReadData + tRawCommand.length
+        uiReadData = uiReadData + uiLength
+        uiExpectedReadData = math.max(uiExpectedReadData, uiReadData)
+
+      elseif strCmd=='receive_us' then
+        -- Create a new receive command with the timeouts in microseconds.
+        local uiLength = self:__parseNumberMax(tRawCommand.length, 0xffff, uiCommandCnt, 'length')
+        local ucLen0, ucLen1 = self:__uint16_to_bytes(uiLength)
+        local ucTT0, ucTT1, ucTT2, ucTT3 = self:__uint32_to_bytes(self:__parseNumberMax(tRawCommand.timeout_total, 0xffffffff, uiCommandCnt, 'total timeout'))
+        local ucTC0, ucTC1, ucTC2, ucTC3 = self:__uint32_to_bytes(self:__parseNumberMax(tRawCommand.timeout_char, 0xffffffff, uiCommandCnt, 'char timeout'))
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_ReceiveUs,
+          ucLen0, ucLen1,
+          ucTT0, ucTT1, ucTT2, ucTT3,
+          ucTC0, ucTC1, ucTC2, ucTC3
+        ))
+        uiReadData = uiReadData + uiLength
+        uiExpectedReadData = math.max(uiExpectedReadData, uiReadData)
+
+      elseif strCmd=='receive_ts' then
+        -- Create a new receive command with timestamps.
+        local uiLength = self:__parseNumberMax(tRawCommand.length, 0xffff, uiCommandCnt, 'length')
+        local ulTimeoutTotal = self:__parseNumberMax(tRawCommand.timeout_total, 0xffffffff, uiCommandCnt, 'total timeout')
+        if ulTimeoutTotal==0 then
+          tLog.error('The receive_ts command %d needs a total timeout.', uiCommandCnt)
+          error('Invalid timeout.')
+        end
+        local ucLen0, ucLen1 = self:__uint16_to_bytes(uiLength)
+        local ucTT0, ucTT1, ucTT2, ucTT3 = self:__uint32_to_bytes(ulTimeoutTotal)
+        local ucTC0, ucTC1, ucTC2, ucTC3 = self:__uint32_to_bytes(self:__parseNumberMax(tRawCommand.timeout_char, 0xffffffff, uiCommandCnt, 'char timeout'))
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_ReceiveTimestamps,
+          ucLen0, ucLen1,
+          ucTT0, ucTT1, ucTT2, ucTT3,
+          ucTC0, ucTC1, ucTC2, ucTC3
+        ))
+        -- The netX stores a header and the timestamps. Reserve the space for
+        -- the largest timestamps.
+        uiReadData = uiReadData + self.UART_SEQ_RECEIVE_TIMESTAMPS_HeaderSize + uiLength * (1 + self.UART_SEQ_RECEIVE_TIMESTAMPS_DeltaSizeMax)
+        uiExpectedReadData = math.max(uiExpectedReadData, uiReadData)
 
       elseif strCmd=='send' then
-        -- Create a new send command.
-        local tCmd = {
-          cmd = 'send',
-          data = nil
+        -- Create a new send command. Data with registers needs the send
+        -- registers command. Data with more than 65535 bytes needs the
+        -- extended command.
+        local atPlaceholders = {}
+        local strData = self:__parseData(tRawCommand[1], uiCommandCnt, atPlaceholders)
+        local sizData = string.len(strData)
+        local ucLen0, ucLen1 = self:__uint16_to_bytes(sizData)
+
+        if #atPlaceholders==0 and sizData>0xffff then
+          local ucL0, ucL1, ucL2, ucL3 = self:__uint32_to_bytes(sizData)
+          table.insert(astrMacro, string.char(
+            self.UART_SEQ_COMMAND_SendLong,
+            ucL0, ucL1, ucL2, ucL3
+          ))
+        elseif #atPlaceholders==0 then
+          table.insert(astrMacro, string.char(
+            self.UART_SEQ_COMMAND_Send,
+            ucLen0, ucLen1
+          ))
+        elseif sizData>0xffff then
+          tLog.error('Command %d sends %d bytes with registers, but the maximum is 65535.', uiCommandCnt, sizData)
+          error('Invalid length.')
+        else
+          if #atPlaceholders>255 then
+            tLog.error('Command %d has %d registers, but the maximum is 255.', uiCommandCnt, #atPlaceholders)
+            error('Too many registers.')
+          end
+          table.insert(astrMacro, string.char(
+            self.UART_SEQ_COMMAND_SendRegisters,
+            ucLen0, ucLen1,
+            #atPlaceholders
+          ))
+          for _, tPlaceholder in ipairs(atPlaceholders) do
+            local ucO0, ucO1 = self:__uint16_to_bytes(tPlaceholder.offset)
+            table.insert(astrMacro, string.char(
+              ucO0, ucO1,
+              tPlaceholder.register,
+              tPlaceholder.size,
+              tPlaceholder.flags
+            ))
+          end
+        end
+        table.insert(astrMacro, strData)
+
+      elseif strCmd=='send_fill' or strCmd=='send_counter' or strCmd=='send_block' then
+        -- Create a new send pattern command. The netX generates the data.
+        local ucPattern
+        local ucValue = 0
+        local strData = ''
+        local uiLength
+        local uiCount = 1
+        if strCmd=='send_block' then
+          ucPattern = self.UART_SEQ_PATTERN_Block
+          strData = self:__parseData(tRawCommand.data, uiCommandCnt)
+          uiLength = string.len(strData)
+        else
+          if strCmd=='send_fill' then
+            ucPattern = self.UART_SEQ_PATTERN_Fill
+          else
+            ucPattern = self.UART_SEQ_PATTERN_Counter
+          end
+          ucValue = self:__parseNumber(tRawCommand.value)
+          if ucValue<0 or ucValue>255 then
+            tLog.error('The value of command %d exceeds the 8 bit range: %d.', uiCommandCnt, ucValue)
+            error('Invalid value.')
+          end
+          uiLength = self:__parseNumber(tRawCommand.length)
+        end
+        if tRawCommand.count~=nil then
+          uiCount = self:__parseNumber(tRawCommand.count)
+        end
+        if uiLength>0xffff or uiCount>0xffff then
+          tLog.error('Command %d sends %d blocks of %d bytes, but the maximum is 65535 for both.', uiCommandCnt, uiCount, uiLength)
+          error('Invalid length.')
+        end
+        local ucLen0, ucLen1 = self:__uint16_to_bytes(uiLength)
+        local ucCnt0, ucCnt1 = self:__uint16_to_bytes(uiCount)
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_SendPattern,
+          ucPattern,
+          ucValue,
+          ucLen0, ucLen1,
+          ucCnt0, ucCnt1
+        ))
+        table.insert(astrMacro, strData)
+
+      elseif strCmd=='transceive' then
+        -- Create a new transceive command.
+        local strData = self:__parseData(tRawCommand[1], uiCommandCnt)
+        if string.len(strData)>0xffff then
+          tLog.error('Command %d sends %d bytes, but the maximum is 65535.', uiCommandCnt, string.len(strData))
+          error('Invalid length.')
+        end
+        local uiLength = self:__parseNumberMax(tRawCommand.length, 0xffff, uiCommandCnt, 'length')
+        local ucSLen0, ucSLen1 = self:__uint16_to_bytes(string.len(strData))
+        local ucRLen0, ucRLen1 = self:__uint16_to_bytes(uiLength)
+        local ucTT0, ucTT1 = self:__uint16_to_bytes(self:__parseNumberMax(tRawCommand.timeout_total, 0xffff, uiCommandCnt, 'total timeout'))
+        local ucTC0, ucTC1 = self:__uint16_to_bytes(self:__parseNumberMax(tRawCommand.timeout_char, 0xffff, uiCommandCnt, 'char timeout'))
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_Transceive,
+          ucSLen0, ucSLen1,
+          ucRLen0, ucRLen1,
+          ucTT0, ucTT1,
+          ucTC0, ucTC1
+        ))
+        table.insert(astrMacro, strData)
+        uiReadData = uiReadData + uiLength
+        uiExpectedReadData = math.max(uiExpectedReadData, uiReadData)
+
+      elseif strCmd=='expect' then
+        -- Create a new expect command.
+        local strData = self:__parseData(tRawCommand.data, uiCommandCnt)
+        local sizData = string.len(strData)
+        local ucFlags = 0
+        local strMask = ''
+        if tRawCommand.mask~=nil then
+          strMask = self:__parseData(tRawCommand.mask, uiCommandCnt)
+          if string.len(strMask)~=sizData then
+            tLog.error('The mask of command %d has %d bytes, but the data has %d bytes.', uiCommandCnt, string.len(strMask), sizData)
+            error('Invalid mask.')
+          end
+          ucFlags = ucFlags + self.UART_SEQ_EXPECT_FLAG_Mask
+        end
+        if tRawCommand.stop~=nil then
+          ucFlags = ucFlags + self.UART_SEQ_EXPECT_FLAG_Stop
+        end
+        local ucLen0, ucLen1 = self:__uint16_to_bytes(sizData)
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_Expect,
+          ucLen0, ucLen1,
+          ucFlags
+        ))
+        table.insert(astrMacro, strData)
+        table.insert(astrMacro, strMask)
+        -- The compared data is removed from the receive buffer.
+        uiReadData = math.max(0, uiReadData - sizData)
+
+      elseif strCmd=='receive_until' then
+        -- Create a new receive until command.
+        local uiLength = self:__parseNumberMax(tRawCommand.length, 0xffff, uiCommandCnt, 'length')
+        local ucLen0, ucLen1 = self:__uint16_to_bytes(uiLength)
+        local ucTT0, ucTT1 = self:__uint16_to_bytes(self:__parseNumberMax(tRawCommand.timeout_total, 0xffff, uiCommandCnt, 'total timeout'))
+        local ucTC0, ucTC1 = self:__uint16_to_bytes(self:__parseNumberMax(tRawCommand.timeout_char, 0xffff, uiCommandCnt, 'char timeout'))
+        if #tRawCommand.patterns>255 then
+          tLog.error('Command %d has %d patterns, but the maximum is 255.', uiCommandCnt, #tRawCommand.patterns)
+          error('Invalid pattern.')
+        end
+        local astrPatterns = {}
+        for _, atPattern in ipairs(tRawCommand.patterns) do
+          local strPattern = self:__parseData(atPattern, uiCommandCnt)
+          if string.len(strPattern)>255 then
+            tLog.error('A pattern of command %d has %d bytes, but the maximum is 255.', uiCommandCnt, string.len(strPattern))
+            error('Invalid pattern.')
+          end
+          table.insert(astrPatterns, string.char(string.len(strPattern)))
+          table.insert(astrPatterns, strPattern)
+        end
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_ReceiveUntil,
+          ucLen0, ucLen1,
+          ucTT0, ucTT1,
+          ucTC0, ucTC1,
+          #tRawCommand.patterns
+        ))
+        table.insert(astrMacro, table.concat(astrPatterns))
+        -- The netX stores a header in front of the data.
+        uiReadData = uiReadData + self.UART_SEQ_RECEIVE_UNTIL_HeaderSize + uiLength
+        uiExpectedReadData = math.max(uiExpectedReadData, uiReadData)
+
+      elseif strCmd=='repeat' then
+        -- Create a new repeat command.
+        local ulCount = self:__parseNumber(tRawCommand.count)
+        if ulCount<1 or ulCount>0xffffffff then
+          tLog.error('The repeat count of command %d must be between 1 and 0xffffffff: %d.', uiCommandCnt, ulCount)
+          error('Invalid repeat count.')
+        end
+        local fOverwrite = (tRawCommand.mode=='overwrite')
+        local ucFlags = 0
+        if fOverwrite==true then
+          ucFlags = ucFlags + self.UART_SEQ_REPEAT_FLAG_Overwrite
+        end
+        local ucC0, ucC1, ucC2, ucC3 = self:__uint32_to_bytes(ulCount)
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_Repeat,
+          ucC0, ucC1, ucC2, ucC3,
+          ucFlags
+        ))
+        -- Track the maximum of the block separately.
+        table.insert(atRepeat, {
+          count = ulCount,
+          overwrite = fOverwrite,
+          start = uiReadData,
+          max_before = uiExpectedReadData
+        })
+        uiExpectedReadData = uiReadData
+
+      elseif strCmd=='end' then
+        -- Create a new end repeat command.
+        local tRepeat = table.remove(atRepeat)
+        if tRepeat==nil then
+          tLog.error('Command %d is an "end" without a "repeat".', uiCommandCnt)
+          error('Unbalanced repeat block.')
+        end
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_EndRepeat
+        ))
+        -- The appended data of all iterations must fit into the buffer.
+        local iDelta = uiReadData - tRepeat.start
+        local uiMax = uiExpectedReadData
+        if tRepeat.overwrite~=true and iDelta>0 then
+          uiMax = uiMax + iDelta * (tRepeat.count - 1)
+          uiReadData = tRepeat.start + iDelta * tRepeat.count
+        end
+        uiExpectedReadData = math.max(tRepeat.max_before, uiMax)
+
+      elseif strCmd=='bert' then
+        -- Create a new BERT command.
+        local atPrbs = {
+          prbs7 = self.UART_SEQ_PRBS_7,
+          prbs15 = self.UART_SEQ_PRBS_15,
+          prbs23 = self.UART_SEQ_PRBS_23,
+          prbs31 = self.UART_SEQ_PRBS_31
         }
-        -- Collect the data.
-        local astrData = {}
-        local astrReplace = {
-          ['\\"'] = '"',
-          ["\\'"] = "'",
-          ['\\a'] = '\a',
-          ['\\b'] = '\b',
-          ['\\f'] = '\f',
-          ['\\n'] = '\n',
-          ['\\r'] = '\r',
-          ['\\t'] = '\t',
-          ['\\v'] = '\v'
+        local ulSeed = 0
+        if tRawCommand.seed~=nil then
+          ulSeed = self:__parseNumber(tRawCommand.seed)
+        end
+        local ucL0, ucL1, ucL2, ucL3 = self:__uint32_to_bytes(self:__parseNumber(tRawCommand.length))
+        local ucTC0, ucTC1, ucTC2, ucTC3 = self:__uint32_to_bytes(self:__parseNumber(tRawCommand.timeout_char))
+        local ucS0, ucS1, ucS2, ucS3 = self:__uint32_to_bytes(ulSeed)
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_Bert,
+          atPrbs[tRawCommand.prbs],
+          ucL0, ucL1, ucL2, ucL3,
+          ucTC0, ucTC1, ucTC2, ucTC3,
+          ucS0, ucS1, ucS2, ucS3
+        ))
+        -- Only the result is stored in the receive buffer.
+        uiReadData = uiReadData + self.UART_SEQ_BERT_RESULT_SIZE
+        uiExpectedReadData = math.max(uiExpectedReadData, uiReadData)
+
+      elseif strCmd=='baudsweep' then
+        -- Create a new baud sweep command.
+        local atPrbs = {
+          prbs7 = self.UART_SEQ_PRBS_7,
+          prbs15 = self.UART_SEQ_PRBS_15,
+          prbs23 = self.UART_SEQ_PRBS_23,
+          prbs31 = self.UART_SEQ_PRBS_31
         }
-        for uiDataElement, strData in ipairs(tRawCommand[1]) do
-          if string.sub(strData, 1, 1)=='"' or string.sub(strData, 1, 1)=="'" then
-            -- Unquote the string.
-            strData = string.sub(strData, 2, -2)
-            -- Unescape the string.
-            strData = string.gsub(strData, '(\\["\'abfnrtv])', astrReplace)
-            table.insert(astrData, strData)
-          else
-            local uiData = self:__parseNumber(strData)
-            if uiData<0 or uiData>255 then
-              tLog.error('Data element %d of command %d exceeds the 8 bit range: %d.', uiData, uiCommandCnt, tData)
-              error('Invalid data.')
+        local usFirst = self:__parseNumber(tRawCommand.first)
+        local usLast = self:__parseNumber(tRawCommand.last)
+        local usStep = self:__parseNumber(tRawCommand.step)
+        if usStep==0 then
+          tLog.error('Command %d is a "baudsweep" with a step of 0.', uiCommandCnt)
+          error('Invalid baud sweep.')
+        end
+        local ucF0, ucF1 = self:__uint16_to_bytes(usFirst)
+        local ucL0, ucL1 = self:__uint16_to_bytes(usLast)
+        local ucS0, ucS1 = self:__uint16_to_bytes(usStep)
+        local ucN0, ucN1 = self:__uint16_to_bytes(self:__parseNumber(tRawCommand.length))
+        local ucTC0, ucTC1, ucTC2, ucTC3 = self:__uint32_to_bytes(self:__parseNumber(tRawCommand.timeout_char))
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_BaudSweep,
+          atPrbs[tRawCommand.prbs],
+          ucF0, ucF1,
+          ucL0, ucL1,
+          ucS0, ucS1,
+          ucN0, ucN1,
+          ucTC0, ucTC1, ucTC2, ucTC3
+        ))
+        -- There is one record for each divider.
+        local uiSteps = math.floor(math.abs(usLast - usFirst) / usStep) + 1
+        uiReadData = uiReadData + self.UART_SEQ_BAUD_SWEEP_HeaderSize + uiSteps * self.UART_SEQ_BAUD_SWEEP_RECORD_SIZE
+        uiExpectedReadData = math.max(uiExpectedReadData, uiReadData)
+
+      elseif strCmd=='autobaud' then
+        -- Create a new autobaud command.
+        local uiEdges = self:__parseNumber(tRawCommand.edges)
+        if uiEdges<2 or uiEdges>self.UART_SEQ_AUTOBAUD_EdgesMax then
+          tLog.error('Command %d measures %d edges, but it must be 2 to %d.', uiCommandCnt, uiEdges, self.UART_SEQ_AUTOBAUD_EdgesMax)
+          error('Invalid edges.')
+        end
+        local usTimeoutTotal = self:__parseNumberMax(tRawCommand.timeout_total, 0xffff, uiCommandCnt, 'total timeout')
+        if usTimeoutTotal==0 then
+          tLog.error('The autobaud command %d needs a total timeout.', uiCommandCnt)
+          error('Invalid timeout.')
+        end
+        local ucTT0, ucTT1 = self:__uint16_to_bytes(usTimeoutTotal)
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_AutoBaud,
+          uiEdges,
+          ucTT0, ucTT1
+        ))
+        -- Only the result is stored in the receive buffer.
+        uiReadData = uiReadData + self.UART_SEQ_AUTOBAUD_RESULT_SIZE
+        uiExpectedReadData = math.max(uiExpectedReadData, uiReadData)
+
+      elseif strCmd=='benchmark' then
+        -- Create a new benchmark command.
+        local ucB0, ucB1, ucB2, ucB3 = self:__uint32_to_bytes(self:__parseNumber(tRawCommand.baudrate))
+        local ucL0, ucL1, ucL2, ucL3 = self:__uint32_to_bytes(self:__parseNumber(tRawCommand.length))
+        local ucTC0, ucTC1, ucTC2, ucTC3 = self:__uint32_to_bytes(self:__parseNumber(tRawCommand.timeout_char))
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_Benchmark,
+          ucB0, ucB1, ucB2, ucB3,
+          ucL0, ucL1, ucL2, ucL3,
+          ucTC0, ucTC1, ucTC2, ucTC3
+        ))
+        -- Only the result is stored in the receive buffer.
+        uiReadData = uiReadData + self.UART_SEQ_BENCHMARK_RESULT_SIZE
+        uiExpectedReadData = math.max(uiExpectedReadData, uiReadData)
+
+      elseif strCmd=='label' then
+        -- A label is no command. Remember the position and the open
+        -- repeat blocks.
+        local strLabel = tRawCommand.label
+        if atLabels[strLabel]~=nil then
+          tLog.error('Command %d defines the label "%s" again.', uiCommandCnt, strLabel)
+          error('Duplicate label.')
+        end
+        atLabels[strLabel] = {
+          position = getMacroSize(),
+          blocks = getOpenBlocks()
+        }
+
+      elseif strCmd=='jumpif' or strCmd=='jumpifnot' or strCmd=='jump' then
+        -- Create a new jump command. The header is set when all labels are
+        -- known.
+        local strData = ''
+        local strMask = ''
+        local ucFlags = 0
+        if strCmd~='jump' then
+          strData = self:__parseData(tRawCommand.data, uiCommandCnt)
+          if tRawCommand.mask~=nil then
+            strMask = self:__parseData(tRawCommand.mask, uiCommandCnt)
+            if string.len(strMask)~=string.len(strData) then
+              tLog.error('The mask of command %d has %d bytes, but the data has %d bytes.', uiCommandCnt, string.len(strMask), string.len(strData))
+              error('Invalid mask.')
             end
-            table.insert(astrData, string.char(uiData))
+            ucFlags = ucFlags + self.UART_SEQ_JUMP_FLAG_Mask
+          end
+          if strCmd=='jumpifnot' then
+            ucFlags = ucFlags + self.UART_SEQ_JUMP_FLAG_Not
           end
+          if tRawCommand.remove~=nil then
+            ucFlags = ucFlags + self.UART_SEQ_JUMP_FLAG_Remove
+            uiReadData = math.max(0, uiReadData - string.len(strData))
+          end
+        end
+        -- Reserve the 7 bytes of the header, so the positions of all
+        -- following labels and jumps are right.
+        table.insert(astrMacro, string.rep(string.char(0), 7))
+        local uiIndex = #astrMacro
+        table.insert(astrMacro, strData)
+        table.insert(astrMacro, strMask)
+        table.insert(atJumps, {
+          command = uiCommandCnt,
+          index = uiIndex,
+          flags = ucFlags,
+          size = string.len(strData),
+          label = tRawCommand.label,
+          blocks = getOpenBlocks(),
+          -- The offset is relative to the end of the command.
+          position = getMacroSize()
+        })
+
+      elseif strCmd=='load' then
+        -- Create a new register load command.
+        local ucFlags = 0
+        if tRawCommand.byteorder=='be' then
+          ucFlags = ucFlags + self.UART_SEQ_REGISTER_FLAG_BigEndian
+        end
+        if tRawCommand.from_end~=nil then
+          ucFlags = ucFlags + self.UART_SEQ_REGISTER_FLAG_FromEnd
         end
-        local strData = table.concat(astrData)
-        local ucLen0, ucLen1 = self:__uint16_to_bytes(string.len(strData))
+        local uiSize = self:__parseNumber(tRawCommand.size)
+        if uiSize<1 or uiSize>4 then
+          tLog.error('Command %d loads %d bytes, but a register has 1 to 4 bytes.', uiCommandCnt, uiSize)
+          error('Invalid size.')
+        end
+        local ucO0, ucO1 = self:__uint16_to_bytes(self:__parseNumber(tRawCommand.offset))
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_RegisterLoad,
+          self:__parseRegister(tRawCommand.register, uiCommandCnt),
+          ucFlags,
+          ucO0, ucO1,
+          uiSize
+        ))
 
+      elseif strCmd=='set' or strCmd=='add' then
+        -- Create a new register operation.
+        local atOperations = {
+          set = self.UART_SEQ_REGISTER_OP_Set,
+          add = self.UART_SEQ_REGISTER_OP_Add
+        }
+        local ucV0, ucV1, ucV2, ucV3 = self:__uint32_to_bytes(self:__parseNumber(tRawCommand.value))
         table.insert(astrMacro, string.char(
-          self.UART_SEQ_COMMAND_Send,
-          ucLen0, ucLen1
+          self.UART_SEQ_COMMAND_RegisterOp,
+          self:__parseRegister(tRawCommand.register, uiCommandCnt),
+          atOperations[strCmd],
+          ucV0, ucV1, ucV2, ucV3
         ))
-        table.insert(astrMacro, strData)
+
+      elseif strCmd=='crc_append' or strCmd=='crc_verify' then
+        local atCrc = {
+          modbus = { id=self.UART_SEQ_CRC_Modbus, size=2 },
+          ccitt = { id=self.UART_SEQ_CRC_Ccitt, size=2 },
+          crc32 = { id=self.UART_SEQ_CRC_Crc32, size=4 }
+        }
+        local tCrc = atCrc[tRawCommand.crc]
+        local uiLength = self:__parseNumber(tRawCommand.length)
+        local ucLen0, ucLen1 = self:__uint16_to_bytes(uiLength)
+        if strCmd=='crc_append' then
+          -- Create a new CRC append command.
+          if uiLength<1 or uiLength>self.UART_SEQ_CRC_HistorySize then
+            tLog.error('Command %d appends a CRC over %d bytes, but the netX keeps only the last %d sent bytes.', uiCommandCnt, uiLength, self.UART_SEQ_CRC_HistorySize)
+            error('Invalid length.')
+          end
+          table.insert(astrMacro, string.char(
+            self.UART_SEQ_COMMAND_CrcAppend,
+            tCrc.id,
+            ucLen0, ucLen1
+          ))
+        else
+          -- Create a new CRC verify command.
+          if uiLength<tCrc.size or uiLength>0xffff then
+            tLog.error('Command %d checks a frame with %d bytes, but it must have %d to 65535 bytes.', uiCommandCnt, uiLength, tCrc.size)
+            error('Invalid length.')
+          end
+          local atFlags = {
+            remove = self.UART_SEQ_CRC_FLAG_Remove,
+            stop = self.UART_SEQ_CRC_FLAG_Stop,
+            status = self.UART_SEQ_CRC_FLAG_Status
+          }
+          local atUsedFlags = {}
+          local ucFlags = 0
+          for _, strFlag in ipairs(tRawCommand.flags) do
+            if atUsedFlags[strFlag]==nil then
+              atUsedFlags[strFlag] = true
+              ucFlags = ucFlags + atFlags[strFlag]
+            end
+          end
+          if atUsedFlags.remove==true then
+            uiReadData = math.max(0, uiReadData - tCrc.size)
+          end
+          if atUsedFlags.status==true then
+            uiReadData = uiReadData + 1
+            uiExpectedReadData = math.max(uiExpectedReadData, uiReadData)
+          end
+          table.insert(astrMacro, string.char(
+            self.UART_SEQ_COMMAND_CrcVerify,
+            tCrc.id,
+            ucFlags,
+            ucLen0, ucLen1
+          ))
+        end
 
       elseif strCmd=='baudrate' then
         -- Create a new baudrate command.
-        local ucB0, ucB1, ucB2, ucB3 = self:__uint32_to_bytes(tCmd.baudrate)
+        local ucB0, ucB1, ucB2, ucB3 = self:__uint32_to_bytes(self:__parseNumber(tRawCommand.baudrate))
         table.insert(astrMacro, string.char(
           self.UART_SEQ_COMMAND_BaudRate,
           ucB0, ucB1, ucB2, ucB3
@@ -272,13 +1112,64 @@ function UartNetx:parseMacro(strMacro)
 
       elseif strCmd=='delay' then
         -- Create a new delay command.
-        local ucD0, ucD1, ucD2, ucD3 = self:__uint32_to_bytes(tCmd.delay)
+        local ucD0, ucD1, ucD2, ucD3 = self:__uint32_to_bytes(self:__parseNumber(tRawCommand.delay))
         table.insert(astrMacro, string.char(
           self.UART_SEQ_COMMAND_Delay,
           ucD0, ucD1, ucD2, ucD3
         ))
 
+      elseif strCmd=='delay_us' then
+        -- Create a new delay command in microseconds.
+        local ucD0, ucD1, ucD2, ucD3 = self:__uint32_to_bytes(self:__parseNumber(tRawCommand.delay))
+        table.insert(astrMacro, string.char(
+          self.UART_SEQ_COMMAND_DelayUs,
+          ucD0, ucD1, ucD2, ucD3
+        ))
+
+      end
+    end
+
+    if #atRepeat~=0 then
+      tLog.error('%d repeat blocks have no "end".', #atRepeat)
+      error('Unbalanced repeat block.')
+    end
+
+    -- Complete the jumps. A jump can leave repeat blocks, but it must not
+    -- enter one. A jump back can run the receive commands more often than
+    -- the estimated size of the received data allows.
+    for _, tJump in ipairs(atJumps) do
+      local tLabel = atLabels[tJump.label]
+      if tLabel==nil then
+        tLog.error('Command %d jumps to the unknown label "%s".', tJump.command, tJump.label)
+        error('Unknown label.')
+      end
+      local fEntersBlock = (#tLabel.blocks>#tJump.blocks)
+      for uiCnt, tRepeat in ipairs(tLabel.blocks) do
+        if tRepeat~=tJump.blocks[uiCnt] then
+          fEntersBlock = true
+        end
+      end
+      if fEntersBlock==true then
+        tLog.error('Command %d jumps into a repeat block.', tJump.command)
+        error('Invalid jump.')
+      end
+      local iOffset = tLabel.position - tJump.position
+      if iOffset<-0x8000 or iOffset>0x7fff then
+        tLog.error('Command %d jumps %d bytes, but the maximum is 32767.', tJump.command, math.abs(iOffset))
+        error('Invalid jump.')
+      end
+      if iOffset<0 then
+        tLog.warning('Command %d jumps back. The received data can exceed the estimated size.', tJump.command)
       end
+      local ucO0, ucO1 = self:__uint16_to_bytes(iOffset % 0x10000)
+      local ucLen0, ucLen1 = self:__uint16_to_bytes(tJump.size)
+      astrMacro[tJump.index] = string.char(
+        self.UART_SEQ_COMMAND_JumpIf,
+        tJump.flags,
+        #tJump.blocks - #tLabel.blocks,
+        ucO0, ucO1,
+        ucLen0, ucLen1
+      )
     end
 
     tResult = table.concat(astrMacro)
@@ -289,8 +1180,367 @@ end
 
 
 
-function UartNetx:openDevice(tHandle, uiUart, ulBaudRate, atMMIO, atPortcontrol)
+-- Get the result of a receive until command from the received data.
+-- The header starts at uiOffset, which is 0 for the first byte.
+-- This returns the index of the matching pattern (1 for the first pattern or
+-- nil if no pattern matched), the received data and the offset of the next
+-- data in strData.
+function UartNetx:get_receive_until_result(strData, uiOffset)
+  uiOffset = uiOffset or 0
+  local ucIndex, ucLen0, ucLen1 = string.byte(strData, uiOffset+1, uiOffset+3)
+  local sizData = ucLen0 + 256*ucLen1
+  local uiDataStart = uiOffset + self.UART_SEQ_RECEIVE_UNTIL_HeaderSize
+  local uiPattern
+  if ucIndex~=self.UART_SEQ_RECEIVE_UNTIL_NoMatch then
+    uiPattern = ucIndex + 1
+  end
+
+  return uiPattern, string.sub(strData, uiDataStart+1, uiDataStart+sizData), uiDataStart+sizData
+end
+
+
+
+-- Get the result of a receive_ts command from the received data.
+-- The header starts at uiOffset, which is 0 for the first byte.
+-- This returns the received data, a list with the time in microseconds
+-- since the previous byte for each byte and the offset of the next data in
+-- strData. The first entry is the time since the start of the command.
+function UartNetx:get_receive_timestamps_result(strData, uiOffset)
+  uiOffset = uiOffset or 0
+  local ucLen0, ucLen1 = string.byte(strData, uiOffset+1, uiOffset+2)
+  local sizData = ucLen0 + 256*ucLen1
+  local sizDeltas = self:__bytes_to_uint32(strData, uiOffset+2)
+  local uiDataStart = uiOffset + self.UART_SEQ_RECEIVE_TIMESTAMPS_HeaderSize
+  local uiDeltaStart = uiDataStart + sizData
+  local uiDeltaEnd = uiDeltaStart + sizDeltas
+
+  local aulDeltas = {}
+  local ulDelta = 0
+  local ulFactor = 1
+  for uiPos = uiDeltaStart+1, uiDeltaEnd do
+    local ucData = string.byte(strData, uiPos)
+    ulDelta = ulDelta + (ucData % 0x80) * ulFactor
+    if ucData>=0x80 then
+      ulFactor = ulFactor * 0x80
+    else
+      table.insert(aulDeltas, ulDelta)
+      ulDelta = 0
+      ulFactor = 1
+    end
+  end
+
+  return string.sub(strData, uiDataStart+1, uiDeltaStart), aulDeltas, uiDeltaEnd
+end
+
+
+
+-- Get the result of a BERT command from the received data.
+-- The result starts at uiOffset, which is 0 for the first byte.
+-- This returns a table with the result and the offset of the next data in
+-- strData.
+function UartNetx:get_bert_result(strData, uiOffset)
+  uiOffset = uiOffset or 0
+  local tResult = {
+    bytes_sent = self:__bytes_to_uint32(strData, uiOffset),
+    bytes_received = self:__bytes_to_uint32(strData, uiOffset + 4),
+    byte_errors = self:__bytes_to_uint32(strData, uiOffset + 8),
+    bit_errors = self:__bytes_to_uint32(strData, uiOffset + 12),
+    first_error_offset = self:__bytes_to_uint32(strData, uiOffset + 16),
+    elapsed_ms = self:__bytes_to_uint32(strData, uiOffset + 20)
+  }
+  -- The first error offset is 0xffffffff without errors.
+  if tResult.byte_errors==0 then
+    tResult.first_error_offset = nil
+  end
+
+  return tResult, uiOffset + self.UART_SEQ_BERT_RESULT_SIZE
+end
+
+
+
+-- Get the result of an autobaud command from the received data.
+-- The result starts at uiOffset, which is 0 for the first byte.
+-- This returns a table with the measured baud rate, the baud rate which is
+-- used now and the offset of the next data in strData.
+function UartNetx:get_autobaud_result(strData, uiOffset)
+  uiOffset = uiOffset or 0
+  local tResult = {
+    measured = self:__bytes_to_uint32(strData, uiOffset),
+    baudrate = self:__bytes_to_uint32(strData, uiOffset + 4)
+  }
+
+  return tResult, uiOffset + self.UART_SEQ_AUTOBAUD_RESULT_SIZE
+end
+
+
+
+-- Get the result of a benchmark command from the received data.
+-- The result starts at uiOffset, which is 0 for the first byte.
+-- This returns a table with the result and the offset of the next data in
+-- strData. The busy ticks are CPU cycles, so "cycles_per_byte" is the time
+-- which the firmware needs for one byte in both directions.
+function UartNetx:get_benchmark_result(strData, uiOffset)
+  uiOffset = uiOffset or 0
+  local tResult = {
+    bytes_sent = self:__bytes_to_uint32(strData, uiOffset),
+    bytes_received = self:__bytes_to_uint32(strData, uiOffset + 4),
+    byte_errors = self:__bytes_to_uint32(strData, uiOffset + 8),
+    elapsed_us = self:__bytes_to_uint32(strData, uiOffset + 12),
+    busy_ticks = self:__bytes_to_uint32(strData, uiOffset + 16),
+    polls = self:__bytes_to_uint32(strData, uiOffset + 20),
+    max_rx_fill = self:__bytes_to_uint32(strData, uiOffset + 24)
+  }
+  if tResult.elapsed_us~=0 then
+    tResult.bytes_per_second = tResult.bytes_received * 1000000 / tResult.elapsed_us
+  end
+  if tResult.bytes_received~=0 then
+    tResult.cycles_per_byte = tResult.busy_ticks / tResult.bytes_received
+  end
+
+  return tResult, uiOffset + self.UART_SEQ_BENCHMARK_RESULT_SIZE
+end
+
+
+
+-- Get the result of a baud sweep command from the received data.
+-- The header starts at uiOffset, which is 0 for the first byte.
+-- This returns a list with one entry for each divider and the offset of the
+-- next data in strData. The entries are in the order of the sweep.
+function UartNetx:get_baud_sweep_result(strData, uiOffset)
+  uiOffset = uiOffset or 0
+  local ucCnt0, ucCnt1 = string.byte(strData, uiOffset+1, uiOffset+2)
+  local uiRecords = ucCnt0 + 256*ucCnt1
+  local atResult = {}
+
+  uiOffset = uiOffset + self.UART_SEQ_BAUD_SWEEP_HeaderSize
+  for uiCnt = 1, uiRecords do
+    local ucD0, ucD1, ucR0, ucR1, ucE0, ucE1, ucB0, ucB1 = string.byte(strData, uiOffset+1, uiOffset+8)
+    local usDivider = ucD0 + 256*ucD1
+    table.insert(atResult, {
+      divider = usDivider,
+      -- This is the real baud rate for a device frequency of 100MHz.
+      baudrate = math.floor(usDivider * 100000000 / 1048576 + 0.5),
+      bytes_received = ucR0 + 256*ucR1,
+      byte_errors = ucE0 + 256*ucE1,
+      bit_errors = ucB0 + 256*ucB1
+    })
+    uiOffset = uiOffset + self.UART_SEQ_BAUD_SWEEP_RECORD_SIZE
+  end
+
+  return atResult, uiOffset
+end
+
+
+
+-- Get the real baud rate of the UART for a requested baud rate. This is
+-- the same calculation as on the netX. It can be used to check a baud rate
+-- before a test runs with it.
+-- The function returns the real baud rate, its error in ppm and the divider
+-- for the "baudsweep" command, or nil if the UART can not use the baud rate
+-- at all.
+function UartNetx:get_baudrate_error(ulBaudRate)
+  local ulAchievedBaudRate
+  local lErrorPpm
+  local ulValidDivider
+
+  -- This is the divider for a device frequency of 100MHz.
+  local ulDivider = math.floor((ulBaudRate * 16 * 65536 + 50000000) / 100000000)
+  if ulDivider>0 and ulDivider<=0xffff then
+    ulValidDivider = ulDivider
+    ulAchievedBaudRate = math.floor(ulDivider * 100000000 / 1048576 + 0.5)
+    local fError = (ulDivider * 100000000 / 1048576 - ulBaudRate) * 1000000 / ulBaudRate
+    if fError<0 then
+      lErrorPpm = math.ceil(fError)
+    else
+      lErrorPpm = math.floor(fError)
+    end
+  end
+
+  return ulAchievedBaudRate, lErrorPpm, ulValidDivider
+end
+
+
+
+function UartNetx:__setup_layout(tHandle)
+  local aAttr = tHandle.attr
+
+  -- Setup a basic layout of the buffer:
+  --   * Parameter (fixed size: 12 bytes header and UART_PARAMETER_SIZE
+  --     bytes, but at least 64 bytes)
+  --   * Mailbox for the server mode (fixed size: UART_MAILBOX_SIZE bytes)
+  --   * Handles (fixed size: UART_HANDLE_SLOTS * UART_HANDLE_SIZE bytes)
+  --   * Trace (fixed size: UART_TRACE_SIZE bytes)
+  --   * RX/TX buffer
+  local sizParameter = math.max(64, 0x0c + self.UART_PARAMETER_SIZE)
+  tHandle.ulMailboxAddress = aAttr.ulParameterStartAddress + sizParameter
+  tHandle.ulHandleSlotsAddress = tHandle.ulMailboxAddress + self.UART_MAILBOX_SIZE
+  tHandle.ulTraceAddress = tHandle.ulHandleSlotsAddress + self.UART_HANDLE_SLOTS * self.UART_HANDLE_SIZE
+  tHandle.ulBufferAddress = tHandle.ulTraceAddress + self.UART_TRACE_SIZE
+end
+
+
+
+-- Get the verbose parameter for the netX. An explicit setting for one
+-- call overrides the setting of the handle. The default is no output, as
+-- the messages of the netX are much slower than the UART.
+function UartNetx:__get_verbose(tHandle, fVerbose)
+  if fVerbose==nil then
+    fVerbose = tHandle.fVerbose
+  end
+
+  local ulVerbose = 0x00000000
+  if fVerbose==true then
+    ulVerbose = 0xffffffff
+  end
+
+  return ulVerbose
+end
+
+
+
+-- Run one request of the server. The function waits up to the timeout of
+-- "startServer" for the acknowledge. On a timeout it returns nil and a
+-- parameter with only zeros.
+function UartNetx:__mailbox_execute(tHandle, strParameter)
+  local tLog = self.tLog
+  local tester = _G.tester
+  local tPlugin = tHandle.plugin
+  local ulMailboxAddress = tHandle.ulMailboxAddress
+
+  -- The mailbox has an acknowledge and a result field in front of the
+  -- parameter and the request counter after it.
+  local sizParameter = self.UART_MAILBOX_SIZE - 12
+  strParameter = strParameter .. string.rep(string.char(0), sizParameter - string.len(strParameter))
+
+  -- Write the parameter and the new request counter with one access. The
+  -- request counter is the last field, so the netX sees the complete
+  -- parameter as soon as the counter changes.
+  local ulRequest = (tHandle.ulServerRequest + 1) % 0x100000000
+  tHandle.ulServerRequest = ulRequest
+  tester:stdWrite(tPlugin, ulMailboxAddress + 8, strParameter .. self:__uint32_list_to_string{ ulRequest })
+
+  -- Poll until the netX acknowledges the request. The clock has a resolution
+  -- of 1 second.
+  local tStart = os.time()
+  local strMailbox
+  repeat
+    strMailbox = tester:stdRead(tPlugin, ulMailboxAddress, self.UART_MAILBOX_SIZE)
+    if self:__bytes_to_uint32(strMailbox, 0)==ulRequest then
+      break
+    elseif os.difftime(os.time(), tStart)>tHandle.ulServerTimeout then
+      tLog.error('The server did not acknowledge request %d in %d seconds.', ulRequest, tHandle.ulServerTimeout)
+      return nil, string.rep(string.char(0), sizParameter)
+    end
+  until false
+
+  local ulResult = self:__bytes_to_uint32(strMailbox, 4)
+  return ulResult, string.sub(strMailbox, 9, 8 + sizParameter)
+end
+
+
+
+-- Start the server on the netX. All following commands of the handle are
+-- requests to the server until "stopServer" is called.
+-- The netX runs the server while the host accesses the memory for the
+-- requests. This works only with a debug port, so the plugin must be a JTAG
+-- or DPM romloader. The UART, USB and Ethernet romloaders can not access the
+-- memory while the netX runs code.
+-- The messages of the netX are not collected while the server runs. All
+-- requests run without verbose output, and the verbose settings of the
+-- handle and of the options are ignored.
+-- The optional table tOptions can have these fields:
+--   * timeout: a request fails if the netX does not acknowledge it in this
+--     number of seconds. The default is 10. This must include the time of
+--     the longest sequence.
+function UartNetx:startServer(tHandle, tOptions)
+  local tLog = self.tLog
+  local tester = _G.tester
+  local aAttr = tHandle.attr
+
+  tOptions = tOptions or {}
+  local atDebugPortPlugins = {
+    ['romloader_jtag'] = true,
+    ['romloader_dpm'] = true
+  }
+
+  local tPlugin = tHandle.plugin
+  if tPlugin==nil then
+    tLog.error('The handle has no "plugin" set.')
+    error('The handle has no "plugin" set.')
+  elseif tHandle.fServer==true then
+    tLog.debug('The server is already running.')
+  elseif atDebugPortPlugins[tPlugin:GetTyp()]~=true then
+    local strMsg = string.format('The server needs a JTAG or DPM connection, but the plugin has the type "%s".', tPlugin:GetTyp())
+    tLog.error(strMsg)
+    error(strMsg)
+  else
+    self:__setup_layout(tHandle)
+    tHandle.ulServerTimeout = tOptions.timeout or 10
+
+    -- Clear the mailbox. The acknowledge and the request counter start at 0.
+    tester:stdWrite(tPlugin, tHandle.ulMailboxAddress, string.rep(string.char(0), self.UART_MAILBOX_SIZE))
+    tHandle.ulServerRequest = 0
+
+    -- Start the server without waiting for it. The netX keeps running until
+    -- "stopServer" is called. Its messages are not collected in the
+    -- meantime, so the server runs without verbose output.
+    local aParameter = {
+      0x00000000,    -- verbose
+      self.UART_CMD_Serve,
+      tHandle.ulMailboxAddress
+    }
+    tester:mbin_set_parameter(tPlugin, aAttr, aParameter)
+    tPlugin:call_no_answer(aAttr.ulExecAddress, aAttr.ulParameterStartAddress, tester.callback, 2)
+
+    tHandle.fServer = true
+  end
+end
+
+
+
+function UartNetx:stopServer(tHandle)
+  local tLog = self.tLog
+
+  if tHandle.fServer==true then
+    local ulValue = self:__mailbox_execute(tHandle, self:__uint32_list_to_string{
+      0x00000000,    -- verbose
+      self.UART_CMD_Serve
+    })
+    tHandle.fServer = false
+    if ulValue~=0 then
+      tLog.error('Failed to stop the server.')
+      error('Failed to stop the server.')
+    end
+  end
+end
+
+
+
+-- Open a UART unit.
+-- The optional table tOptions can have these fields:
+--   * verbose: print messages on the netX for all following commands
+--   * trace: start a new trace, which can be read with "read_trace"
+--   * max_error_ppm: reject the baud rate if the real baud rate deviates
+--     more than this. The limit is also used for all baudrate commands.
+--   * flow_control: the transmitter waits while the CTS input is inactive.
+--     The pin must be set up in atMMIO. The netX UART can not control RTS
+--     with the fill level of the RX FIFO, so RTS is not used.
+--   * cts_timeout: a send command fails if CTS stops the transmitter for
+--     this number of milliseconds. The default is 1000.
+--   * rx_errors: the action for each receive error. This is a table with
+--     the optional fields "overrun", "framing", "parity" and "line_break".
+--     The actions are "continue" (the default), "mark" and "stop". The netX
+--     checks the errors once for each burst of received bytes and counts
+--     each error type once per burst. "mark" also stores the offset of the
+--     first burst with an error in the receive data. "stop" does the same
+--     and lets the command fail.
+--   * loopback: connect TX with RX inside the UART. This is for the
+--     "benchmark" command without a DUT. A wire from TX to RX works the
+--     same way without this option.
+-- The function returns the real baud rate and its error in ppm.
+function UartNetx:openDevice(tHandle, uiUart, ulBaudRate, atMMIO, atPortcontrol, tOptions)
   ulBaudRate = ulBaudRate or 115200
+  tOptions = tOptions or {}
   atMMIO = atMMIO or {}
   atPortcontrol = atPortcontrol or {}
   ucMMIO_RX = atMMIO.RX or 0xff
@@ -306,12 +1556,52 @@ function UartNetx:openDevice(tHandle, uiUart, ulBaudRate, atMMIO, atPortcontrol)
   local tester = _G.tester
   local aAttr = tHandle.attr
 
-  -- Setup a basic layout of the buffer:
-  --   * Parameter (fixed size: 64 bytes)
-  --   * Handle (fixed size: UART_HANDLE_SIZE bytes)
-  --   * RX/TX buffer
-  tHandle.ulHandleAddress = aAttr.ulParameterStartAddress + 64
-  tHandle.ulBufferAddress = aAttr.ulParameterStartAddress + 64 + self.UART_HANDLE_SIZE
+  self:__setup_layout(tHandle)
+  tHandle.fVerbose = (tOptions.verbose==true)
+
+  -- Use the complete trace buffer or keep the current trace.
+  local ulTraceAddress = 0
+  local sizTrace = 0
+  if tOptions.trace==true then
+    ulTraceAddress = tHandle.ulTraceAddress
+    sizTrace = self.UART_TRACE_SIZE
+  end
+
+  -- The hardware handshake needs a timeout for the transmitter.
+  local ulFlowControl = 0
+  local ulTimeoutCtsMs = 0
+  if tOptions.flow_control==true then
+    ulFlowControl = self.UART_FLOW_CONTROL_Cts
+    ulTimeoutCtsMs = tOptions.cts_timeout or 1000
+    if ulTimeoutCtsMs<1 or ulTimeoutCtsMs>0xffffffff then
+      tLog.error('The CTS timeout must be between 1 and 0xffffffff, but it is %d.', ulTimeoutCtsMs)
+      error('Invalid CTS timeout.')
+    end
+  end
+
+  -- Each receive error has one byte with its action.
+  local atRxErrorActions = {
+    ['continue'] = self.UART_RX_ERROR_ACTION_Continue,
+    ['mark'] = self.UART_RX_ERROR_ACTION_Mark,
+    ['stop'] = self.UART_RX_ERROR_ACTION_Stop
+  }
+  local atRxErrors = {
+    overrun = self.UART_RX_ERROR_Overrun,
+    framing = self.UART_RX_ERROR_Framing,
+    parity = self.UART_RX_ERROR_Parity,
+    line_break = self.UART_RX_ERROR_Break
+  }
+  local ulRxErrorActions = 0
+  for strError, strAction in pairs(tOptions.rx_errors or {}) do
+    local uiError = atRxErrors[strError]
+    local ucAction = atRxErrorActions[strAction]
+    if uiError==nil or ucAction==nil then
+      local strMsg = string.format('Invalid receive error action: %s = %s', tostring(strError), tostring(strAction))
+      tLog.error(strMsg)
+      error(strMsg)
+    end
+    ulRxErrorActions = ulRxErrorActions + ucAction * math.pow(256, uiError)
+  end
 
   -- Combine all options.
   local ucC0, ucC1, ucC2, ucC3 = self:__uint32_to_bytes(uiUart)
@@ -331,42 +1621,101 @@ function UartNetx:openDevice(tHandle, uiUart, ulBaudRate, atMMIO, atPortcontrol)
     ucPTX0, ucPTX1,
     ucPRTS0, ucPRTS1,
     ucPCTS0, ucPCTS1
-  )
+  ) .. self:__uint32_list_to_string{
+    ulTraceAddress,
+    sizTrace,
+    ulFlowControl,
+    ulTimeoutCtsMs,
+    ulRxErrorActions,
+    (tOptions.loopback==true) and 1 or 0,
+    tOptions.max_error_ppm or 0,
+    0,
+    0
+  }
 
+  -- Each UART unit has its own handle on the netX. The last opened unit is
+  -- used by "run_sequence" and "closeDevice".
+  if uiUart>=self.UART_HANDLE_SLOTS then
+    local strMsg = string.format('The UART unit %d is out of range.', uiUart)
+    tLog.error(strMsg)
+    error(strMsg)
+  end
+  tHandle.ulHandleAddress = tHandle.ulHandleSlotsAddress + uiUart * self.UART_HANDLE_SIZE
+
+  local ulAchievedBaudRate
+  local lErrorPpm
   local tPlugin = tHandle.plugin
   if tPlugin==nil then
     tLog.error('The handle has no "plugin" set.')
   else
-    -- Run the command.
-    local aParameter = {
-      0xffffffff,    -- verbose
-      self.UART_CMD_Open,
-      tHandle.ulHandleAddress
-    }
-    tester:mbin_set_parameter(tPlugin, aAttr, aParameter)
-    -- Append the options.
-    tester:stdWrite(tPlugin, aAttr.ulParameterStartAddress+0x18, strOptions)
-
-    ulValue = tester:mbin_execute(tPlugin, aAttr, aParameter)
+    local ulValue
+    -- The real baud rate and its error are the last fields of the options.
+    local uiResultOffset = string.len(strOptions) - 8
+    local strResult
+    if tHandle.fServer==true then
+      local strParameter
+      ulValue, strParameter = self:__mailbox_execute(tHandle, self:__uint32_list_to_string{
+        0x00000000,    -- verbose
+        self.UART_CMD_Open,
+        tHandle.ulHandleAddress
+      } .. strOptions)
+      strResult = string.sub(strParameter, 13 + uiResultOffset, 20 + uiResultOffset)
+    else
+      -- Run the command.
+      local aParameter = {
+        self:__get_verbose(tHandle),
+        self.UART_CMD_Open,
+        tHandle.ulHandleAddress
+      }
+      tester:mbin_set_parameter(tPlugin, aAttr, aParameter)
+      -- Append the options.
+      tester:stdWrite(tPlugin, aAttr.ulParameterStartAddress+0x18, strOptions)
+
+      ulValue = tester:mbin_execute(tPlugin, aAttr, aParameter)
+      strResult = tester:stdRead(tPlugin, aAttr.ulParameterStartAddress+0x18+uiResultOffset, 8)
+    end
+    ulAchievedBaudRate = self:__bytes_to_uint32(strResult, 0)
+    lErrorPpm = self:__uint32_to_int32(self:__bytes_to_uint32(strResult, 4))
     if ulValue~=0 then
-      tLog.error('Failed to open the device.')
-      error('Failed to open the device.')
+      local strMsg = string.format('Failed to open the device with %d baud. The real baud rate is %d with an error of %d ppm.', ulBaudRate, ulAchievedBaudRate, lErrorPpm)
+      tLog.error(strMsg)
+      error(strMsg)
     end
   end
+
+  return ulAchievedBaudRate, lErrorPpm
 end
 
 
 
-function UartNetx:run_sequence(tHandle, strSequence, sizExpectedRxData)
+-- Run a sequence on the last opened UART.
+-- The optional table tOptions can have these fields:
+--   * telemetry: record the first N executed commands. The records are
+--     returned in the "telemetry" field of the status, also for a failed
+--     sequence.
+--   * verbose: print messages on the netX for this sequence. This overrides
+--     the setting of "openDevice".
+-- The status has the real baud rate at the end of the sequence in the field
+-- "baudrate". It is a table with the fields "achieved" and "error_ppm".
+-- The receive errors are in the field "rx_errors" (see "__get_rx_errors").
+function UartNetx:run_sequence(tHandle, strSequence, sizExpectedRxData, tOptions)
   local tLog = self.tLog
   local tester = _G.tester
   local tResult
+  -- The status has the results of all compare operations on the netX.
+  local tStatus = {}
 
   local aAttr = tHandle.attr
 
+  -- The telemetry records are at the end of the receive buffer.
+  tOptions = tOptions or {}
+  local uiTelemetryMax = tOptions.telemetry or 0
+  local sizTelemetry = uiTelemetryMax * self.UART_SEQ_TELEMETRY_RECORD_SIZE
+
   local sizTxBuffer = string.len(strSequence)
   local pucTxBuffer = tHandle.ulBufferAddress
   local pucRxBuffer = tHandle.ulBufferAddress + sizTxBuffer
+  local uiTelemetryRecords
 
   local tPlugin = tHandle.plugin
   if tPlugin==nil then
@@ -375,24 +1724,90 @@ function UartNetx:run_sequence(tHandle, strSequence, sizExpectedRxData)
     -- Download the sequence data.
     tester:stdWrite(tPlugin, pucTxBuffer, strSequence)
 
-    -- Run the command.
-    local aParameter = {
-      0xffffffff,    -- verbose
-      self.UART_CMD_RunSequence,
-      tHandle.ulHandleAddress,
-      pucTxBuffer,
-      sizTxBuffer,
-      pucRxBuffer,
-      sizExpectedRxData,
-      'OUTPUT'
-    }
-    tester:mbin_set_parameter(tPlugin, aAttr, aParameter)
-    ulValue = tester:mbin_execute(tPlugin, aAttr, aParameter)
+    local ulValue
+    local sizResultData
+    if tHandle.fServer==true then
+      local strParameter
+      ulValue, strParameter = self:__mailbox_execute(tHandle, self:__uint32_list_to_string{
+        0x00000000,    -- verbose
+        self.UART_CMD_RunSequence,
+        tHandle.ulHandleAddress,
+        pucTxBuffer,
+        sizTxBuffer,
+        pucRxBuffer,
+        sizExpectedRxData + sizTelemetry,
+        0,
+        0,
+        0,
+        uiTelemetryMax,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0
+      })
+      -- Get the output parameters from the mailbox.
+      sizResultData = self:__bytes_to_uint32(strParameter, 28)
+      tStatus.expect_mismatches = self:__bytes_to_uint32(strParameter, 32)
+      tStatus.expect_first_mismatch = self:__bytes_to_uint32(strParameter, 36)
+      uiTelemetryRecords = self:__bytes_to_uint32(strParameter, 44)
+      tStatus.baudrate = {
+        achieved = self:__bytes_to_uint32(strParameter, 48),
+        error_ppm = self:__uint32_to_int32(self:__bytes_to_uint32(strParameter, 52))
+      }
+      tStatus.rx_errors = self:__get_rx_errors(strParameter, 56)
+    else
+      -- Run the command.
+      local aParameter = {
+        self:__get_verbose(tHandle, tOptions.verbose),
+        self.UART_CMD_RunSequence,
+        tHandle.ulHandleAddress,
+        pucTxBuffer,
+        sizTxBuffer,
+        pucRxBuffer,
+        sizExpectedRxData + sizTelemetry,
+        'OUTPUT',
+        'OUTPUT',
+        'OUTPUT',
+        uiTelemetryMax,
+        'OUTPUT',
+        'OUTPUT',
+        'OUTPUT',
+        'OUTPUT',
+        'OUTPUT',
+        'OUTPUT',
+        'OUTPUT',
+        'OUTPUT'
+      }
+      tester:mbin_set_parameter(tPlugin, aAttr, aParameter)
+      ulValue = tester:mbin_execute(tPlugin, aAttr, aParameter)
+      -- Get the output parameters.
+      sizResultData = aParameter[8]
+      tStatus.expect_mismatches = aParameter[9]
+      tStatus.expect_first_mismatch = aParameter[10]
+      uiTelemetryRecords = aParameter[12]
+      tStatus.baudrate = {
+        achieved = aParameter[13],
+        error_ppm = self:__uint32_to_int32(aParameter[14])
+      }
+      tStatus.rx_errors = self:__get_rx_errors(self:__uint32_list_to_string{
+        aParameter[15],
+        aParameter[16],
+        aParameter[17],
+        aParameter[18],
+        aParameter[19]
+      }, 0)
+    end
+    if uiTelemetryMax~=0 then
+      tStatus.telemetry = self:__read_telemetry(tHandle, pucRxBuffer + sizExpectedRxData, math.min(uiTelemetryRecords, uiTelemetryMax))
+      tStatus.telemetry_dropped = uiTelemetryRecords - #tStatus.telemetry
+    end
     if ulValue~=0 then
       tLog.error('Failed to run the sequence.')
     else
-      -- Get the size of the result data from the output parameter.
-      local sizResultData = aParameter[7]
       tLog.debug('The netX reports %d bytes of result data.', sizResultData)
 
       -- Read the result data.
@@ -401,29 +1816,291 @@ function UartNetx:run_sequence(tHandle, strSequence, sizExpectedRxData)
     end
   end
 
-  return tResult
+  return tResult, tStatus
 end
 
 
 
-function UartNetx:closeDevice(tHandle)
+-- Run one sequence on each of several opened UART units at the same time.
+-- Each entry of atRuns is a table with these fields:
+--   * uart: the UART unit, which must be opened with "openDevice"
+--   * sequence: the sequence from "parseMacro"
+--   * rx_size: the expected size of the result data
+-- The function returns a list with one result and one status for each entry.
+-- The result is nil if the sequence failed.
+-- Only send, receive, receive_us, receive_until, receive_idle, transceive,
+-- delay, delay_us, baudrate, clean, expect, repeat blocks, jumps, load, set,
+-- add and crc_verify are supported in this mode. A send with registers, the
+-- generated sends and crc_append are not supported. No sequence is started
+-- if one of them has an unsupported command.
+function UartNetx:run_sequences(tHandle, atRuns)
   local tLog = self.tLog
   local tester = _G.tester
+  local atResults = {}
+
   local aAttr = tHandle.attr
 
+  -- The table with the parameters for all sequences is the first element
+  -- in the buffer. The sequences and receive buffers follow.
+  local sizTable = #atRuns * self.UART_RUN_SEQUENCE_SIZE
+  local pucTable = tHandle.ulBufferAddress
+  local ulAddress = pucTable + sizTable
+  local astrTable = {}
+  local astrSequences = {}
+  local apucRxBuffer = {}
+  for uiCnt, tRun in ipairs(atRuns) do
+    local strSequence = tRun.sequence
+    local sizTxBuffer = string.len(strSequence)
+    local pucTxBuffer = ulAddress
+    local pucRxBuffer = pucTxBuffer + sizTxBuffer
+    -- Keep the next sequence aligned to a DWORD.
+    ulAddress = pucRxBuffer + tRun.rx_size
+    ulAddress = ulAddress + ((4 - (ulAddress % 4)) % 4)
+
+    table.insert(astrTable, self:__uint32_list_to_string{
+      tHandle.ulHandleSlotsAddress + tRun.uart * self.UART_HANDLE_SIZE,
+      pucTxBuffer,
+      sizTxBuffer,
+      pucRxBuffer,
+      tRun.rx_size,
+      0xffffffff,    -- The netX sets the size only for a successful sequence.
+      0,
+      0,
+      0,
+      0,
+      0,
+      0,
+      0,
+      0,
+      0,
+      0,
+      0
+    })
+    table.insert(astrSequences, { pucTxBuffer, strSequence })
+    apucRxBuffer[uiCnt] = pucRxBuffer
+  end
+
   local tPlugin = tHandle.plugin
   if tPlugin==nil then
     tLog.error('The handle has no "plugin" set.')
   else
-    -- Run the command.
-    local aParameter = {
-      0xffffffff,    -- verbose
-      self.UART_CMD_Close,
-      tHandle.ulHandleAddress
-    }
-    tester:mbin_set_parameter(tPlugin, aAttr, aParameter)
+    -- Download the table and all sequences.
+    tester:stdWrite(tPlugin, pucTable, table.concat(astrTable))
+    for _, tSequence in ipairs(astrSequences) do
+      tester:stdWrite(tPlugin, tSequence[1], tSequence[2])
+    end
+
+    local ulValue
+    if tHandle.fServer==true then
+      ulValue = self:__mailbox_execute(tHandle, self:__uint32_list_to_string{
+        0x00000000,    -- verbose
+        self.UART_CMD_RunSequences,
+        #atRuns,
+        pucTable
+      })
+    else
+      -- Run the command.
+      local aParameter = {
+        self:__get_verbose(tHandle),
+        self.UART_CMD_RunSequences,
+        #atRuns,
+        pucTable
+      }
+      tester:mbin_set_parameter(tPlugin, aAttr, aParameter)
+      ulValue = tester:mbin_execute(tPlugin, aAttr, aParameter)
+    end
+    if ulValue~=0 then
+      tLog.error('Failed to run the sequences.')
+    end
+
+    -- Each sequence has its own result, even if another one failed.
+    local strTable = tester:stdRead(tPlugin, pucTable, sizTable)
+    for uiCnt, tRun in ipairs(atRuns) do
+      local uiOffset = (uiCnt - 1) * self.UART_RUN_SEQUENCE_SIZE
+      local tStatus = {
+        expect_mismatches = self:__bytes_to_uint32(strTable, uiOffset + 24),
+        expect_first_mismatch = self:__bytes_to_uint32(strTable, uiOffset + 28),
+        baudrate = {
+          achieved = self:__bytes_to_uint32(strTable, uiOffset + 40),
+          error_ppm = self:__uint32_to_int32(self:__bytes_to_uint32(strTable, uiOffset + 44))
+        },
+        rx_errors = self:__get_rx_errors(strTable, uiOffset + 48)
+      }
+      local tResult
+      local sizResultData = self:__bytes_to_uint32(strTable, uiOffset + 20)
+      if sizResultData~=0xffffffff then
+        tResult = tester:stdRead(tPlugin, apucRxBuffer[uiCnt], sizResultData)
+      end
+      atResults[uiCnt] = { result=tResult, status=tStatus }
+    end
+  end
+
+  return atResults
+end
+
+
+
+-- Decode the receive error counters of a sequence result. The table has the
+-- counters "overrun", "framing", "parity" and "line_break". They count the
+-- bursts with the error. The field "first_offset" is the offset of the
+-- first burst with a marked error in the receive data. It is nil if no
+-- error was marked.
+function UartNetx:__get_rx_errors(strData, uiOffset)
+  local ulFirstOffset = self:__bytes_to_uint32(strData, uiOffset + 16)
+  if ulFirstOffset==0xffffffff then
+    ulFirstOffset = nil
+  end
+
+  return {
+    overrun = self:__bytes_to_uint32(strData, uiOffset + 4 * self.UART_RX_ERROR_Overrun),
+    framing = self:__bytes_to_uint32(strData, uiOffset + 4 * self.UART_RX_ERROR_Framing),
+    parity = self:__bytes_to_uint32(strData, uiOffset + 4 * self.UART_RX_ERROR_Parity),
+    line_break = self:__bytes_to_uint32(strData, uiOffset + 4 * self.UART_RX_ERROR_Break),
+    first_offset = ulFirstOffset
+  }
+end
+
+
+
+-- Read and decode the telemetry records from the netX.
+function UartNetx:__read_telemetry(tHandle, pucTelemetry, uiRecords)
+  local tester = _G.tester
+  local atTelemetry = {}
+
+  if uiRecords~=0 then
+    local sizRecord = self.UART_SEQ_TELEMETRY_RECORD_SIZE
+    local strTelemetry = tester:stdRead(tHandle.plugin, pucTelemetry, uiRecords * sizRecord)
+    for uiCnt = 0, uiRecords - 1 do
+      local uiOffset = uiCnt * sizRecord
+      local ucCommand, ucStatus = string.byte(strTelemetry, uiOffset+1, uiOffset+2)
+      local tRecord = {
+        command = ucCommand,
+        ok = (ucStatus==0),
+        bytes = self:__bytes_to_uint32(strTelemetry, uiOffset + 4),
+        ticks = self:__bytes_to_uint32(strTelemetry, uiOffset + 8),
+        polls = self:__bytes_to_uint32(strTelemetry, uiOffset + 12)
+      }
+      if tHandle.ulTicksPerUs~=nil then
+        tRecord.elapsed_us = tRecord.ticks / tHandle.ulTicksPerUs
+      end
+      table.insert(atTelemetry, tRecord)
+    end
+  end
+
+  return atTelemetry
+end
+
+
+
+-- Read the trace from the netX.
+-- This returns a list of all entries in the trace buffer, starting with the
+-- oldest one. The number of overwritten entries is the second return value.
+function UartNetx:read_trace(tHandle)
+  local tester = _G.tester
+  local atTrace = {}
+  local ulLost = 0
+
+  local tPlugin = tHandle.plugin
+  local strHeader = tester:stdRead(tPlugin, tHandle.ulTraceAddress, self.UART_TRACE_HEADER_SIZE)
+  local ulWriteCount = self:__bytes_to_uint32(strHeader, 0)
+  local ulEntries = self:__bytes_to_uint32(strHeader, 4)
+  if ulEntries~=0 and ulEntries*self.UART_TRACE_ENTRY_SIZE<=self.UART_TRACE_SIZE then
+    local strEntries = tester:stdRead(tPlugin, tHandle.ulTraceAddress + self.UART_TRACE_HEADER_SIZE, ulEntries * self.UART_TRACE_ENTRY_SIZE)
+    local ulFirst = 0
+    if ulWriteCount>ulEntries then
+      ulFirst = ulWriteCount - ulEntries
+      ulLost = ulFirst
+    end
+    for ulCnt = ulFirst, ulWriteCount - 1 do
+      local uiOffset = (ulCnt % ulEntries) * self.UART_TRACE_ENTRY_SIZE
+      local ucEvent, ucUart, ucP0, ucP1 = string.byte(strEntries, uiOffset+1, uiOffset+4)
+      table.insert(atTrace, {
+        event = ucEvent,
+        uart = ucUart,
+        parameter = ucP0 + 256*ucP1,
+        value = self:__bytes_to_uint32(strEntries, uiOffset + 4),
+        ticks = self:__bytes_to_uint32(strEntries, uiOffset + 8)
+      })
+    end
+  end
+
+  return atTrace, ulLost
+end
+
+
 
-    ulValue = tester:mbin_execute(tPlugin, aAttr, aParameter)
+-- Convert the trace from "read_trace" to text.
+function UartNetx:format_trace(tHandle, atTrace)
+  local astrEvents = {
+    [self.UART_TRACE_EVENT_SequenceStart] = 'sequence start, %d bytes',
+    [self.UART_TRACE_EVENT_SequenceEnd] = 'sequence end, status %d, %d bytes received',
+    [self.UART_TRACE_EVENT_CommandStart] = 'command %d at offset %d',
+    [self.UART_TRACE_EVENT_CommandEnd] = 'command end, status %d, %d bytes',
+    [self.UART_TRACE_EVENT_TimeoutTotal] = 'command %d: total timeout after %d bytes',
+    [self.UART_TRACE_EVENT_TimeoutChar] = 'command %d: char timeout after %d bytes',
+    [self.UART_TRACE_EVENT_RxError] = 'receive error 0x%02x at offset %d'
+  }
+
+  local astrLines = {}
+  local ulTicksStart
+  for _, tEntry in ipairs(atTrace) do
+    ulTicksStart = ulTicksStart or tEntry.ticks
+    -- The ticks are a 32 bit counter which wraps around.
+    local ulTicks = (tEntry.ticks - ulTicksStart) % 0x100000000
+    local strTime
+    if tHandle.ulTicksPerUs~=nil then
+      strTime = string.format('%12.1fus', ulTicks / tHandle.ulTicksPerUs)
+    else
+      strTime = string.format('%12d ticks', ulTicks)
+    end
+
+    local strText
+    local strFormat = astrEvents[tEntry.event]
+    if strFormat==nil then
+      strText = string.format('unknown event %d: 0x%04x 0x%08x', tEntry.event, tEntry.parameter, tEntry.value)
+    elseif tEntry.event==self.UART_TRACE_EVENT_SequenceStart then
+      strText = string.format(strFormat, tEntry.value)
+    elseif tEntry.event==self.UART_TRACE_EVENT_CommandEnd then
+      strText = string.format(strFormat, math.floor(tEntry.parameter / 256), tEntry.value)
+    else
+      strText = string.format(strFormat, tEntry.parameter, tEntry.value)
+    end
+
+    table.insert(astrLines, string.format('%s UART%d %s', strTime, tEntry.uart, strText))
+  end
+
+  return table.concat(astrLines, '\n')
+end
+
+
+
+function UartNetx:closeDevice(tHandle)
+  local tLog = self.tLog
+  local tester = _G.tester
+  local aAttr = tHandle.attr
+
+  local tPlugin = tHandle.plugin
+  if tPlugin==nil then
+    tLog.error('The handle has no "plugin" set.')
+  else
+    local ulValue
+    if tHandle.fServer==true then
+      ulValue = self:__mailbox_execute(tHandle, self:__uint32_list_to_string{
+        0x00000000,    -- verbose
+        self.UART_CMD_Close,
+        tHandle.ulHandleAddress
+      })
+    else
+      -- Run the command.
+      local aParameter = {
+        self:__get_verbose(tHandle),
+        self.UART_CMD_Close,
+        tHandle.ulHandleAddress
+      }
+      tester:mbin_set_parameter(tPlugin, aAttr, aParameter)
+
+      ulValue = tester:mbin_execute(tPlugin, aAttr, aParameter)
+    end
     if ulValue~=0 then
       tLog.error('Failed to close the device.')
       error('Failed to close the device.')
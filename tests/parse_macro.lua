@@ -0,0 +1,93 @@
+-- Check the jump offsets of "parseMacro".
+--
+-- This needs the generated module from "targets/lua" and the Lua modules
+-- "pl" and "lpeglabel". Run it in the project folder after the build:
+--   lua tests/parse_macro.lua
+
+package.path = 'targets/lua/?.lua;' .. package.path
+-- The tests do not access a netX.
+package.preload['romloader'] = function() return {} end
+
+local tLog = {
+  debug = function() end,
+  info = function() end,
+  warning = function(strFormat, ...) print('WARNING: ' .. string.format(strFormat, ...)) end,
+  error = function(strFormat, ...) print('ERROR: ' .. string.format(strFormat, ...)) end
+}
+local UartNetx = require 'uart_netx'
+local tUart = UartNetx(tLog)
+
+local uiErrors = 0
+
+local function toHex(strData)
+  local astrHex = {}
+  for uiCnt=1,string.len(strData) do
+    table.insert(astrHex, string.format('%02x', string.byte(strData, uiCnt)))
+  end
+  return table.concat(astrHex, ' ')
+end
+
+local function check(strName, strMacro, astrExpected)
+  local strExpected = table.concat(astrExpected)
+  local strResult = tUart:parseMacro(strMacro)
+  if strResult==strExpected then
+    print(string.format('ok   %s', strName))
+  else
+    print(string.format('FAIL %s', strName))
+    print(string.format('  expected: %s', toHex(strExpected)))
+    print(string.format('  result:   %s', toHex(strResult)))
+    uiErrors = uiErrors + 1
+  end
+end
+
+local J = tUart.UART_SEQ_COMMAND_JumpIf
+local C = tUart.UART_SEQ_COMMAND_Clean
+
+-- The label directly follows the jump, so the offset is 0.
+check('forward jump', [[
+jumpif {0x06}, ok
+label ok
+clean
+]], {
+  string.char(J, 0, 0, 0x00, 0x00, 1, 0, 0x06),
+  string.char(C)
+})
+
+-- A backward jump to the start of the sequence.
+check('backward jump', [[
+label top
+clean
+jump top
+]], {
+  string.char(C),
+  string.char(J, 0, 0, 0xf8, 0xff, 0, 0)
+})
+
+-- The jump at offset 9 contains two other jumps. The jump at offset 17
+-- crosses the following commands and the jump at offset 25 goes back over
+-- all of them.
+check('nested jumps', [[
+jumpif {0x06}, ok
+clean
+label ok
+label top
+jumpifnot {0x15}, done, remove
+jump inner
+clean
+label inner
+jump top
+label done
+]], {
+  string.char(J, 0, 0, 0x01, 0x00, 1, 0, 0x06),
+  string.char(C),
+  string.char(J, tUart.UART_SEQ_JUMP_FLAG_Not + tUart.UART_SEQ_JUMP_FLAG_Remove, 0, 0x0f, 0x00, 1, 0, 0x15),
+  string.char(J, 0, 0, 0x01, 0x00, 0, 0),
+  string.char(C),
+  string.char(J, 0, 0, 0xe9, 0xff, 0, 0)
+})
+
+if uiErrors~=0 then
+  print(string.format('%d tests failed.', uiErrors))
+  os.exit(1)
+end
+print('All tests passed.')